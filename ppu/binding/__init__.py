@@ -17,8 +17,8 @@
 import numpy as np
 
 from ppu.ppu_pb2 import (DataType, Visibility, PtType, ProtocolKind, FieldType,
-                         ValueProto, ShapeProto, RuntimeConfig, ExecutableProto,
-                         IrProto, IrType)
+                         ValueProto, ValueChunkProto, ShapeProto, RuntimeConfig,
+                         ExecutableProto, IrProto, IrType)
 
 from . import _lib
 from google.protobuf.json_format import MessageToJson
@@ -68,6 +68,33 @@ class Runtime(object):
         ret.ParseFromString(self._vm.GetVar(name))
         return ret
 
+    def set_var_chunk(self, name: str, chunk: ValueChunkProto) -> None:
+        """Set a row-block of a PPU value, the value becomes visible once all
+        of its rows are set.
+
+        Args:
+            name (str): Id of value.
+            chunk (ValueChunkProto): rows data.
+
+        """
+        return self._vm.SetVarChunk(name, chunk.SerializeToString())
+
+    def get_var_chunk(self, name: str, row_begin: int,
+                      row_end: int) -> ValueChunkProto:
+        """Get rows [row_begin, row_end) of a PPU value.
+
+        Args:
+            name (str): Id of value.
+            row_begin (int): first row.
+            row_end (int): one past the last row.
+
+        Returns:
+            ValueChunkProto: rows data.
+        """
+        ret = ValueChunkProto()
+        ret.ParseFromString(self._vm.GetVarChunk(name, row_begin, row_end))
+        return ret
+
 
 class Io(object):
     """ The PPU IO interface.
@@ -111,6 +138,47 @@ class Io(object):
         str_shares = [x.SerializeToString() for x in xs]
         return self._io.Reconstruct(str_shares)
 
+    def make_share_chunks(self,
+                          x: np.ndarray,
+                          vtype: Visibility,
+                          rows_per_chunk: int = 4096):
+        """Stream a (possibly memory mapped) numpy array as row-blocks of
+        PPU value(s), only one block is resident at a time.
+
+        Args:
+            x (np.ndarray): input.
+            vtype (Visibility): visibility.
+            rows_per_chunk (int): rows of each block.
+
+        Yields:
+            [ValueChunkProto]: one chunk per party for each block.
+        """
+        shape = list(x.shape)
+        num_rows = shape[0] if shape else 1
+        for row_begin in range(0, num_rows, rows_per_chunk):
+            block = x[row_begin:row_begin + rows_per_chunk] if shape else x
+            str_chunks = self._io.MakeShareChunks(np.ascontiguousarray(block),
+                                                  vtype, shape, row_begin)
+            rets = []
+            for str_chunk in str_chunks:
+                chunk = ValueChunkProto()
+                chunk.ParseFromString(str_chunk)
+                rets.append(chunk)
+            yield rets
+
+    def reconstruct_chunks(self, xs: [ValueChunkProto]) -> np.ndarray:
+        """Convert from list of PPU value chunk(s) of the same rows to numpy
+        array.
+
+        Args:
+            xs ([ValueChunkProto]): input.
+
+        Returns:
+            np.ndarray: output rows.
+        """
+        str_chunks = [x.SerializeToString() for x in xs]
+        return self._io.ReconstructChunks(str_chunks)
+
 
 def compile(src: IrProto) -> IrProto:
     """ Compile from XLA HLO to PPU HLO.
@@ -73,6 +73,12 @@ void BindLink(py::module& m) {
                      &ContextDesc::brpc_channel_protocol)
       .def_readwrite("brpc_channel_connection_type",
                      &ContextDesc::brpc_channel_connection_type)
+      .def_readwrite("enable_compression", &ContextDesc::enable_compression)
+      .def_readwrite("compression_min_bytes",
+                     &ContextDesc::compression_min_bytes)
+      .def_readwrite("compression_max_ratio",
+                     &ContextDesc::compression_max_ratio)
+      .def_readwrite("shm_ring_bytes", &ContextDesc::shm_ring_bytes)
       .def(
           "add_party",
           [](ContextDesc& desc, std::string id, std::string host) {
@@ -188,6 +194,15 @@ void BindLink(py::module& m) {
           ctx->ConnectToMesh();
           return ctx;
         });
+
+  m.def("create_shm",
+        [](const ContextDesc& desc,
+           size_t self_rank) -> std::shared_ptr<Context> {
+          py::gil_scoped_release release;
+          auto ctx = link::FactoryShm().CreateContext(desc, self_rank);
+          ctx->ConnectToMesh();
+          return ctx;
+        });
 }
 
 // Wrap Processor, it's workaround for protobuf pybind11/protoc conflict.
@@ -216,6 +231,15 @@ class RuntimeWrapper {
   py::bytes GetVar(const std::string& name) const {
     return py::bytes(processor_->getVar(name));
   }
+
+  void SetVarChunk(const std::string& name, const py::bytes& chunk) {
+    return processor_->setVarChunk(name, chunk);
+  }
+
+  py::bytes GetVarChunk(const std::string& name, int64_t row_begin,
+                        int64_t row_end) const {
+    return py::bytes(processor_->getVarChunk(name, row_begin, row_end));
+  }
 };
 
 #define FOR_PY_FORMATS(FN) \
@@ -315,6 +339,32 @@ class IoWrapper {
     return serialized;
   }
 
+  std::vector<py::bytes> MakeShareChunks(const py::array& arr, int visibility,
+                                         const std::vector<int64_t>& shape,
+                                         int64_t row_begin) {
+    SizeCheck();
+
+    const py::buffer_info& binfo = arr.request();
+    const PtType pt_type = PyFormatToPtType(binfo.format);
+
+    ppu::PtBufferView view(
+        binfo.ptr, pt_type,
+        std::vector<int64_t>(binfo.shape.begin(), binfo.shape.end()),
+        ByteToElementStrides(binfo.strides.begin(), binfo.strides.end(),
+                             binfo.itemsize));
+
+    auto chunks = ptr_->makeShareChunks(ppu::Visibility(visibility), view,
+                                        shape, row_begin);
+    std::vector<py::bytes> serialized(chunks.size());
+    for (size_t idx = 0; idx < chunks.size(); ++idx) {
+      std::string s;
+      PPU_ENFORCE(chunks[idx].SerializeToString(&s));
+      serialized[idx] = py::bytes(s);
+    }
+
+    return serialized;
+  }
+
   py::array reconstruct(const std::vector<std::string>& vals) {
     std::vector<ppu::ValueProto> val_protos;
     PPU_ENFORCE(vals.size() > 0);
@@ -339,6 +389,28 @@ class IoWrapper {
 
     return py::array(py::dtype(PtTypeToPyFormat(pt_type)), shape, buf.data());
   }
+
+  py::array ReconstructChunks(const std::vector<std::string>& chunks) {
+    std::vector<ppu::ValueChunkProto> chunk_protos;
+    PPU_ENFORCE(chunks.size() > 0);
+    for (const auto& chunk : chunks) {
+      ppu::ValueChunkProto cp;
+      PPU_ENFORCE(cp.ParseFromString(chunk));
+      chunk_protos.push_back(std::move(cp));
+    }
+
+    const auto& front = chunk_protos.front();
+    auto type = Type::fromString(front.type_data());
+    const PtType pt_type = ppu::GetDecodeType(type.as<ValueTy>()->dtype());
+    auto buf = ptr_->combineShareChunks(chunk_protos, pt_type);
+    std::vector<size_t> shape = {front.shape().dims().begin(),
+                                 front.shape().dims().end()};
+    if (!shape.empty()) {
+      shape[0] = front.row_end() - front.row_begin();
+    }
+
+    return py::array(py::dtype(PtTypeToPyFormat(pt_type)), shape, buf.data());
+  }
 };
 
 void BindLibs(py::module& m) {
@@ -444,13 +516,17 @@ PYBIND11_MODULE(_lib, m) {
       .def(py::init<std::shared_ptr<link::Context>, std::string>(), NO_GIL)
       .def("Run", &RuntimeWrapper::Run, NO_GIL)
       .def("SetVar", &RuntimeWrapper::SetVar, NO_GIL)
-      .def("GetVar", &RuntimeWrapper::GetVar, NO_GIL);
+      .def("GetVar", &RuntimeWrapper::GetVar, NO_GIL)
+      .def("SetVarChunk", &RuntimeWrapper::SetVarChunk, NO_GIL)
+      .def("GetVarChunk", &RuntimeWrapper::GetVarChunk, NO_GIL);
 
   // bind ppu io suite.
   py::class_<IoWrapper>(m, "IoWrapper", "PPU VM IO")
       .def(py::init<size_t, std::string>())
       .def("MakeShares", &IoWrapper::MakeShares)
-      .def("Reconstruct", &IoWrapper::reconstruct);
+      .def("Reconstruct", &IoWrapper::reconstruct)
+      .def("MakeShareChunks", &IoWrapper::MakeShareChunks)
+      .def("ReconstructChunks", &IoWrapper::ReconstructChunks);
 
   // bind compiler.
   // TODO: use type compile :: IrProto -> IrProto
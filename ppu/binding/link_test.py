@@ -50,6 +50,30 @@ class UnitTests(unittest.TestCase):
         [job.start() for job in jobs]
         [job.join() for job in jobs]
 
+    def test_link_shm(self):
+        desc = link.Desc()
+        desc.id = "link_test_shm"
+        desc.add_party("alice", "process_0")
+        desc.add_party("bob", "process_1")
+
+        global shm_proc
+
+        def shm_proc(rank):
+            data = "hello" if rank == 0 else "world"
+
+            lctx = link.create_shm(desc, rank)
+            res = lctx.all_gather(data)
+
+            self.assertEqual(res, ['hello', 'world'])
+
+        # launch with multiprocessing
+        jobs = [
+            multiprocessing.Process(target=shm_proc, args=(0, )),
+            multiprocessing.Process(target=shm_proc, args=(1, ))
+        ]
+        [job.start() for job in jobs]
+        [job.join() for job in jobs]
+
     def test_link_mem(self):
         desc = link.Desc()
         desc.add_party("alice", "thread_0")
@@ -150,6 +150,29 @@ class UnitTests(parameterized.TestCase):
 
         npt.assert_almost_equal(x, y, decimal=5)
 
+    def test_io_chunks(self, wsize, prot, field):
+        if prot == pyppu.ProtocolKind.ABY3 and wsize != 3:
+            return
+
+        config = pyppu.RuntimeConfig(protocol=prot,
+                                     field=field,
+                                     fxp_fraction_bits=18)
+        io = pyppu.Io(wsize, config)
+
+        # SFXP
+        x = np.random.rand(7, 4, 5)
+
+        rows = []
+        for xs in io.make_share_chunks(x,
+                                       pyppu.Visibility.VIS_SECRET,
+                                       rows_per_chunk=3):
+            self.assertEqual(len(xs), wsize)
+            self.assertEqual(xs[0].shape, pyppu.ShapeProto(dims=(7, 4, 5)))
+            rows.append(io.reconstruct_chunks(xs))
+
+        self.assertEqual([r.shape[0] for r in rows], [3, 3, 1])
+        npt.assert_almost_equal(x, np.concatenate(rows), decimal=5)
+
 
 if __name__ == '__main__':
     unittest.main()
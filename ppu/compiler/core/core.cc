@@ -56,6 +56,13 @@ void Core::buildPipeline(mlir::PassManager *pm) {
     optPM.addPass(mlir::createCanonicalizerPass());
     optPM.addPass(mlir::createCSEPass());
   }
+  {
+    // MPC aware optimizations, run after CSE so that shared operands are
+    // already the same value.
+    auto &optPM = pm->nest<mlir::FuncOp>();
+    optPM.addPass(mlir::pphlo::createFactorCommonOperandPass());
+    optPM.addPass(mlir::pphlo::createVectorizeSecretMulPass());
+  }
 }
 
 } // namespace ppu::compiler
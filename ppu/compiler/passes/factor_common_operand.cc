@@ -0,0 +1,142 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#include "ppu/compiler/passes/pass_details.h"
+#include "ppu/dialect/pphlo_ops.h"
+
+namespace mlir::pphlo {
+
+namespace {
+
+// Type of an elementwise op on x and y, secret if either one is, fxp if
+// either one is.
+Type joinType(const TypeTools &tools, Value x, Value y) {
+  Type ret = x.getType();
+  if (tools.isFxpType(y.getType())) {
+    ret = tools.toFxpType(ret);
+  }
+  if (tools.isSecretType(y.getType())) {
+    ret = tools.toSecretType(ret);
+  }
+  return ret;
+}
+
+bool sameShape(Value x, Value y) {
+  return x.getType().dyn_cast<RankedTensorType>().getShape() ==
+         y.getType().dyn_cast<RankedTensorType>().getShape();
+}
+
+// a*b + a*c -> a*(b+c), dot(a,b) + dot(a,c) -> dot(a,b+c) and
+// dot(a,c) + dot(b,c) -> dot(a+b,c), likewise for subtract.
+//
+// The sum is accumulated before the multiplication, so one multiplication
+// and one truncation go away, each a communication round on secrets. When a
+// is secret and b, c are public, the remaining product is not even
+// interactive.
+template <typename OpT>
+struct FactorConverter : public OpRewritePattern<OpT> {
+  explicit FactorConverter(MLIRContext *context)
+      : OpRewritePattern<OpT>(context) {}
+
+  LogicalResult matchAndRewrite(OpT op,
+                                PatternRewriter &rewriter) const override {
+    auto lhs = op.getOperand(0);
+    auto rhs = op.getOperand(1);
+    // products used elsewhere are computed anyway.
+    if (!lhs.hasOneUse() || !rhs.hasOneUse()) {
+      return failure();
+    }
+
+    if (auto lmul = lhs.template getDefiningOp<MulOp>()) {
+      if (auto rmul = rhs.template getDefiningOp<MulOp>()) {
+        return factorMul(op, lmul, rmul, rewriter);
+      }
+    }
+    if (auto ldot = lhs.template getDefiningOp<DotOp>()) {
+      if (auto rdot = rhs.template getDefiningOp<DotOp>()) {
+        return factorDot(op, ldot, rdot, rewriter);
+      }
+    }
+    return failure();
+  }
+
+private:
+  LogicalResult factorMul(OpT op, MulOp lmul, MulOp rmul,
+                          PatternRewriter &rewriter) const {
+    // multiply is commutative, the shared operand could be on either side.
+    for (size_t i = 0; i < 2; ++i) {
+      for (size_t j = 0; j < 2; ++j) {
+        auto shared = lmul.getOperand(i);
+        if (shared != rmul.getOperand(j)) {
+          continue;
+        }
+        auto b = lmul.getOperand(1 - i);
+        auto c = rmul.getOperand(1 - j);
+        auto sum =
+            rewriter.create<OpT>(op.getLoc(), joinType(tools_, b, c), b, c);
+        rewriter.replaceOpWithNewOp<MulOp>(op, op.getType(), shared, sum);
+        return success();
+      }
+    }
+    return failure();
+  }
+
+  LogicalResult factorDot(OpT op, DotOp ldot, DotOp rdot,
+                          PatternRewriter &rewriter) const {
+    if (ldot.lhs() == rdot.lhs() && sameShape(ldot.rhs(), rdot.rhs())) {
+      auto sum = rewriter.create<OpT>(
+          op.getLoc(), joinType(tools_, ldot.rhs(), rdot.rhs()), ldot.rhs(),
+          rdot.rhs());
+      rewriter.replaceOpWithNewOp<DotOp>(op, op.getType(), ldot.lhs(), sum);
+      return success();
+    }
+    if (ldot.rhs() == rdot.rhs() && sameShape(ldot.lhs(), rdot.lhs())) {
+      auto sum = rewriter.create<OpT>(
+          op.getLoc(), joinType(tools_, ldot.lhs(), rdot.lhs()), ldot.lhs(),
+          rdot.lhs());
+      rewriter.replaceOpWithNewOp<DotOp>(op, op.getType(), sum, ldot.rhs());
+      return success();
+    }
+    return failure();
+  }
+
+  TypeTools tools_;
+};
+
+struct FactorCommonOperand
+    : public FactorCommonOperandBase<FactorCommonOperand> {
+  void runOnFunction() override {
+    OwningRewritePatternList patterns(&getContext());
+    populateOwningPatterns(&patterns, &getContext());
+    (void)applyPatternsAndFoldGreedily(getFunction(), std::move(patterns));
+  }
+
+private:
+  void populateOwningPatterns(OwningRewritePatternList *patterns,
+                              MLIRContext *ctx) const {
+    patterns->insert<FactorConverter<AddOp>, FactorConverter<SubOp>>(ctx);
+  }
+};
+} // namespace
+
+std::unique_ptr<FunctionPass> createFactorCommonOperandPass() {
+  return std::make_unique<FactorCommonOperand>();
+}
+
+} // namespace mlir::pphlo
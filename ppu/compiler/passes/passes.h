@@ -49,6 +49,12 @@ std::unique_ptr<FunctionPass> createDecomposeSqrtPass();
 // Categorize a normal reduce into categorized reduce ops
 std::unique_ptr<FunctionPass> createCategorizeReducePass();
 
+// Factor a shared operand out of sums of products
+std::unique_ptr<FunctionPass> createFactorCommonOperandPass();
+
+// Vectorize independent secret multiplications
+std::unique_ptr<FunctionPass> createVectorizeSecretMulPass();
+
 // Lower UnrealizedConversionCastOp
 std::unique_ptr<FunctionPass> createLowerConversionCastPass();
 
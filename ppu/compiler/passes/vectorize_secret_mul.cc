@@ -0,0 +1,167 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <tuple>
+
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/Pass.h"
+
+#include "ppu/compiler/passes/pass_details.h"
+#include "ppu/dialect/pphlo_ops.h"
+
+namespace mlir::pphlo {
+
+namespace {
+
+Type elementType(Value v) {
+  return v.getType().dyn_cast<RankedTensorType>().getElementType();
+}
+
+// Whether v is defined before op, so op could use it. Block arguments and
+// values of enclosing regions dominate the whole block.
+bool isAvailableAt(Value v, Operation *op) {
+  if (auto *def = v.getDefiningOp()) {
+    if (def->getBlock() == op->getBlock()) {
+      return def->isBeforeInBlock(op);
+    }
+  }
+  return true;
+}
+
+// Multiplications of two secrets in one block that do not depend on each
+// other, all their operands are available at the first one.
+struct MulGroup {
+  std::tuple<Type, Type, Type> key;
+  llvm::SmallVector<MulOp> muls;
+};
+
+// Flattens and concatenates values of the same element type.
+Value concatFlat(OpBuilder &builder, Location loc, ArrayRef<Value> values) {
+  llvm::SmallVector<Value> flat;
+  int64_t total = 0;
+  for (auto v : values) {
+    const auto numel =
+        v.getType().dyn_cast<RankedTensorType>().getNumElements();
+    flat.push_back(builder.create<ReshapeOp>(
+        loc, RankedTensorType::get({numel}, elementType(v)), v));
+    total += numel;
+  }
+  return builder.create<ConcatenateOp>(
+      loc, RankedTensorType::get({total}, elementType(values.front())), flat,
+      builder.getI64IntegerAttr(0));
+}
+
+// mul(a0,b0), mul(a1,b1)... -> mul(concat(a0,a1...), concat(b0,b1...)) and
+// slice the results back.
+//
+// Every secret multiplication costs at least one communication round (plus one
+// for the truncation of fixed points), independent ones at the same depth are
+// merged into a single vectorized multiplication so they share rounds.
+struct VectorizeSecretMul
+    : public VectorizeSecretMulBase<VectorizeSecretMul> {
+  void runOnFunction() override {
+    llvm::SmallVector<Block *> blocks;
+    getFunction()->walk([&](Operation *op) {
+      for (auto &region : op->getRegions()) {
+        for (auto &block : region) {
+          blocks.push_back(&block);
+        }
+      }
+    });
+    for (auto *block : blocks) {
+      vectorizeBlock(block);
+    }
+  }
+
+private:
+  void vectorizeBlock(Block *block) {
+    std::vector<MulGroup> groups;
+    for (auto &op : *block) {
+      auto mul = llvm::dyn_cast<MulOp>(op);
+      if (!mul || !tools_.isSecretType(mul.lhs().getType()) ||
+          !tools_.isSecretType(mul.rhs().getType())) {
+        continue;
+      }
+      auto key = std::make_tuple(elementType(mul.lhs()),
+                                 elementType(mul.rhs()),
+                                 elementType(mul.getResult()));
+      auto group = llvm::find_if(groups, [&](const MulGroup &g) {
+        auto *head = g.muls.front().getOperation();
+        return g.key == key && isAvailableAt(mul.lhs(), head) &&
+               isAvailableAt(mul.rhs(), head);
+      });
+      if (group == groups.end()) {
+        groups.push_back({key, {mul}});
+      } else {
+        group->muls.push_back(mul);
+      }
+    }
+
+    for (auto &group : groups) {
+      if (group.muls.size() > 1) {
+        fuse(group);
+      }
+    }
+  }
+
+  void fuse(const MulGroup &group) {
+    auto head = group.muls.front();
+    auto loc = head.getLoc();
+    OpBuilder builder(head);
+
+    llvm::SmallVector<Value> lhs;
+    llvm::SmallVector<Value> rhs;
+    for (auto mul : group.muls) {
+      lhs.push_back(mul.lhs());
+      rhs.push_back(mul.rhs());
+    }
+    auto flat_lhs = concatFlat(builder, loc, lhs);
+    auto flat_rhs = concatFlat(builder, loc, rhs);
+    auto flat_type = flat_lhs.getType().dyn_cast<RankedTensorType>();
+    auto product = builder.create<MulOp>(
+        loc,
+        RankedTensorType::get(flat_type.getShape(),
+                              elementType(head.getResult())),
+        flat_lhs, flat_rhs);
+
+    int64_t offset = 0;
+    for (auto mul : group.muls) {
+      auto type = mul.getType().dyn_cast<RankedTensorType>();
+      const auto numel = type.getNumElements();
+      auto slice = builder.create<SliceOp>(
+          loc, RankedTensorType::get({numel}, type.getElementType()), product,
+          builder.getI64TensorAttr({offset}),
+          builder.getI64TensorAttr({offset + numel}),
+          builder.getI64TensorAttr({1}));
+      mul.replaceAllUsesWith(
+          builder.create<ReshapeOp>(loc, type, slice).getResult());
+      offset += numel;
+    }
+
+    for (auto mul : group.muls) {
+      mul.erase();
+    }
+  }
+
+  TypeTools tools_;
+};
+} // namespace
+
+std::unique_ptr<FunctionPass> createVectorizeSecretMulPass() {
+  return std::make_unique<VectorizeSecretMul>();
+}
+
+} // namespace mlir::pphlo
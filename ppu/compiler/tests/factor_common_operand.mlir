@@ -0,0 +1,29 @@
+// RUN: mlir-pphlo-opt --factor-common-operand --split-input-file %s | FileCheck %s
+
+func @mul_add(%arg0: tensor<2x2x!pphlo.sfxp>, %arg1: tensor<2x2x!pphlo.pfxp>, %arg2: tensor<2x2x!pphlo.pfxp>) -> (tensor<2x2x!pphlo.sfxp>) {
+    //CHECK: %0 = "pphlo.add"(%arg1, %arg2) : (tensor<2x2x!pphlo.pfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.pfxp>
+    //CHECK: %1 = "pphlo.multiply"(%arg0, %0) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %1 = "pphlo.multiply"(%arg2, %arg0) : (tensor<2x2x!pphlo.pfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %2 = "pphlo.add"(%0, %1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    return %2 : tensor<2x2x!pphlo.sfxp>
+}
+
+func @dot_sub(%arg0: tensor<2x3x!pphlo.sfxp>, %arg1: tensor<2x3x!pphlo.sfxp>, %arg2: tensor<3x2x!pphlo.sfxp>) -> (tensor<2x2x!pphlo.sfxp>) {
+    //CHECK: %0 = "pphlo.subtract"(%arg0, %arg1) : (tensor<2x3x!pphlo.sfxp>, tensor<2x3x!pphlo.sfxp>) -> tensor<2x3x!pphlo.sfxp>
+    //CHECK: %1 = "pphlo.dot"(%0, %arg2) : (tensor<2x3x!pphlo.sfxp>, tensor<3x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %0 = "pphlo.dot"(%arg0, %arg2) : (tensor<2x3x!pphlo.sfxp>, tensor<3x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %1 = "pphlo.dot"(%arg1, %arg2) : (tensor<2x3x!pphlo.sfxp>, tensor<3x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %2 = "pphlo.subtract"(%0, %1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    return %2 : tensor<2x2x!pphlo.sfxp>
+}
+
+func @product_reused(%arg0: tensor<2x2x!pphlo.sfxp>, %arg1: tensor<2x2x!pphlo.sfxp>, %arg2: tensor<2x2x!pphlo.sfxp>) -> (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) {
+    //CHECK: %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    //CHECK: %1 = "pphlo.multiply"(%arg0, %arg2) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    //CHECK: %2 = "pphlo.add"(%0, %1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %1 = "pphlo.multiply"(%arg0, %arg2) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %2 = "pphlo.add"(%0, %1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    return %2, %0 : tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>
+}
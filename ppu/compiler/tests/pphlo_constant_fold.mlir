@@ -0,0 +1,31 @@
+// RUN: mlir-pphlo-opt --canonicalize --split-input-file %s | FileCheck %s
+
+func @fold_fxp() -> (tensor<2x!pphlo.pfxp>) {
+    //CHECK: %0 = "pphlo.constant"() {value = dense<[-2.500000e+00, -1.000000e+00]> : tensor<2xf32>} : () -> tensor<2x!pphlo.pfxp>
+    //CHECK-NEXT: return %0
+    %0 = "pphlo.constant"() {value = dense<[1.0, 2.0]> : tensor<2xf32>} : () -> tensor<2x!pphlo.pfxp>
+    %1 = "pphlo.constant"() {value = dense<[3.0, -1.0]> : tensor<2xf32>} : () -> tensor<2x!pphlo.pfxp>
+    %2 = "pphlo.add"(%0, %1) : (tensor<2x!pphlo.pfxp>, tensor<2x!pphlo.pfxp>) -> tensor<2x!pphlo.pfxp>
+    %3 = "pphlo.constant"() {value = dense<2.5> : tensor<2xf32>} : () -> tensor<2x!pphlo.pfxp>
+    %4 = "pphlo.minimum"(%2, %3) : (tensor<2x!pphlo.pfxp>, tensor<2x!pphlo.pfxp>) -> tensor<2x!pphlo.pfxp>
+    %5 = "pphlo.negate"(%4) : (tensor<2x!pphlo.pfxp>) -> tensor<2x!pphlo.pfxp>
+    return %5 : tensor<2x!pphlo.pfxp>
+}
+
+func @fold_int() -> (tensor<2x!pphlo.pint>) {
+    //CHECK: %0 = "pphlo.constant"() {value = dense<[0, 8]> : tensor<2xi32>} : () -> tensor<2x!pphlo.pint>
+    //CHECK-NEXT: return %0
+    %0 = "pphlo.constant"() {value = dense<[1, 4]> : tensor<2xi32>} : () -> tensor<2x!pphlo.pint>
+    %1 = "pphlo.constant"() {value = dense<[-3, 2]> : tensor<2xi32>} : () -> tensor<2x!pphlo.pint>
+    %2 = "pphlo.multiply"(%0, %1) : (tensor<2x!pphlo.pint>, tensor<2x!pphlo.pint>) -> tensor<2x!pphlo.pint>
+    %3 = "pphlo.subtract"(%2, %1) : (tensor<2x!pphlo.pint>, tensor<2x!pphlo.pint>) -> tensor<2x!pphlo.pint>
+    %4 = "pphlo.maximum"(%2, %3) : (tensor<2x!pphlo.pint>, tensor<2x!pphlo.pint>) -> tensor<2x!pphlo.pint>
+    return %4 : tensor<2x!pphlo.pint>
+}
+
+func @secret_operand(%arg0: tensor<2x!pphlo.sfxp>) -> (tensor<2x!pphlo.sfxp>) {
+    //CHECK: %1 = "pphlo.add"(%arg0, %0) : (tensor<2x!pphlo.sfxp>, tensor<2x!pphlo.pfxp>) -> tensor<2x!pphlo.sfxp>
+    %0 = "pphlo.constant"() {value = dense<[1.0, 2.0]> : tensor<2xf32>} : () -> tensor<2x!pphlo.pfxp>
+    %1 = "pphlo.add"(%arg0, %0) : (tensor<2x!pphlo.sfxp>, tensor<2x!pphlo.pfxp>) -> tensor<2x!pphlo.sfxp>
+    return %1 : tensor<2x!pphlo.sfxp>
+}
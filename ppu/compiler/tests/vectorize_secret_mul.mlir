@@ -0,0 +1,24 @@
+// RUN: mlir-pphlo-opt --vectorize-secret-mul --split-input-file %s | FileCheck %s
+
+func @siblings(%arg0: tensor<2x2x!pphlo.sfxp>, %arg1: tensor<2x2x!pphlo.sfxp>, %arg2: tensor<2x2x!pphlo.sfxp>) -> (tensor<2x2x!pphlo.sfxp>) {
+    //CHECK: %2 = "pphlo.concatenate"(%0, %1) {dimension = 0 : i64} : (tensor<4x!pphlo.sfxp>, tensor<4x!pphlo.sfxp>) -> tensor<8x!pphlo.sfxp>
+    //CHECK: %5 = "pphlo.concatenate"(%3, %4) {dimension = 0 : i64} : (tensor<4x!pphlo.sfxp>, tensor<4x!pphlo.sfxp>) -> tensor<8x!pphlo.sfxp>
+    //CHECK: %6 = "pphlo.multiply"(%2, %5) : (tensor<8x!pphlo.sfxp>, tensor<8x!pphlo.sfxp>) -> tensor<8x!pphlo.sfxp>
+    //CHECK: %7 = "pphlo.slice"(%6) {limit_indices = dense<4> : tensor<1xi64>, start_indices = dense<0> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8x!pphlo.sfxp>) -> tensor<4x!pphlo.sfxp>
+    //CHECK: %8 = "pphlo.reshape"(%7) : (tensor<4x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    //CHECK: %9 = "pphlo.slice"(%6) {limit_indices = dense<8> : tensor<1xi64>, start_indices = dense<4> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8x!pphlo.sfxp>) -> tensor<4x!pphlo.sfxp>
+    //CHECK: %10 = "pphlo.reshape"(%9) : (tensor<4x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    //CHECK: %11 = "pphlo.multiply"(%8, %10) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %1 = "pphlo.multiply"(%arg1, %arg2) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %2 = "pphlo.multiply"(%0, %1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) -> tensor<2x2x!pphlo.sfxp>
+    return %2 : tensor<2x2x!pphlo.sfxp>
+}
+
+func @public_operand(%arg0: tensor<2x2x!pphlo.sfxp>, %arg1: tensor<2x2x!pphlo.pfxp>) -> (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>) {
+    //CHECK: %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    //CHECK: %1 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    %1 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.pfxp>) -> tensor<2x2x!pphlo.sfxp>
+    return %0, %1 : tensor<2x2x!pphlo.sfxp>, tensor<2x2x!pphlo.sfxp>
+}
@@ -212,9 +212,18 @@ class NdArrayRef {
         shape_(std::move(shape)),
         strides_(std::move(strides)),
         offset_(offset) {
-    PPU_ENFORCE(ppu::numel(absl::MakeSpan(shape_)) *
-                    static_cast<int64_t>(eltype_.size()) <=
-                buf_->size());
+    PPU_ENFORCE(shape_.size() == strides_.size());
+
+    // strides may be zero (broadcast) or permuted (transpose), so check the
+    // farthest element touched instead of the element count.
+    if (ppu::numel(absl::MakeSpan(shape_)) > 0) {
+      int64_t last = 0;
+      for (size_t idx = 0; idx < shape_.size(); ++idx) {
+        last += (shape_[idx] - 1) * strides_[idx];
+      }
+      PPU_ENFORCE(offset_ + (last + 1) * static_cast<int64_t>(eltype_.size()) <=
+                  buf_->size());
+    }
 
     // PPU_ENFORCE(
     //     isCompact(),
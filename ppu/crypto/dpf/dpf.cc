@@ -15,13 +15,12 @@
 
 #include "dpf.h"
 
-#include <chrono>
-#include <future>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
-#include "spdlog/spdlog.h"
-
-#include "ppu/crypto/pseudo_random_generator.h"
+#include "ppu/crypto/ot/aes.h"
+#include "ppu/utils/parallel.h"
 
 #include "ppu/crypto/dpf/serializable.pb.h"
 
@@ -35,29 +34,74 @@ uint8_t GetBit(DpfInStore x, uint32_t i) {
   return x >> i & 1;
 }
 
-DpfOutStore DpfPRG(uint128_t seed) {
-  PseudoRandomGenerator<uint128_t, sizeof(uint128_t)> prng(seed);
-  return prng();
-}
+// The tree is expanded with the fixed-key aes hash H(x) = AES(x) ^ x, the
+// tweaks separate the left child, the right child and the output conversion.
+const block kRightTweak = toBlock(1, 0);
+const block kConvertTweak = toBlock(2, 0);
 
-std::tuple<uint128_t, bool, uint128_t, bool> SplitDpfSeed(uint128_t seed) {
-  uint128_t seed_left = 0;
-  uint128_t seed_right = 0;
-  bool t_left;
-  bool t_right;
+// The lowest bit of an expanded child is its control bit, the rest is the
+// child seed.
+constexpr uint128_t kSeedMask = ~static_cast<uint128_t>(1);
+
+// Number of seeds hashed per aes call, eight blocks fill the aes-ni pipeline.
+constexpr size_t kAesBatch = 8;
+
+// Number of tree nodes per task when a level is split across threads.
+constexpr int64_t kNodeGrainSize = 1024;
 
-  // TODO: check if this implementation is secure and efficient
-  PseudoRandomGenerator<uint128_t, 3 * sizeof(uint128_t)> prng(seed);
+inline uint128_t ToUint128(const block& b) {
+  uint128_t ret;
+  std::memcpy(&ret, &b, sizeof(ret));
+  return ret;
+}
 
-  seed_left = prng();
-  seed_right = prng();
+// Expands n seeds, left[i] and right[i] hold the children of seeds[i] with
+// the control bit in the lowest bit. left may alias seeds.
+void SplitDpfSeeds(const uint128_t* seeds, size_t n, uint128_t* left,
+                   uint128_t* right) {
+  std::array<block, 2 * kAesBatch> in;
+  std::array<block, 2 * kAesBatch> out;
+  for (size_t i = 0; i < n; i += kAesBatch) {
+    const size_t m = std::min(kAesBatch, n - i);
+    for (size_t j = 0; j < m; j++) {
+      in[2 * j] = block(seeds[i + j]);
+      in[2 * j + 1] = in[2 * j] ^ kRightTweak;
+    }
+    kAesFixedKey.EcbEncBlocks(in.data(), 2 * m, out.data());
+    for (size_t j = 0; j < m; j++) {
+      left[i + j] = ToUint128(out[2 * j] ^ in[2 * j]);
+      right[i + j] = ToUint128(out[2 * j + 1] ^ in[2 * j + 1]);
+    }
+  }
+}
 
-  uint128_t tmp = prng();
+// out[i] = Convert(seeds[i]), out may alias seeds.
+void ConvertDpfSeeds(const uint128_t* seeds, size_t n, uint128_t* out) {
+  std::array<block, kAesBatch> in;
+  std::array<block, kAesBatch> enc;
+  for (size_t i = 0; i < n; i += kAesBatch) {
+    const size_t m = std::min(kAesBatch, n - i);
+    for (size_t j = 0; j < m; j++) {
+      in[j] = block(seeds[i + j]) ^ kConvertTweak;
+    }
+    kAesFixedKey.EcbEncBlocks(in.data(), m, enc.data());
+    for (size_t j = 0; j < m; j++) {
+      out[i + j] = ToUint128(enc[j] ^ in[j]);
+    }
+  }
+}
 
-  t_left = tmp >> 1 & 1;
-  t_right = tmp >> 2 & 1;
+DpfOutStore DpfPRG(uint128_t seed) {
+  uint128_t out;
+  ConvertDpfSeeds(&seed, 1, &out);
+  return out;
+}
 
-  return {seed_left, t_left, seed_right, t_right};
+std::tuple<uint128_t, bool, uint128_t, bool> SplitDpfSeed(uint128_t seed) {
+  uint128_t left;
+  uint128_t right;
+  SplitDpfSeeds(&seed, 1, &left, &right);
+  return {left & kSeedMask, left & 1, right & kSeedMask, right & 1};
 }
 
 }  // namespace
@@ -100,13 +144,15 @@ void DpfContext::Gen(DpfKey& first_key, DpfKey& second_key, DpfInStore alpha,
 
     bool alpha_bit = GetBit(alpha, i);
 
-    // Use working seed to generate seeds
-    // Note: this is the most time-consuming process
-    // [TODO]: Make this parallel
-    std::tie(seed_left[0], t_left[0], seed_right[0], t_right[0]) =
-        SplitDpfSeed(seeds_working[0]);
-    std::tie(seed_left[1], t_left[1], seed_right[1], t_right[1]) =
-        SplitDpfSeed(seeds_working[1]);
+    // Use working seed to generate seeds, both parties in one aes batch.
+    SplitDpfSeeds(seeds_working.data(), 2, seed_left.data(),
+                  seed_right.data());
+    for (size_t k = 0; k < 2; k++) {
+      t_left[k] = seed_left[k] & 1;
+      t_right[k] = seed_right[k] & 1;
+      seed_left[k] &= kSeedMask;
+      seed_right[k] &= kSeedMask;
+    }
 
     const auto keep_seed = alpha_bit ? seed_right : seed_left;
     const auto lose_seed = alpha_bit ? seed_left : seed_right;
@@ -226,66 +272,87 @@ DpfOutStore DpfContext::Eval(DpfKey& key, DpfInStore x) {
   return TruncateSs(result);
 }
 
-void DpfContext::Traverse(DpfKey& key, std::vector<DpfOutStore>& result,
-                          size_t current_level, uint64_t current_pos,
-                          uint128_t seed_working, bool t_working,
-                          size_t term_level) {
-  if (current_level < term_level) {
-    uint128_t seed_left, seed_right;
-    bool t_left, t_right;
-    const auto cw_seed = key.cws_vec[current_level].GetSeed();
-    const auto cw_t_left = key.cws_vec[current_level].GetTLeft();
-    const auto cw_t_right = key.cws_vec[current_level].GetTRight();
-
-    std::tie(seed_left, t_left, seed_right, t_right) =
-        SplitDpfSeed(seed_working);
-
-    seed_left = t_working ? seed_left ^ cw_seed : seed_left;
-    t_left = t_left ^ (t_working * cw_t_left);
-    seed_right = t_working ? seed_right ^ cw_seed : seed_right;
-    t_right = t_right ^ (t_working * cw_t_right);
-
-    uint64_t next_left_pos = current_pos;
-    uint64_t next_right_pos = (1 << current_level) + current_pos;
-
-    Traverse(key, result, current_level + 1, next_left_pos, seed_left, t_left,
-             term_level);
-    Traverse(key, result, current_level + 1, next_right_pos, seed_right,
-             t_right, term_level);
+void DpfContext::EvalAllImpl(const DpfKey& key, DpfOutStore* result) const {
+  PPU_ENFORCE(key.enable_evalall == true);
 
-  } else {
-    DpfOutStore prg = DpfPRG(seed_working);
-    uint32_t expand_num = static_cast<uint32_t>(1)
-                          << (GetInBitNum() - term_level);
+  const size_t term_level = GetTerminateLevel(true);
+  PPU_ENFORCE(key.cws_vec.size() >= term_level);
+
+  // Expand the tree level by level. The node j of level l sits at position j,
+  // its children go to j and j + 2^l, so one buffer holds every level and the
+  // leaves end up in domain order.
+  const int64_t num_leaves = static_cast<int64_t>(1) << term_level;
+  std::vector<uint128_t> seeds(num_leaves);
+  std::vector<uint8_t> ts(num_leaves);
+  seeds[0] = key.GetSeed();
+  ts[0] = key.GetRank();
+
+  for (size_t level = 0; level < term_level; level++) {
+    const int64_t width = static_cast<int64_t>(1) << level;
+    const auto cw_seed = key.cws_vec[level].GetSeed();
+    const bool cw_t_left = key.cws_vec[level].GetTLeft();
+    const bool cw_t_right = key.cws_vec[level].GetTRight();
+
+    parallel_for(0, width, kNodeGrainSize, [&](int64_t begin, int64_t end) {
+      SplitDpfSeeds(&seeds[begin], end - begin, &seeds[begin],
+                    &seeds[width + begin]);
+      for (int64_t j = begin; j < end; j++) {
+        const bool t = ts[j];
+        auto& left = seeds[j];
+        auto& right = seeds[width + j];
+        ts[j] = (left & 1) ^ (t & cw_t_left);
+        ts[width + j] = (right & 1) ^ (t & cw_t_right);
+        left = t ? (left & kSeedMask) ^ cw_seed : left & kSeedMask;
+        right = t ? (right & kSeedMask) ^ cw_seed : right & kSeedMask;
+      }
+    });
+  }
 
-    for (uint32_t i = 0; i < expand_num; i++) {
-      result[current_pos + (i << term_level)] =
-          key.GetRank()
-              ? ReverseSs(TruncateSs(prg) + t_working * key.last_cw_vec[i])
-              : TruncateSs(TruncateSs(prg) + t_working * key.last_cw_vec[i]);
-      prg = DpfPRG(prg);
+  // Each leaf covers expand_num points, stepping by 2^term_level.
+  const size_t expand_num = static_cast<size_t>(1)
+                            << (GetInBitNum() - term_level);
+  PPU_ENFORCE(key.last_cw_vec.size() >= expand_num);
+  const auto expand_leaves = [&](int64_t begin, int64_t end) {
+    for (size_t i = 0; i < expand_num; i++) {
+      ConvertDpfSeeds(&seeds[begin], end - begin, &seeds[begin]);
+      for (int64_t j = begin; j < end; j++) {
+        const DpfOutStore v = TruncateSs(seeds[j]) + ts[j] * key.last_cw_vec[i];
+        result[j + (i << term_level)] =
+            key.GetRank() ? ReverseSs(v) : TruncateSs(v);
+      }
     }
-  }
+  };
+  parallel_for(0, num_leaves, kNodeGrainSize, expand_leaves);
 }
 
 std::vector<DpfOutStore> DpfContext::EvalAll(DpfKey& key) {
-  PPU_ENFORCE(key.enable_evalall == true);
-
-  uint128_t seed_working = key.GetSeed();  // the initial value
-  bool t_working = key.GetRank();          // the initial value
-  uint32_t term_level = GetTerminateLevel(true);
-
   PPU_ENFORCE(GetInBitNum() <= 25);  // only support in_bin_num < 25
 
-  uint64_t num = 1 << GetInBitNum();
-  std::vector<DpfOutStore> result(num);
+  std::vector<DpfOutStore> result(static_cast<size_t>(1) << GetInBitNum());
+  EvalAllImpl(key, result.data());
+  return result;
+}
 
-  uint64_t current_pos = 0;
-  uint64_t current_level = 0;  // we start from the top level
+std::vector<DpfOutStore> DpfContext::BatchEvalAll(
+    absl::Span<const DpfKey> keys) {
+  PPU_ENFORCE(GetInBitNum() <= 25);  // only support in_bin_num < 25
 
-  Traverse(key, result, current_level, current_pos, seed_working, t_working,
-           term_level);
+  const size_t domain = static_cast<size_t>(1) << GetInBitNum();
+  std::vector<DpfOutStore> result(keys.size() * domain);
+  if (static_cast<int64_t>(keys.size()) < get_num_threads()) {
+    // too few keys to busy every thread, split the tree levels instead.
+    for (size_t idx = 0; idx < keys.size(); idx++) {
+      EvalAllImpl(keys[idx], &result[idx * domain]);
+    }
+    return result;
+  }
 
+  // one key per task, the levels of each tree are then expanded serially.
+  parallel_for(0, keys.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      EvalAllImpl(keys[idx], &result[idx * domain]);
+    }
+  });
   return result;
 }
 
@@ -342,8 +409,6 @@ void DpfKey::Deserialize(const std::string& s) {
   sec_param_ = proto.sec_param();
 
   mseed_ = MakeUint128(proto.mseed().hi(), proto.mseed().lo());
-
-  SPDLOG_INFO("Got seed {}", GetSeed());
 }
 
 }  // namespace ppu::crypto
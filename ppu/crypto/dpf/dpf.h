@@ -25,6 +25,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "absl/types/span.h"
+
 #include "ppu/utils/exception.h"
 #include "ppu/utils/int128.h"
 
@@ -151,6 +153,10 @@ class DpfContext {
 
   std::vector<DpfOutStore> EvalAll(DpfKey& key);
 
+  // Full domain evaluation of many keys at once, the points of keys[i] are
+  // stored at [i * 2^in_bitnum, (i + 1) * 2^in_bitnum) of the result.
+  std::vector<DpfOutStore> BatchEvalAll(absl::Span<const DpfKey> keys);
+
   DpfOutStore GetSsMask() const {
     PPU_ENFORCE(ss_bitnum_ <= 64);
     if (ss_bitnum_ == 64) {
@@ -170,9 +176,9 @@ class DpfContext {
   }
 
  private:
-  void Traverse(DpfKey& key, std::vector<DpfOutStore>& result,
-                size_t current_level, uint64_t current_pos,
-                uint128_t seed_working, bool t_working, size_t term_level);
+  // Expands the whole tree of key level by level and writes the 2^in_bitnum
+  // points to result.
+  void EvalAllImpl(const DpfKey& key, DpfOutStore* result) const;
 
   // Note that for the case of sec_param = 128 and ss_bitnum = 64, we
   // always have term_level = in_bitnum
@@ -142,6 +142,38 @@ TEST_P(FssDpfEvalAllTest, Works) {
   }
 }
 
+TEST(FssDpfBatchEvalAllTest, Works) {
+  const size_t kNumKeys = 17;
+  DpfContext context(10, 32);
+
+  std::vector<DpfKey> k0s(kNumKeys);
+  std::vector<DpfKey> k1s(kNumKeys);
+  std::vector<DpfInStore> alphas(kNumKeys);
+  for (size_t i = 0; i < kNumKeys; i++) {
+    alphas[i] = (i * 61) % (1 << context.GetInBitNum());
+    std::tie(k0s[i], k1s[i]) =
+        context.Gen(alphas[i], i + 1, 2 * i, 2 * i + 1, true);
+  }
+
+  const auto r0 = context.BatchEvalAll(k0s);
+  const auto r1 = context.BatchEvalAll(k1s);
+
+  const size_t range = 1 << context.GetInBitNum();
+  ASSERT_EQ(r0.size(), kNumKeys * range);
+  ASSERT_EQ(r1.size(), kNumKeys * range);
+  for (size_t i = 0; i < kNumKeys; i++) {
+    // batched evaluation agrees with the single key one.
+    EXPECT_EQ(context.EvalAll(k0s[i]),
+              std::vector<DpfOutStore>(r0.begin() + i * range,
+                                       r0.begin() + (i + 1) * range));
+    for (size_t j = 0; j < range; j++) {
+      DpfOutStore result =
+          context.TruncateSs(r0[i * range + j] + r1[i * range + j]);
+      EXPECT_EQ(result, j == alphas[i] ? i + 1 : 0);
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(Works_Instances, FssDpfGenTest,
                          testing::Values(TestParams{1, 1, 2, 1},   //
                                          TestParams{1, 2, 2, 4},   //
@@ -0,0 +1,385 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/device/batching_processor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+#include "ppu/link/link.h"
+#include "ppu/utils/exception.h"
+
+#include "ppu/device/batching_processor.pb.h"
+
+namespace ppu::device {
+namespace {
+
+// batched variables are kept in the processor environment under this prefix.
+constexpr char kVarPrefix[] = "__batch__.";
+
+constexpr char kBatchTag[] = "batch";
+
+int64_t rowBytes(const ValueProto &value) {
+  PPU_ENFORCE(value.shape().dims_size() > 0,
+              "batched value should have a batch dimension");
+  const int64_t rows = value.shape().dims(0);
+  return rows == 0 ? 0 : static_cast<int64_t>(value.content().size()) / rows;
+}
+
+// concatenate values along the first dimension, zero padded to `rows`.
+//
+// Values are compact and row major, so this is a concatenation of contents.
+// Zero bytes are a valid (public or secret) encoding of zero for all
+// protocols, padding rows never leak into the results of requests.
+ValueProto concatRows(const std::vector<const ValueProto *> &parts,
+                      int64_t rows) {
+  PPU_ENFORCE(!parts.empty());
+  const auto &front = *parts.front();
+  const int64_t row_bytes = rowBytes(front);
+
+  ValueProto batched;
+  batched.set_type_data(front.type_data());
+  *batched.mutable_shape() = front.shape();
+  batched.mutable_shape()->set_dims(0, rows);
+
+  auto *content = batched.mutable_content();
+  content->reserve(rows * row_bytes);
+  for (const auto *part : parts) {
+    PPU_ENFORCE(part->type_data() == front.type_data(),
+                "type mismatch, got={}, expected={}", part->type_data(),
+                front.type_data());
+    PPU_ENFORCE(std::equal(part->shape().dims().begin() + 1,
+                           part->shape().dims().end(),
+                           front.shape().dims().begin() + 1,
+                           front.shape().dims().end()),
+                "batched inputs should have the same row shape");
+    content->append(part->content());
+  }
+  PPU_ENFORCE(static_cast<int64_t>(content->size()) <= rows * row_bytes);
+  content->resize(rows * row_bytes, '\0');
+  return batched;
+}
+
+ValueProto sliceRows(const ValueProto &value, int64_t begin, int64_t end) {
+  const int64_t row_bytes = rowBytes(value);
+
+  ValueProto ret;
+  ret.set_type_data(value.type_data());
+  *ret.mutable_shape() = value.shape();
+  ret.mutable_shape()->set_dims(0, end - begin);
+  ret.set_content(value.content().data() + begin * row_bytes,
+                  (end - begin) * row_bytes);
+  return ret;
+}
+
+// nearest-rank percentile of sorted values.
+double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+BatchingProcessor::BatchingProcessor(Processor *processor,
+                                     ExecutableProto exec,
+                                     BatchingOptions options)
+    : processor_(processor), options_(std::move(options)),
+      is_leader_(processor != nullptr && processor->lctx()->Rank() == 0),
+      batch_exec_(std::move(exec)) {
+  PPU_ENFORCE(processor_ != nullptr);
+  PPU_ENFORCE(options_.batch_size > 0);
+
+  for (const auto &name : options_.batched_inputs) {
+    auto *names = batch_exec_.mutable_input_names();
+    auto itr = std::find(names->begin(), names->end(), name);
+    PPU_ENFORCE(itr != names->end(), "batched input={} not found", name);
+    *itr = kVarPrefix + name;
+  }
+  for (auto &name : *batch_exec_.mutable_output_names()) {
+    name = kVarPrefix + name;
+  }
+
+  if (is_leader_) {
+    worker_ = std::thread([this] { leaderLoop(); });
+  } else {
+    worker_ = std::thread([this] { followerLoop(); });
+  }
+}
+
+BatchingProcessor::~BatchingProcessor() { stop(); }
+
+std::future<std::vector<std::string>>
+BatchingProcessor::submit(const std::string &request_id,
+                          const std::vector<std::string> &inputs) {
+  PPU_ENFORCE(inputs.size() == options_.batched_inputs.size(),
+              "expect {} inputs, got {}", options_.batched_inputs.size(),
+              inputs.size());
+
+  Request req;
+  req.inputs.resize(inputs.size());
+  for (size_t idx = 0; idx < inputs.size(); idx++) {
+    PPU_ENFORCE(req.inputs[idx].ParseFromString(inputs[idx]));
+    const auto &shape = req.inputs[idx].shape();
+    PPU_ENFORCE(shape.dims_size() > 0,
+                "input={} of request={} has no batch dimension",
+                options_.batched_inputs[idx], request_id);
+    if (idx == 0) {
+      req.rows = shape.dims(0);
+    }
+    PPU_ENFORCE(shape.dims(0) == req.rows,
+                "inputs of request={} have different rows", request_id);
+  }
+  PPU_ENFORCE(req.rows > 0 && req.rows <= options_.batch_size,
+              "request={} has {} rows, batch_size={}", request_id, req.rows,
+              options_.batch_size);
+  req.submit_time = Clock::now();
+  auto future = req.result.get_future();
+
+  {
+    std::unique_lock lock(mutex_);
+    PPU_ENFORCE(!stopping_, "batching processor stopped");
+    PPU_ENFORCE(pending_.count(request_id) == 0, "request={} already exist",
+                request_id);
+    if (first_submit_ == Clock::time_point()) {
+      first_submit_ = req.submit_time;
+    }
+    if (is_leader_) {
+      queued_rows_ += req.rows;
+      order_.push_back(request_id);
+    }
+    pending_.emplace(request_id, std::move(req));
+  }
+  cond_.notify_all();
+  return future;
+}
+
+void BatchingProcessor::stop() {
+  {
+    std::unique_lock lock(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+BatchingStats BatchingProcessor::stats() const {
+  std::unique_lock lock(mutex_);
+
+  BatchingStats stats;
+  stats.num_requests = latencies_ms_.size();
+  stats.num_batches = num_batches_;
+  if (num_batches_ != 0) {
+    stats.avg_batch_rows = static_cast<double>(num_rows_) / num_batches_;
+  }
+
+  auto sorted = latencies_ms_;
+  std::sort(sorted.begin(), sorted.end());
+  stats.latency_p50_ms = percentile(sorted, 0.5);
+  stats.latency_p90_ms = percentile(sorted, 0.9);
+  stats.latency_p99_ms = percentile(sorted, 0.99);
+
+  const std::chrono::duration<double> elapsed = last_done_ - first_submit_;
+  if (!sorted.empty() && elapsed.count() > 0) {
+    stats.throughput = sorted.size() / elapsed.count();
+  }
+  return stats;
+}
+
+void BatchingProcessor::leaderLoop() {
+  const auto &lctx = processor_->lctx();
+  try {
+    while (true) {
+      RequestBatchProto batch;
+      {
+        std::unique_lock lock(mutex_);
+        const auto heartbeat = Clock::now() + options_.idle_heartbeat;
+        while (queued_rows_ < options_.batch_size) {
+          if (order_.empty()) {
+            if (stopping_) {
+              batch.set_stop(true);
+              break;
+            }
+            if (Clock::now() >= heartbeat) {
+              break;
+            }
+            cond_.wait_until(lock, heartbeat);
+            continue;
+          }
+
+          // the oldest request decides when the batch runs.
+          const auto deadline =
+              pending_.at(order_.front()).submit_time + options_.max_latency;
+          if (stopping_ || Clock::now() >= deadline) {
+            break;
+          }
+          cond_.wait_until(lock, deadline);
+        }
+
+        int64_t rows = 0;
+        while (!order_.empty()) {
+          const int64_t req_rows = pending_.at(order_.front()).rows;
+          if (rows + req_rows > options_.batch_size) {
+            break;
+          }
+          rows += req_rows;
+          batch.add_request_ids(order_.front());
+          order_.pop_front();
+        }
+        queued_rows_ -= rows;
+      }
+
+      const auto batch_str = batch.SerializeAsString();
+      link::Broadcast(lctx, Buffer(batch_str.data(), batch_str.size()), 0,
+                      kBatchTag);
+      if (batch.stop()) {
+        return;
+      }
+      if (batch.request_ids_size() > 0) {
+        runBatch({batch.request_ids().begin(), batch.request_ids().end()});
+      }
+    }
+  } catch (const std::exception &e) {
+    SPDLOG_ERROR("batching leader failed, {}", e.what());
+    failPending(std::current_exception());
+  }
+}
+
+void BatchingProcessor::followerLoop() {
+  const auto &lctx = processor_->lctx();
+  try {
+    while (true) {
+      auto buf = link::Broadcast(lctx, Buffer(), 0, kBatchTag);
+
+      RequestBatchProto batch;
+      PPU_ENFORCE(batch.ParseFromArray(buf.data(), buf.size()));
+      if (batch.stop()) {
+        return;
+      }
+      if (batch.request_ids_size() == 0) {
+        continue;
+      }
+
+      // the leader may see a request before we do.
+      {
+        std::unique_lock lock(mutex_);
+        const auto all_arrived = [&] {
+          return std::all_of(
+              batch.request_ids().begin(), batch.request_ids().end(),
+              [&](const std::string &id) { return pending_.count(id) != 0; });
+        };
+        const auto deadline = Clock::now() + options_.arrival_timeout;
+        if (!cond_.wait_until(lock, deadline,
+                              [&] { return stopping_ || all_arrived(); })) {
+          PPU_THROW("requests of the batch not submitted within {}ms",
+                    options_.arrival_timeout.count());
+        }
+        if (!all_arrived()) {
+          PPU_THROW("stopped before all requests of the batch arrived");
+        }
+      }
+      runBatch({batch.request_ids().begin(), batch.request_ids().end()});
+    }
+  } catch (const std::exception &e) {
+    SPDLOG_ERROR("batching follower failed, {}", e.what());
+    failPending(std::current_exception());
+  }
+}
+
+void BatchingProcessor::runBatch(const std::vector<std::string> &request_ids) {
+  std::vector<Request> reqs;
+  {
+    std::unique_lock lock(mutex_);
+    for (const auto &id : request_ids) {
+      auto itr = pending_.find(id);
+      PPU_ENFORCE(itr != pending_.end(), "request={} not found", id);
+      reqs.push_back(std::move(itr->second));
+      pending_.erase(itr);
+    }
+  }
+
+  int64_t rows = 0;
+  try {
+    for (size_t idx = 0; idx < options_.batched_inputs.size(); idx++) {
+      std::vector<const ValueProto *> parts;
+      for (const auto &req : reqs) {
+        parts.push_back(&req.inputs[idx]);
+      }
+      auto batched = concatRows(parts, options_.batch_size);
+      processor_->setVar(kVarPrefix + options_.batched_inputs[idx],
+                         batched.SerializeAsString());
+    }
+
+    processor_->run(batch_exec_);
+
+    std::vector<std::vector<std::string>> results(reqs.size());
+    for (const auto &name : batch_exec_.output_names()) {
+      ValueProto out;
+      PPU_ENFORCE(out.ParseFromString(processor_->getVar(name)));
+      PPU_ENFORCE(out.shape().dims_size() > 0 &&
+                      out.shape().dims(0) == options_.batch_size,
+                  "output={} should have the batch dimension", name);
+
+      int64_t row_begin = 0;
+      for (size_t idx = 0; idx < reqs.size(); idx++) {
+        const int64_t row_end = row_begin + reqs[idx].rows;
+        results[idx].push_back(
+            sliceRows(out, row_begin, row_end).SerializeAsString());
+        row_begin = row_end;
+      }
+    }
+
+    for (size_t idx = 0; idx < reqs.size(); idx++) {
+      rows += reqs[idx].rows;
+      reqs[idx].result.set_value(std::move(results[idx]));
+    }
+  } catch (...) {
+    for (auto &req : reqs) {
+      req.result.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  const auto now = Clock::now();
+  std::unique_lock lock(mutex_);
+  for (const auto &req : reqs) {
+    latencies_ms_.push_back(
+        std::chrono::duration<double, std::milli>(now - req.submit_time)
+            .count());
+  }
+  num_batches_ += 1;
+  num_rows_ += rows;
+  last_done_ = now;
+}
+
+void BatchingProcessor::failPending(const std::exception_ptr &error) {
+  std::unique_lock lock(mutex_);
+  for (auto &[id, req] : pending_) {
+    req.result.set_exception(error);
+  }
+  pending_.clear();
+  order_.clear();
+  queued_rows_ = 0;
+  stopping_ = true;
+}
+
+} // namespace ppu::device
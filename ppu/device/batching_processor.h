@@ -0,0 +1,147 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ppu/device/processor.h"
+
+#include "ppu/ppu.pb.h"
+
+namespace ppu::device {
+
+struct BatchingOptions {
+  /// Rows of the batch (first) dimension the executable is compiled for,
+  /// batches are zero padded to this size.
+  int64_t batch_size = 64;
+
+  /// Max time a request waits in the queue before its batch runs.
+  std::chrono::milliseconds max_latency{10};
+
+  /// Executable inputs provided by each request, concatenated along the batch
+  /// dimension. Other inputs (i.e. model weights) are read from the processor
+  /// environment as is. All outputs are split along the batch dimension.
+  std::vector<std::string> batched_inputs;
+
+  /// The leader announces an empty batch when idle for this long, so the link
+  /// receives of the followers do not time out.
+  std::chrono::milliseconds idle_heartbeat{1000};
+
+  /// Max time a follower waits for a request announced by the leader to be
+  /// submitted locally, the batch and all pending requests fail after that.
+  std::chrono::milliseconds arrival_timeout{30 * 1000};
+};
+
+struct BatchingStats {
+  size_t num_requests = 0;
+  size_t num_batches = 0;
+
+  /// Average rows per batch, padding excluded.
+  double avg_batch_rows = 0;
+
+  /// Per-request latency, from submit to result, in milliseconds.
+  double latency_p50_ms = 0;
+  double latency_p90_ms = 0;
+  double latency_p99_ms = 0;
+
+  /// Completed requests per second, since the first submit.
+  double throughput = 0;
+};
+
+/// A batching front end of a Processor, for online inference.
+///
+/// Concurrent requests of the same executable are stacked along the batch
+/// dimension, so they share the communication rounds of a single run.
+///
+/// Every party submits the same requests (by request id), the party of rank 0
+/// decides the content of each batch and announces it to the others, so all
+/// parties run identical batches. While serving, the processor and its link
+/// context are used by the batching thread only.
+class BatchingProcessor final {
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    // values of the batched inputs, in the order of batched_inputs.
+    std::vector<ValueProto> inputs;
+    int64_t rows = 0;
+    Clock::time_point submit_time;
+    std::promise<std::vector<std::string>> result;
+  };
+
+  Processor *const processor_;
+  const BatchingOptions options_;
+  const bool is_leader_;
+
+  // the executable with batched inputs and outputs renamed, see kVarPrefix.
+  ExecutableProto batch_exec_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::map<std::string, Request> pending_;
+  // submit order and queued rows, used by the leader only.
+  std::deque<std::string> order_;
+  int64_t queued_rows_ = 0;
+  bool stopping_ = false;
+
+  // stats, guarded by mutex_.
+  std::vector<double> latencies_ms_;
+  size_t num_batches_ = 0;
+  int64_t num_rows_ = 0;
+  Clock::time_point first_submit_;
+  Clock::time_point last_done_;
+
+  std::thread worker_;
+
+public:
+  explicit BatchingProcessor(Processor *processor, ExecutableProto exec,
+                             BatchingOptions options);
+
+  /// Stop serving, see stop().
+  ~BatchingProcessor();
+
+  /// Submit a request.
+  ///
+  /// @param request_id the same id must be submitted to all parties.
+  /// @param inputs serialized ValueProto of batched_inputs, all with the same
+  ///        number of rows (at most batch_size).
+  /// @return serialized ValueProto of the outputs of this request.
+  std::future<std::vector<std::string>>
+  submit(const std::string &request_id, const std::vector<std::string> &inputs);
+
+  /// Stop serving, all parties should call it. The leader runs the queued
+  /// requests before it tells the others to stop.
+  void stop();
+
+  BatchingStats stats() const;
+
+private:
+  void leaderLoop();
+  void followerLoop();
+
+  void runBatch(const std::vector<std::string> &request_ids);
+
+  void failPending(const std::exception_ptr &error);
+};
+
+} // namespace ppu::device
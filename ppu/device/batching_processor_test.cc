@@ -0,0 +1,176 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/device/batching_processor.h"
+
+#include <future>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
+
+#include "ppu/device/io_accessor.h"
+#include "ppu/mpc/util/simulate.h"
+
+namespace ppu::device {
+namespace {
+
+constexpr char kCode[] = R"(
+func @main(%arg0: tensor<4x2x!pphlo.sint>, %arg1: tensor<4x2x!pphlo.pint>) -> (tensor<4x2x!pphlo.sint>) {
+  %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<4x2x!pphlo.sint>, tensor<4x2x!pphlo.pint>) -> tensor<4x2x!pphlo.sint>
+  return %0 : tensor<4x2x!pphlo.sint>
+})";
+
+std::vector<std::string> serialize(const std::vector<ValueProto> &vals) {
+  std::vector<std::string> ret;
+  for (const auto &val : vals) {
+    ret.push_back(val.SerializeAsString());
+  }
+  return ret;
+}
+
+} // namespace
+
+class BatchingProcessorTest
+    : public ::testing::TestWithParam<std::tuple<size_t, ProtocolKind>> {};
+
+TEST_P(BatchingProcessorTest, Basic) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+
+  RuntimeConfig config;
+  config.set_protocol(std::get<1>(GetParam()));
+  config.set_field(FieldType::FM64);
+  IoAccessor io(kWorldSize, config);
+
+  // the first three requests fill a batch, the last one runs (padded) when
+  // its deadline expires.
+  const std::vector<int64_t> rows = {1, 2, 1, 3};
+  const std::vector<int64_t> batch_offsets = {0, 1, 3, 0};
+  const xt::xarray<int> w = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+
+  std::vector<xt::xarray<int>> xs;
+  std::vector<std::vector<std::string>> x_shares;
+  for (size_t idx = 0; idx < rows.size(); idx++) {
+    xt::xarray<int> x =
+        xt::arange<int>(rows[idx] * 2) + static_cast<int>(10 * idx);
+    x.reshape({static_cast<size_t>(rows[idx]), 2});
+    x_shares.push_back(serialize(io.makeShares(Visibility::VIS_SECRET, x)));
+    xs.push_back(std::move(x));
+  }
+  const auto w_shares = serialize(io.makeShares(Visibility::VIS_PUBLIC, w));
+
+  ExecutableProto exec;
+  exec.add_input_names("x");
+  exec.add_input_names("w");
+  exec.add_output_names("y");
+  exec.set_code(kCode);
+
+  BatchingOptions options;
+  options.batch_size = 4;
+  options.max_latency = std::chrono::milliseconds(200);
+  options.batched_inputs = {"x"};
+
+  // outputs[rank][request]
+  std::vector<std::vector<std::string>> outputs(kWorldSize);
+  std::vector<BatchingStats> stats(kWorldSize);
+  mpc::util::simulate(
+      kWorldSize, [&](const std::shared_ptr<link::Context> &lctx) {
+        const size_t rank = lctx->Rank();
+        Processor processor(config, lctx);
+        processor.setVar("w", w_shares[rank]);
+
+        BatchingProcessor server(&processor, exec, options);
+        std::vector<std::future<std::vector<std::string>>> futures;
+        for (size_t idx = 0; idx < rows.size(); idx++) {
+          futures.push_back(server.submit(fmt::format("request{}", idx),
+                                          {x_shares[idx][rank]}));
+        }
+        for (auto &future : futures) {
+          auto outs = future.get();
+          ASSERT_EQ(outs.size(), 1);
+          outputs[rank].push_back(outs[0]);
+        }
+        server.stop();
+        stats[rank] = server.stats();
+
+        // the user variables are untouched.
+        EXPECT_EQ(processor.getVar("w"), w_shares[rank]);
+      });
+
+  for (size_t idx = 0; idx < rows.size(); idx++) {
+    std::vector<ValueProto> shares(kWorldSize);
+    for (size_t rank = 0; rank < kWorldSize; rank++) {
+      ASSERT_TRUE(shares[rank].ParseFromString(outputs[rank][idx]));
+    }
+    auto y = io.combineShares(shares, PtType::PT_I32);
+    const int64_t begin = batch_offsets[idx];
+    xt::xarray<int> expected =
+        xs[idx] * xt::view(w, xt::range(begin, begin + rows[idx]));
+    EXPECT_EQ(expected, xt_adapt<int>(y)) << "request " << idx;
+  }
+
+  for (const auto &stat : stats) {
+    EXPECT_EQ(stat.num_requests, rows.size());
+    EXPECT_EQ(stat.num_batches, 2);
+    EXPECT_DOUBLE_EQ(stat.avg_batch_rows, 3.5);
+    EXPECT_GT(stat.latency_p99_ms, 0);
+    EXPECT_LE(stat.latency_p50_ms, stat.latency_p99_ms);
+    EXPECT_GT(stat.throughput, 0);
+  }
+}
+
+TEST_P(BatchingProcessorTest, RejectsOversizedRequest) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+
+  RuntimeConfig config;
+  config.set_protocol(std::get<1>(GetParam()));
+  config.set_field(FieldType::FM64);
+  IoAccessor io(kWorldSize, config);
+
+  const xt::xarray<int> x = xt::zeros<int>({5, 2});
+  const auto x_shares = serialize(io.makeShares(Visibility::VIS_SECRET, x));
+
+  ExecutableProto exec;
+  exec.add_input_names("x");
+  exec.add_input_names("w");
+  exec.add_output_names("y");
+  exec.set_code(kCode);
+
+  BatchingOptions options;
+  options.batch_size = 4;
+  options.batched_inputs = {"x"};
+
+  mpc::util::simulate(
+      kWorldSize, [&](const std::shared_ptr<link::Context> &lctx) {
+        Processor processor(config, lctx);
+        BatchingProcessor server(&processor, exec, options);
+        EXPECT_THROW(server.submit("request", {x_shares[lctx->Rank()]}),
+                     EnforceNotMet);
+        server.stop();
+      });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BatchingProcessorTestInstances, BatchingProcessorTest,
+    testing::Values(std::make_tuple(2, ProtocolKind::SEMI2K),
+                    std::make_tuple(3, ProtocolKind::SEMI2K),
+                    std::make_tuple(3, ProtocolKind::ABY3)),
+    [](const testing::TestParamInfo<BatchingProcessorTest::ParamType> &info) {
+      return fmt::format("{}x{}", std::get<0>(info.param),
+                         std::get<1>(info.param));
+    });
+
+} // namespace ppu::device
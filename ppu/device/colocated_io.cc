@@ -15,6 +15,8 @@
 
 #include "ppu/device/colocated_io.h"
 
+#include <cstring>
+
 #include "spdlog/spdlog.h"
 
 #include "ppu/core/array_ref_util.h"
@@ -23,6 +25,47 @@
 #include "ppu/device/colocated_io.pb.h"
 
 namespace ppu::device {
+namespace {
+
+void toProto(const mpc::SeededShare &share, SeededVarProto *proto) {
+  proto->set_correction_index(share.correction_index);
+  for (const auto &[idx, seed] : share.seeds) {
+    proto->add_seed_indices(idx);
+    proto->add_seeds(&seed, sizeof(seed));
+  }
+  if (share.correction.has_value()) {
+    const auto &correction = *share.correction;
+    PPU_ENFORCE(correction.isCompact());
+    proto->set_has_correction(true);
+    proto->set_correction(correction.data(),
+                          correction.numel() * correction.elsize());
+  }
+}
+
+// splits are viewed as storage integers, see mpc::RingIo.
+mpc::SeededShare fromProto(const SeededVarProto &proto, const Type &split_ty,
+                           const std::vector<int64_t> &shape) {
+  PPU_ENFORCE(proto.seed_indices_size() == proto.seeds_size());
+
+  mpc::SeededShare share;
+  share.correction_index = proto.correction_index();
+  for (int idx = 0; idx < proto.seeds_size(); idx++) {
+    uint128_t seed;
+    PPU_ENFORCE(proto.seeds(idx).size() == sizeof(seed));
+    std::memcpy(&seed, proto.seeds(idx).data(), sizeof(seed));
+    share.seeds.emplace(proto.seed_indices(idx), seed);
+  }
+  if (proto.has_correction()) {
+    const auto &content = proto.correction();
+    PPU_ENFORCE(static_cast<int64_t>(content.size()) ==
+                numel(shape) * static_cast<int64_t>(split_ty.size()));
+    auto buf = makeBuffer(content.data(), content.size());
+    share.correction = NdArrayRef(std::move(buf), split_ty, shape);
+  }
+  return share;
+}
+
+} // namespace
 
 void ColocatedIo::setVar(const std::string &name, PtBufferView bv) {
   pending_.emplace(name, make_ndarray(bv));
@@ -39,53 +82,69 @@ hal::Value ColocatedIo::getVar(const std::string &name) {
 
 void ColocatedIo::sync() {
   const auto &lctx = processor_->lctx();
-
-  IoAccessor io_util(lctx->WorldSize(), processor_->rt_config());
-
-  for (Rank root = 0; root < lctx->WorldSize(); root++) {
-    // each party as the root
-    std::vector<Buffer> inputs;
-    if (lctx->Rank() == root) {
-      std::vector<NamedValueList> vars_per_party(lctx->WorldSize());
-      for (const auto &[name, arr] : pending_) {
-        PPU_ENFORCE(arr.eltype().isa<PtTy>());
-
-        PtBufferView bv(arr.data(), arr.eltype().as<PtTy>()->pt_type(),
-                        arr.shape(), arr.strides());
-
-        auto shares = io_util.makeShares(VIS_SECRET, bv);
-
-        PPU_ENFORCE(shares.size() == lctx->WorldSize());
-        for (Rank idx = 0; idx < lctx->WorldSize(); idx++) {
-          auto *item = vars_per_party[idx].add_items();
-          item->set_name(name);
-          *item->mutable_value() = std::move(shares[idx]);
-        }
-      }
-      inputs.resize(vars_per_party.size());
-      for (size_t idx = 0; idx < vars_per_party.size(); idx++) {
-        inputs[idx].resize(vars_per_party[idx].ByteSizeLong());
-        PPU_ENFORCE(vars_per_party[idx].SerializeToArray(inputs[idx].data(),
-                                                         inputs[idx].size()));
+  const size_t world_size = lctx->WorldSize();
+  const size_t self_rank = lctx->Rank();
+  const Type split_ty =
+      makePtType(GetStorageType(processor_->rt_config().field()));
+
+  IoAccessor io_util(world_size, processor_->rt_config());
+
+  // seed-compress local variables, one list per receiver. seeds are 16 bytes,
+  // only the correction split carries data.
+  std::vector<SeededVarList> outgoing(world_size);
+  for (const auto &[name, arr] : pending_) {
+    PPU_ENFORCE(arr.eltype().isa<PtTy>());
+
+    PtBufferView bv(arr.data(), arr.eltype().as<PtTy>()->pt_type(),
+                    arr.shape(), arr.strides());
+
+    DataType dtype;
+    auto shares = io_util.makeSeededShares(bv, self_rank, &dtype);
+
+    PPU_ENFORCE(shares.size() == world_size);
+    for (Rank idx = 0; idx < world_size; idx++) {
+      auto *item = outgoing[idx].add_items();
+      item->set_name(name);
+      item->set_dtype(dtype);
+      for (const auto &dim : arr.shape()) {
+        item->mutable_shape()->add_dims(dim);
       }
+      toProto(shares[idx], item);
     }
+  }
+  pending_.clear();
 
-    Buffer data = link::Scatter(lctx, inputs, root,
-                                fmt::format("COLOCATED_IO:SYNC:{}", root));
+  // exchange all variables of all parties in one round.
+  const std::string tag = "COLOCATED_IO:SYNC";
+  for (Rank idx = 0; idx < world_size; idx++) {
+    if (idx == self_rank) {
+      continue;
+    }
+    Buffer buf(static_cast<int64_t>(outgoing[idx].ByteSizeLong()));
+    PPU_ENFORCE(outgoing[idx].SerializeToArray(buf.data(), buf.size()));
+    lctx->SendAsync(idx, buf, tag);
+  }
 
-    NamedValueList var_list;
-    PPU_ENFORCE(var_list.ParseFromArray(data.data(), data.size()));
+  for (Rank idx = 0; idx < world_size; idx++) {
+    SeededVarList var_list;
+    if (idx == self_rank) {
+      var_list = std::move(outgoing[idx]);
+    } else {
+      Buffer buf = lctx->Recv(idx, tag);
+      PPU_ENFORCE(var_list.ParseFromArray(buf.data(), buf.size()));
+    }
 
     for (const auto &var : var_list.items()) {
+      std::vector<int64_t> shape(var.shape().dims().begin(),
+                                 var.shape().dims().end());
+      auto value = io_util.expandSeededShare(
+          fromProto(var, split_ty, shape), self_rank, var.dtype(), shape);
+
       std::string buf;
-      PPU_ENFORCE(var.value().SerializeToString(&buf));
+      PPU_ENFORCE(value.SerializeToString(&buf));
       processor_->setVar(var.name(), buf);
     }
   }
-
-  // TODO(jint)
-  // 1. Optimize latency, use 1 allgather instead of n scatter.
-  // 2. Optimize communication, use zero sharing.
 }
 
 } // namespace ppu::device
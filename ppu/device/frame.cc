@@ -61,7 +61,10 @@ void checkType(::mlir::RankedTensorType type, const hal::Value &v) {
 
 } // namespace
 
-void Frame::releaseValue(::mlir::Value operand) { values_.erase(operand); }
+void Frame::releaseValue(::mlir::Value operand) {
+  values_.erase(operand);
+  lazy_values_.erase(operand);
+}
 
 const hal::Value &Frame::getValue(::mlir::Value operand) const {
   auto iter = values_.find(operand);
@@ -78,10 +81,17 @@ const hal::Value &Frame::getValue(::mlir::Value operand) const {
 
 void Frame::addValue(::mlir::Value operand, hal::Value &&val) {
   values_[operand] = std::move(val);
+  lazy_values_.erase(operand);
 }
 
 void Frame::addValue(::mlir::Value operand, const hal::Value &val) {
   values_[operand] = val;
+  lazy_values_.erase(operand);
+}
+
+void Frame::addLazyValue(::mlir::Value operand, hal::Value &&val) {
+  values_[operand] = std::move(val);
+  lazy_values_.insert(operand);
 }
 
 } // namespace ppu::device
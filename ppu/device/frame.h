@@ -16,6 +16,7 @@
 #pragma once
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "mlir/IR/Value.h"
 
 #include "ppu/hal/value.h"
@@ -28,6 +29,8 @@ class ModuleRunner;
 class Frame final {
   friend ModuleRunner;
   llvm::DenseMap<mlir::Value, hal::Value> values_;
+  // Values whose fixed-point truncation is deferred, see hal::mul_lazy.
+  llvm::DenseSet<mlir::Value> lazy_values_;
   bool with_type_checker_;
 
 public:
@@ -44,6 +47,13 @@ public:
   void addValue(::mlir::Value operand, const hal::Value &val);
   void addValue(::mlir::Value operand, hal::Value &&val);
 
+  // Add a value carrying 2f fractional bits, it stays lazy until replaced by
+  // addValue.
+  void addLazyValue(::mlir::Value operand, hal::Value &&val);
+  bool isLazyValue(::mlir::Value operand) const {
+    return lazy_values_.count(operand) > 0;
+  }
+
   void releaseValue(::mlir::Value operand);
   const hal::Value &getValue(::mlir::Value operand) const;
 };
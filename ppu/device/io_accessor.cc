@@ -67,6 +67,24 @@ std::vector<ValueProto> IoAccessor::makeShares(Visibility vis,
   return result;
 }
 
+std::vector<mpc::SeededShare>
+IoAccessor::makeSeededShares(PtBufferView bv, size_t owner, DataType *dtype) {
+  const Type encoded_ty = makeType<RingTy>(config_.field());
+  const size_t fxp_bits = FxpFractionalBits(config_);
+
+  auto raw = make_ndarray(std::move(bv));
+  auto encoded = encodeToRing(raw, encoded_ty, fxp_bits, dtype);
+  return base_io_->makeSeededSecret(encoded, owner);
+}
+
+ValueProto IoAccessor::expandSeededShare(const mpc::SeededShare &share,
+                                         size_t rank, DataType dtype,
+                                         const std::vector<int64_t> &shape) {
+  auto expanded =
+      base_io_->expandSeededSecret(share, rank, config_.field(), shape);
+  return hal::makeValue(expanded, dtype).toProto();
+}
+
 NdArrayRef IoAccessor::combineShares(const std::vector<ValueProto> &protos,
                                      PtType pt_type) {
   PPU_ENFORCE(!protos.empty());
@@ -99,4 +117,54 @@ NdArrayRef IoAccessor::combineShares(const std::vector<ValueProto> &protos,
   return decodeFromRing(encoded, to_type, fxp_bits, dtype);
 }
 
+std::vector<ValueChunkProto>
+IoAccessor::makeShareChunks(Visibility vis, PtBufferView bv,
+                            const std::vector<int64_t> &shape,
+                            int64_t row_begin) {
+  const int64_t num_rows = shape.empty() ? 1 : shape[0];
+  const int64_t rows = bv.shape.empty() ? 1 : bv.shape[0];
+  PPU_ENFORCE(row_begin >= 0 && row_begin + rows <= num_rows,
+              "invalid rows [{}, {}), num_rows={}", row_begin,
+              row_begin + rows, num_rows);
+
+  auto shares = makeShares(vis, bv);
+
+  std::vector<ValueChunkProto> chunks(shares.size());
+  for (size_t idx = 0; idx < shares.size(); idx++) {
+    auto &chunk = chunks[idx];
+    chunk.set_type_data(shares[idx].type_data());
+    for (const auto &dim : shape) {
+      chunk.mutable_shape()->add_dims(dim);
+    }
+    chunk.set_row_begin(row_begin);
+    chunk.set_row_end(row_begin + rows);
+    chunk.set_allocated_content(shares[idx].release_content());
+  }
+  return chunks;
+}
+
+NdArrayRef
+IoAccessor::combineShareChunks(const std::vector<ValueChunkProto> &chunks,
+                               PtType pt_type) {
+  PPU_ENFORCE(!chunks.empty());
+
+  std::vector<ValueProto> protos(chunks.size());
+  for (size_t idx = 0; idx < chunks.size(); idx++) {
+    const auto &chunk = chunks[idx];
+    PPU_ENFORCE(chunk.row_begin() == chunks[0].row_begin() &&
+                    chunk.row_end() == chunks[0].row_end(),
+                "chunks should cover the same rows");
+
+    // view the chunk as a value of its rows.
+    auto &proto = protos[idx];
+    proto.set_type_data(chunk.type_data());
+    *proto.mutable_shape() = chunk.shape();
+    if (proto.shape().dims_size() > 0) {
+      proto.mutable_shape()->set_dims(0, chunk.row_end() - chunk.row_begin());
+    }
+    proto.set_content(chunk.content());
+  }
+  return combineShares(protos, pt_type);
+}
+
 } // namespace ppu::device
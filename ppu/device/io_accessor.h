@@ -39,9 +39,31 @@ public:
 
   std::vector<ValueProto> makeShares(Visibility vis, PtBufferView bv);
 
+  // make seed-compressed secret shares, one per party, the plaintext is held
+  // by `owner`. see mpc::IoInterface::makeSeededSecret.
+  std::vector<mpc::SeededShare> makeSeededShares(PtBufferView bv, size_t owner,
+                                                 DataType *dtype);
+
+  // expand the seeded share of `rank` to a secret value.
+  ValueProto expandSeededShare(const mpc::SeededShare &share, size_t rank,
+                               DataType dtype,
+                               const std::vector<int64_t> &shape);
+
   // combine shares to a plaintext ndarray.
   NdArrayRef combineShares(const std::vector<ValueProto> &protos,
                            PtType pt_type);
+
+  // streaming infeed, make shares of a row-block. `bv` holds the rows
+  // [row_begin, row_begin + bv.shape[0]) of a value of `shape`, only this
+  // block is encoded and shared at a time.
+  std::vector<ValueChunkProto>
+  makeShareChunks(Visibility vis, PtBufferView bv,
+                  const std::vector<int64_t> &shape, int64_t row_begin);
+
+  // streaming outfeed, combine the chunks (one per party) of the same rows to
+  // a plaintext ndarray of these rows.
+  NdArrayRef combineShareChunks(const std::vector<ValueChunkProto> &chunks,
+                                PtType pt_type);
 };
 
 } // namespace ppu::device
@@ -15,8 +15,11 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
 
 #include "ppu/device/io_accessor.h"
+#include "ppu/device/symbol_table.h"
+#include "ppu/utils/exception.h"
 
 namespace ppu::device {
 
@@ -62,6 +65,90 @@ TEST_P(IoAccessorTest, Int) {
   EXPECT_EQ(input, output);
 }
 
+TEST_P(IoAccessorTest, SeededSecret) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+  if (std::get<3>(GetParam()) != Visibility::VIS_SECRET) {
+    return;
+  }
+
+  RuntimeConfig config;
+  config.set_protocol(std::get<1>(GetParam()));
+  config.set_field(std::get<2>(GetParam()));
+  IoAccessor sym(kWorldSize, config);
+
+  xt::xarray<float> input({{1, -2, 3, 0}, {0.5, 7, -1.5, 2}});
+  const std::vector<int64_t> shape(input.shape().begin(), input.shape().end());
+
+  for (size_t owner = 0; owner < kWorldSize; owner++) {
+    DataType dtype;
+    auto seeded = sym.makeSeededShares(input, owner, &dtype);
+    EXPECT_EQ(seeded.size(), kWorldSize);
+    EXPECT_EQ(dtype, DT_FXP);
+
+    std::vector<ValueProto> shares;
+    for (size_t rank = 0; rank < kWorldSize; rank++) {
+      shares.push_back(
+          sym.expandSeededShare(seeded[rank], rank, dtype, shape));
+    }
+
+    auto reconstruct = sym.combineShares(shares, PtType::PT_F64);
+    auto output = xt_adapt<double>(reconstruct);
+    EXPECT_EQ(input, output);
+  }
+}
+
+TEST_P(IoAccessorTest, Chunked) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+  const Visibility kVisibility = std::get<3>(GetParam());
+
+  RuntimeConfig config;
+  config.set_protocol(std::get<1>(GetParam()));
+  config.set_field(std::get<2>(GetParam()));
+  IoAccessor sym(kWorldSize, config);
+
+  xt::xarray<float> input(
+      {{1, -2, 3, 0}, {0.5, 7, -1.5, 2}, {4, 5, 6, 7}, {-8, 9, 10, 11},
+       {12, -13, 14, 15}});
+  const std::vector<int64_t> shape(input.shape().begin(), input.shape().end());
+
+  // stream the rows in blocks of 2, out of order.
+  std::vector<SymbolTable> tables(kWorldSize);
+  for (int64_t row_begin : {2, 0, 4}) {
+    const int64_t row_end = std::min<int64_t>(row_begin + 2, shape[0]);
+    xt::xarray<float> block = xt::view(input, xt::range(row_begin, row_end));
+    auto chunks = sym.makeShareChunks(kVisibility, block, shape, row_begin);
+    EXPECT_EQ(chunks.size(), kWorldSize);
+    for (size_t rank = 0; rank < kWorldSize; rank++) {
+      EXPECT_FALSE(tables[rank].hasVar("x"));
+      tables[rank].setVarChunk("x", chunks[rank]);
+    }
+    if (row_begin == 2) {
+      // a duplicated chunk or a chunk of another shape is rejected.
+      auto reshaped = chunks[0];
+      reshaped.mutable_shape()->set_dims(1, shape[1] + 1);
+      EXPECT_THROW(tables[0].setVarChunk("x", chunks[0]), EnforceNotMet);
+      EXPECT_THROW(tables[0].setVarChunk("x", reshaped), EnforceNotMet);
+    }
+  }
+
+  std::vector<ValueProto> shares(kWorldSize);
+  for (size_t rank = 0; rank < kWorldSize; rank++) {
+    ASSERT_TRUE(tables[rank].hasVar("x"));
+    ASSERT_TRUE(shares[rank].ParseFromString(tables[rank].getVar("x")));
+  }
+  auto reconstruct = sym.combineShares(shares, PtType::PT_F64);
+  EXPECT_EQ(input, xt_adapt<double>(reconstruct));
+
+  // stream out rows [1, 4).
+  std::vector<ValueChunkProto> chunks;
+  for (size_t rank = 0; rank < kWorldSize; rank++) {
+    chunks.push_back(tables[rank].getVarChunk("x", 1, 4));
+  }
+  auto rows = sym.combineShareChunks(chunks, PtType::PT_F64);
+  xt::xarray<double> expected = xt::view(input, xt::range(1, 4));
+  EXPECT_EQ(expected, xt_adapt<double>(rows));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     IoAccessorTestInstance, IoAccessorTest,
     testing::Combine(
@@ -21,6 +21,8 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/raw_os_ostream.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/BuiltinAttributes.h"
@@ -106,6 +108,42 @@ hal::Value reshapedGatherIndices(HalContext *ctx, int64_t index_vector_dim,
   return hal::reshape(ctx, start_indices, new_shape);
 }
 
+// Whether the gather picks whole rows of the operand's leading dimension, i.e.
+// an embedding lookup `operand[indices]`. Expects the start indices already
+// reshaped by reshapedGatherIndices.
+bool isRowGather(const mlir::pphlo::GatherDimensionNumbersAttr &dim_numbers,
+                 llvm::ArrayRef<int64_t> operand_shape,
+                 const mlir::DenseIntElementsAttr &slice_sizes_attr,
+                 const std::vector<int64_t> &indices_shape) {
+  const int64_t batch_rank = static_cast<int64_t>(indices_shape.size()) - 1;
+  if (operand_shape.empty() ||
+      dim_numbers.getIndexVectorDim() != batch_rank ||
+      indices_shape.back() != 1) {
+    return false;
+  }
+  if (dim_numbers.getStartIndexMap().size() != 1 ||
+      dim_numbers.getStartIndexMap()[0] != 0 ||
+      dim_numbers.getCollapsedSliceDims().size() != 1 ||
+      dim_numbers.getCollapsedSliceDims()[0] != 0) {
+    return false;
+  }
+  const auto values = slice_sizes_attr.getValues<int64_t>();
+  const std::vector<int64_t> slice_sizes(values.begin(), values.end());
+  if (slice_sizes.size() != operand_shape.size() || slice_sizes[0] != 1 ||
+      !std::equal(slice_sizes.begin() + 1, slice_sizes.end(),
+                  operand_shape.begin() + 1)) {
+    return false;
+  }
+  // offset dims trail the batch dims.
+  const auto offset_dims = dim_numbers.getOffsetDims();
+  for (size_t i = 0; i < offset_dims.size(); i++) {
+    if (offset_dims[i] != batch_rank + static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return offset_dims.size() == operand_shape.size() - 1;
+}
+
 struct IndexIterationSpace {
   std::vector<int64_t> index_base;
   std::vector<int64_t> index_count;
@@ -405,88 +443,43 @@ void forEachIndex(llvm::ArrayRef<int64_t> shape, llvm::ArrayRef<int64_t> base,
   }
 }
 
-template <typename FnType>
-void forEachIndex(llvm::ArrayRef<int64_t> shape,
-                  const FnType &visitor_function) {
-  std::vector<int64_t> base(shape.size());
-  std::vector<int64_t> incr(shape.size(), 1);
-  return forEachIndex(shape, base,
-                      /*count=*/shape, incr, visitor_function);
-}
-
-void performReductionStep(PPHloExecutor *executor,
-                          llvm::ArrayRef<int64_t> input_index,
-                          llvm::ArrayRef<int64_t> output_index,
-                          llvm::ArrayRef<hal::Value> input_args,
-                          llvm::ArrayRef<hal::Value> results,
-                          mlir::Region &computation) {
-  int num_args = results.size();
-
-  std::vector<hal::Value> arg_values;
-  arg_values.reserve(num_args);
-  std::vector<hal::Value> accumulators;
-  accumulators.reserve(num_args);
-  for (int64_t i = 0; i < num_args; ++i) {
-    arg_values.emplace_back(hal::make_value(
-        executor->getContext(), input_args[i].vtype(),
-        input_args[i].is_int() ? PtBufferView(0) : PtBufferView(0.0F)));
-    accumulators.emplace_back(hal::make_value(
-        executor->getContext(), input_args[i].vtype(),
-        input_args[i].is_int() ? PtBufferView(0) : PtBufferView(0.0F)));
-
-    arg_values[i].CopyElementFrom(input_args[i], input_index, {});
-    accumulators[i].CopyElementFrom(results[i], output_index, {});
+// Returns true if the reduce body is `return add(lhs, rhs)`, which is linear
+// and could be computed locally in one pass.
+bool isAddReducer(mlir::Region &region) {
+  if (!region.hasOneBlock()) {
+    return false;
   }
-
-  // Evaluate computation with specified literal operands.
-  std::vector<hal::Value> embedded_operands;
-  embedded_operands.reserve(computation.getNumArguments());
-  for (const auto &accumulator : accumulators) {
-    embedded_operands.push_back(accumulator);
+  auto &block = region.front();
+  if (block.getNumArguments() != 2 ||
+      !llvm::hasSingleElement(block.without_terminator())) {
+    return false;
   }
-  for (const auto &local_input : arg_values) {
-    embedded_operands.push_back(local_input);
-  }
-
-  auto computed_results =
-      executor->executeRegion(computation, embedded_operands);
-
-  for (int64_t i = 0; i < num_args; ++i) {
-    results[i].CopyElementFrom(computed_results[i], {}, output_index);
+  auto add = llvm::dyn_cast<mlir::pphlo::AddOp>(block.front());
+  auto *term = block.getTerminator();
+  if (!add || term->getNumOperands() != 1 ||
+      term->getOperand(0) != add.getResult()) {
+    return false;
   }
+  // add is commutative, so operands could be in either order.
+  const auto lhs = add.getOperand(0);
+  const auto rhs = add.getOperand(1);
+  return (lhs == block.getArgument(0) && rhs == block.getArgument(1)) ||
+         (lhs == block.getArgument(1) && rhs == block.getArgument(0));
 }
 
-void generateReduceOutputElement(PPHloExecutor *executor,
-                                 llvm::ArrayRef<int64_t> output_index,
-                                 llvm::ArrayRef<hal::Value> init_values,
-                                 llvm::ArrayRef<hal::Value> input_args,
-                                 llvm::ArrayRef<hal::Value> results,
-                                 mlir::Region &function,
-                                 llvm::ArrayRef<int64_t> arg_dim_steps,
-                                 llvm::ArrayRef<int64_t> arg_dim_counts,
-                                 llvm::ArrayRef<int64_t> result_to_arg_index) {
-  std::vector<int64_t> arg_dimensions = input_args[0].shape();
-  std::vector<int64_t> base(arg_dimensions.size());
-  for (int64_t i = 0; i < static_cast<int64_t>(output_index.size()); ++i) {
-    base[result_to_arg_index[i]] = output_index[i];
-  }
+} // namespace
 
-  for (int64_t i = 0; i < static_cast<int64_t>(results.size()); ++i) {
-    results[i].CopyElementFrom(init_values[i], {}, output_index);
+template <typename T>
+std::vector<T>
+PPHloExecutor::indices(const mlir::DenseIntElementsAttr &attr) const {
+  if (program_ != nullptr) {
+    if (const auto *decoded = program_->getIndices(attr)) {
+      return std::vector<T>(decoded->begin(), decoded->end());
+    }
   }
-
-  // Iterates only over reduced shape, as counts and steps are set to zero
-  // for all non-reduced dimensions.
-  forEachIndex(arg_dimensions, base, arg_dim_counts, arg_dim_steps,
-               [&](llvm::ArrayRef<int64_t> input_index) {
-                 return performReductionStep(executor, input_index,
-                                             output_index, input_args, results,
-                                             function);
-               });
+  return build_vec_idx<T>(attr);
 }
 
-} // namespace
-
 const hal::Value &PPHloExecutor::lookupValue(::mlir::Value v) const {
   for (auto iter = frames_.rbegin(); iter != frames_.rend(); ++iter) {
     const auto *frame = *iter;
@@ -504,63 +497,29 @@ const hal::Value &PPHloExecutor::lookupValue(::mlir::Value v) const {
 
 void PPHloExecutor::executeVReduce(mlir::pphlo::ReduceOp &op) {
   int64_t num_args = op->getNumOperands() / 2;
-  std::vector<int64_t> dimensions_to_reduce =
-      build_vec_idx<int64_t>(op.dimensions());
-  auto &function = op.body();
 
-  llvm::SmallVector<hal::Value, 2> input_args(num_args);
-  llvm::SmallVector<hal::Value, 2> init_values(num_args);
+  std::vector<hal::Value> input_args(num_args);
+  std::vector<hal::Value> init_values(num_args);
   for (int64_t i = 0; i < num_args; ++i) {
     input_args[i] = lookupValue(op.inputs()[i]);
     init_values[i] = lookupValue(op.init_values()[i]);
   }
 
-  // All args and results have the same dimensions, so pick an arbitrary one.
-  const auto &output_shape =
-      op->getResultTypes()[0].dyn_cast<mlir::RankedTensorType>().getShape();
-
-  std::vector<int64_t> arg_dimensions = input_args[0].shape();
-
-  // All increments are set to 0.
-  std::vector<int64_t> arg_dim_steps(arg_dimensions.size());
-
-  // All counts are set to 0.
-  std::vector<int64_t> arg_dim_counts(arg_dimensions.size());
-
-  // Set steps and counts for reduced dimensions.
-  // This avoids iterating over non-reduced dimensions, as their step
-  // and count is set to zero.
-  for (const int64_t dim : dimensions_to_reduce) {
-    arg_dim_steps[dim] = 1;
-    arg_dim_counts[dim] = arg_dimensions[dim];
-  }
-
-  // Map each dimension in the result to a dimension in arg that isn't
-  // being reduced.
-  std::vector<int64_t> result_to_arg_index;
-  for (int64_t i = 0; i < static_cast<int64_t>(arg_dimensions.size()); ++i) {
-    if (arg_dim_steps[i] == 0) {
-      result_to_arg_index.push_back(i);
-    }
-  }
-
-  llvm::SmallVector<hal::Value, 2> results(num_args);
-  for (int64_t i = 0; i < num_args; ++i) {
-    auto ret_shape =
-        op->getResultTypes()[i].dyn_cast<mlir::RankedTensorType>().getShape();
-    results[i] = hal::broadcast_to(ctx_,
-                                   hal::make_value(ctx_, input_args[i].vtype(),
-                                                   input_args[i].is_int()
-                                                       ? PtBufferView(0)
-                                                       : PtBufferView(0.0F)),
-                                   build_shape(ret_shape));
-  }
-
-  forEachIndex(output_shape, [&](llvm::ArrayRef<int64_t> output_index) {
-    return generateReduceOutputElement(
-        this, output_index, init_values, input_args, results, function,
-        arg_dim_steps, arg_dim_counts, result_to_arg_index);
-  });
+  // Vectorized reduce can have simd lambda op in the middle, so disable type
+  // checker
+  auto old = config_.enable_type_checker;
+  config_.enable_type_checker = false;
+  auto results = hal::reduce(
+      ctx_, input_args, init_values, indices<size_t>(op.dimensions()),
+      [&](absl::Span<const hal::Value> lhs, absl::Span<const hal::Value> rhs) {
+        // Region arguments are (accumulators..., inputs...).
+        std::vector<hal::Value> operands(lhs.begin(), lhs.end());
+        operands.insert(operands.end(), rhs.begin(), rhs.end());
+        auto ret = executeRegion(op.body(), operands);
+        PPU_ENFORCE(static_cast<int64_t>(ret.size()) == num_args);
+        return ret;
+      });
+  config_.enable_type_checker = old;
 
   for (int64_t i = 0; i < num_args; ++i) {
     getCurrentFrame()->addValue(op->getResult(i), results[i]);
@@ -570,6 +529,14 @@ void PPHloExecutor::executeVReduce(mlir::pphlo::ReduceOp &op) {
 void PPHloExecutor::execute(mlir::pphlo::ReduceOp &op) {
   if (op->getNumOperands() > 2) {
     executeVReduce(op);
+  } else if (isAddReducer(op.body())) {
+    // Fast path, reduce_sum needs no communication nor reduction tree.
+    const auto &in = lookupValue(op.inputs()[0]);
+    const auto &init = lookupValue(op.init_values()[0]);
+    auto sum = hal::reduce_sum(ctx_, in, indices<size_t>(op.dimensions()));
+    getCurrentFrame()->addValue(
+        op.getResult(0),
+        hal::add(ctx_, hal::broadcast_to(ctx_, init, sum.shape()), sum));
   } else {
     // Vectorized reduce can have simd lambda op in the middle, so disable type
     // checker
@@ -579,7 +546,7 @@ void PPHloExecutor::execute(mlir::pphlo::ReduceOp &op) {
         op.getResult(0),
         hal::reduce(ctx_, lookupValue(op.inputs()[0]),
                     lookupValue(op.init_values()[0]),
-                    build_vec_idx<size_t>(op.dimensions()),
+                    indices<size_t>(op.dimensions()),
                     [&](const hal::Value &a, const hal::Value &b) {
                       const auto &ret = executeRegion(op.body(), {a, b});
                       PPU_ENFORCE(ret.size() == 1);
@@ -657,7 +624,7 @@ void PPHloExecutor::execute(mlir::pphlo::WhileOp &op) {
   }
 
   // Push frame
-  auto eval_cond = [&](llvm::ArrayRef<hal::Value> inputs) -> bool {
+  auto eval_cond = [&](llvm::ArrayRef<hal::Value> inputs) -> hal::Value {
     // Sanity inputs
     PPU_ENFORCE(inputs.size() == op.cond().getNumArguments());
 
@@ -668,10 +635,20 @@ void PPHloExecutor::execute(mlir::pphlo::WhileOp &op) {
     PPU_ENFORCE(ret.size() == 1,
                 "WhileOp condition body should not return more than 1 result.");
 
-    return getConditionValue(ret[0]);
+    return ret[0];
   };
 
-  while (eval_cond(inputs)) {
+  const int64_t max_iters = ctx_->rt_config().oblivious_while_max_iters();
+  while (true) {
+    auto cond = eval_cond(inputs);
+    if (cond.is_secret() && max_iters > 0) {
+      inputs = executeObliviousWhile(op, std::move(inputs), cond);
+      break;
+    }
+    if (!getConditionValue(cond)) {
+      break;
+    }
+
     // Sanity inputs
     PPU_ENFORCE(inputs.size() == op.body().getNumArguments());
 
@@ -685,6 +662,75 @@ void PPHloExecutor::execute(mlir::pphlo::WhileOp &op) {
   }
 }
 
+/// Oblivious while evaluation order, `active` is the secret condition:
+/// 1. Run body with all args, giving the next state
+/// 2. Evaluate condition on the next state
+/// 3. state = select(active, next, state), active = active & condition, both
+///    masked by one multiplication
+/// 4. Repeat oblivious_while_max_iters times, skipping 2 on the last one
+///
+/// The trip count is secret, so only public carries the body passes through
+/// unchanged keep their declared public type, any other public carry is
+/// rejected.
+std::vector<hal::Value>
+PPHloExecutor::executeObliviousWhile(mlir::pphlo::WhileOp &op,
+                                     std::vector<hal::Value> inputs,
+                                     hal::Value active) {
+  PPU_ENFORCE(active.numel() == 1 && active.is_int(),
+              "Condition value must be an integer scalar.");
+  const int64_t max_iters = ctx_->rt_config().oblivious_while_max_iters();
+
+  // only the secret carries are selected.
+  std::vector<size_t> secret_carries;
+  auto *body_ret = op.body().front().getTerminator();
+  for (size_t idx = 0; idx < inputs.size(); ++idx) {
+    if (inputs[idx].is_secret()) {
+      secret_carries.push_back(idx);
+      continue;
+    }
+    PPU_ENFORCE(body_ret->getOperand(idx) == op.body().getArgument(idx),
+                "While loop-carried value {} is public but updated by the "
+                "body, it would depend on the secret condition. Make it "
+                "secret or disable oblivious_while_max_iters.",
+                idx);
+  }
+
+  const auto zero =
+      hal::reshape(ctx_, hal::make_public(ctx_, 0), active.shape());
+  for (int64_t iter = 0; iter < max_iters; ++iter) {
+    PPU_ENFORCE(inputs.size() == op.body().getNumArguments());
+    auto next = executeRegion(op.body(), inputs);
+
+    std::vector<hal::Value> next_secret;
+    std::vector<hal::Value> prev_secret;
+    for (const size_t idx : secret_carries) {
+      next_secret.push_back(next[idx]);
+      prev_secret.push_back(inputs[idx]);
+    }
+
+    const bool last = iter + 1 == max_iters;
+    if (!last) {
+      auto cond = executeRegion(op.cond(), next);
+      PPU_ENFORCE(cond.size() == 1,
+                  "WhileOp condition body should not return more than 1 "
+                  "result.");
+      // active & cond == select(active, cond, 0) for 0/1 values.
+      next_secret.push_back(cond[0]);
+      prev_secret.push_back(zero);
+    }
+
+    auto selected = hal::select(ctx_, active, next_secret, prev_secret);
+    if (!last) {
+      active = selected.back();
+      selected.pop_back();
+    }
+    for (size_t pos = 0; pos < secret_carries.size(); ++pos) {
+      inputs[secret_carries[pos]] = std::move(selected[pos]);
+    }
+  }
+  return inputs;
+}
+
 #define STANDARD_UNARY_OP_EXEC_IMPL(OpName, Fn)                                \
   void PPHloExecutor::execute(mlir::pphlo::OpName &op) {                       \
     getCurrentFrame()->addValue(op.getResult(),                                \
@@ -692,7 +738,6 @@ void PPHloExecutor::execute(mlir::pphlo::WhileOp &op) {
   }
 
 STANDARD_UNARY_OP_EXEC_IMPL(ReciprocalOp, hal::reciprocal)
-STANDARD_UNARY_OP_EXEC_IMPL(NegOp, hal::negate)
 STANDARD_UNARY_OP_EXEC_IMPL(ExpOp, hal::exp)
 STANDARD_UNARY_OP_EXEC_IMPL(LogOp, hal::log)
 STANDARD_UNARY_OP_EXEC_IMPL(Log1pOp, hal::log1p)
@@ -712,12 +757,9 @@ STANDARD_UNARY_OP_EXEC_IMPL(ProtectOp, hal::p2s)
         Fn(ctx_, lookupValue(op.lhs()), lookupValue(op.rhs())));               \
   }
 
-STANDARD_BINARY_OP_EXEC_IMPL(AddOp, hal::add)
 STANDARD_BINARY_OP_EXEC_IMPL(EqualOp, hal::equal);
-STANDARD_BINARY_OP_EXEC_IMPL(SubOp, hal::sub)
 STANDARD_BINARY_OP_EXEC_IMPL(LessOp, hal::less)
 STANDARD_BINARY_OP_EXEC_IMPL(GreaterOp, hal::greater)
-STANDARD_BINARY_OP_EXEC_IMPL(MulOp, hal::mul)
 STANDARD_BINARY_OP_EXEC_IMPL(PowOp, hal::power)
 STANDARD_BINARY_OP_EXEC_IMPL(MaxOp, hal::max)
 STANDARD_BINARY_OP_EXEC_IMPL(MinOp, hal::min)
@@ -727,6 +769,111 @@ STANDARD_BINARY_OP_EXEC_IMPL(XorOp, hal::bitwise_xor)
 
 #undef STANDARD_BINARY_OP_EXEC_IMPL
 
+bool PPHloExecutor::canDeferTrunc(const hal::Value &x,
+                                  const hal::Value &y) const {
+  // only a secret result pays a truncation round.
+  return ctx_->rt_config().enable_lazy_truncation() && x.is_fxp() &&
+         y.is_fxp() && (x.is_secret() || y.is_secret());
+}
+
+bool PPHloExecutor::isLazyValue(::mlir::Value v) const {
+  for (auto iter = frames_.rbegin(); iter != frames_.rend(); ++iter) {
+    if ((*iter)->hasValue(v)) {
+      return (*iter)->isLazyValue(v);
+    }
+  }
+  return false;
+}
+
+void PPHloExecutor::settleLazyOperands(mlir::Operation &op) {
+  std::vector<std::pair<Frame *, ::mlir::Value>> lazy;
+  for (const auto operand : op.getOperands()) {
+    for (auto iter = frames_.rbegin(); iter != frames_.rend(); ++iter) {
+      if ((*iter)->hasValue(operand)) {
+        if ((*iter)->isLazyValue(operand) &&
+            std::find(lazy.begin(), lazy.end(),
+                      std::make_pair(*iter, operand)) == lazy.end()) {
+          lazy.emplace_back(*iter, operand);
+        }
+        break;
+      }
+    }
+  }
+
+  if (lazy.empty()) {
+    return;
+  }
+  if (lazy.size() == 1) {
+    auto [frame, v] = lazy.front();
+    frame->addValue(v, hal::lazy_trunc(ctx_, frame->getValue(v)));
+    return;
+  }
+
+  // truncate all lazy operands of this op in one batch.
+  std::vector<hal::Value> flat;
+  for (const auto &[frame, v] : lazy) {
+    const auto &val = frame->getValue(v);
+    flat.push_back(hal::reshape(ctx_, val, {val.numel()}));
+  }
+  const auto truncated =
+      hal::lazy_trunc(ctx_, hal::concatenate(ctx_, flat, 0));
+  size_t offset = 0;
+  for (const auto &[frame, v] : lazy) {
+    const auto &val = frame->getValue(v);
+    const size_t numel = val.numel();
+    auto piece = hal::slice(ctx_, truncated, {offset}, {offset + numel}, {1});
+    frame->addValue(v, hal::reshape(ctx_, piece, val.shape()).as_fxp());
+    offset += numel;
+  }
+}
+
+void PPHloExecutor::executeLinear(
+    ::mlir::Value result, ::mlir::Value lhs, ::mlir::Value rhs,
+    hal::Value (*fn)(HalContext *, const hal::Value &, const hal::Value &)) {
+  const bool lhs_lazy = isLazyValue(lhs);
+  const bool rhs_lazy = isLazyValue(rhs);
+  const auto &x = lookupValue(lhs);
+  const auto &y = lookupValue(rhs);
+
+  if (!lhs_lazy && !rhs_lazy) {
+    getCurrentFrame()->addValue(result, fn(ctx_, x, y));
+    return;
+  }
+
+  // add/sub is linear, scale the other side up and keep the result lazy.
+  getCurrentFrame()->addLazyValue(
+      result, fn(ctx_, lhs_lazy ? x : hal::to_lazy(ctx_, x),
+                 rhs_lazy ? y : hal::to_lazy(ctx_, y)));
+}
+
+void PPHloExecutor::execute(mlir::pphlo::AddOp &op) {
+  executeLinear(op.getResult(), op.lhs(), op.rhs(), hal::add);
+}
+
+void PPHloExecutor::execute(mlir::pphlo::SubOp &op) {
+  executeLinear(op.getResult(), op.lhs(), op.rhs(), hal::sub);
+}
+
+void PPHloExecutor::execute(mlir::pphlo::NegOp &op) {
+  const auto &in = lookupValue(op.getOperand());
+  if (isLazyValue(op.getOperand())) {
+    getCurrentFrame()->addLazyValue(op.getResult(), hal::negate(ctx_, in));
+  } else {
+    getCurrentFrame()->addValue(op.getResult(), hal::negate(ctx_, in));
+  }
+}
+
+void PPHloExecutor::execute(mlir::pphlo::MulOp &op) {
+  const auto &lhs = lookupValue(op.lhs());
+  const auto &rhs = lookupValue(op.rhs());
+  if (canDeferTrunc(lhs, rhs)) {
+    getCurrentFrame()->addLazyValue(op.getResult(),
+                                    hal::mul_lazy(ctx_, lhs, rhs));
+  } else {
+    getCurrentFrame()->addValue(op.getResult(), hal::mul(ctx_, lhs, rhs));
+  }
+}
+
 #define LOWERED_OP_IMPL(OpName)                                                \
   void PPHloExecutor::execute(mlir::pphlo::OpName &) {                         \
     PPU_THROW("Lowered op should not occur at backend");                       \
@@ -746,7 +893,7 @@ LOWERED_OP_IMPL(DivOp)
 void PPHloExecutor::execute(mlir::pphlo::TransposeOp &op) {
   getCurrentFrame()->addValue(
       op.getResult(), hal::transpose(ctx_, lookupValue(op.getOperand()),
-                                     build_vec_idx<size_t>(op.permutation())));
+                                     indices<size_t>(op.permutation())));
 }
 
 void PPHloExecutor::execute(mlir::pphlo::DotOp &op) {
@@ -755,9 +902,14 @@ void PPHloExecutor::execute(mlir::pphlo::DotOp &op) {
   PPU_ENFORCE(!lhs.empty() && lhs.size() <= 2);
   PPU_ENFORCE(!rhs.empty() && rhs.size() <= 2);
 
-  getCurrentFrame()->addValue(
-      op.getResult(), hal::matmul(ctx_, getCurrentFrame()->getValue(op.lhs()),
-                                  getCurrentFrame()->getValue(op.rhs())));
+  const auto &x = getCurrentFrame()->getValue(op.lhs());
+  const auto &y = getCurrentFrame()->getValue(op.rhs());
+  if (canDeferTrunc(x, y)) {
+    getCurrentFrame()->addLazyValue(op.getResult(),
+                                    hal::matmul_lazy(ctx_, x, y));
+  } else {
+    getCurrentFrame()->addValue(op.getResult(), hal::matmul(ctx_, x, y));
+  }
 }
 
 void PPHloExecutor::execute(mlir::pphlo::BroadcastOp &op) {
@@ -766,7 +918,7 @@ void PPHloExecutor::execute(mlir::pphlo::BroadcastOp &op) {
   getCurrentFrame()->addValue(
       op.getResult(),
       hal::broadcast_to(ctx_, lookupValue(op.getOperand()), to_shape,
-                        build_vec_idx<size_t>(op.broadcast_dimensions())));
+                        indices<size_t>(op.broadcast_dimensions())));
 }
 
 void PPHloExecutor::execute(mlir::pphlo::ReshapeOp &op) {
@@ -847,9 +999,9 @@ void PPHloExecutor::execute(mlir::pphlo::ConcatenateOp &op) {
 void PPHloExecutor::execute(mlir::pphlo::SliceOp &op) {
   getCurrentFrame()->addValue(
       op.getResult(), hal::slice(ctx_, lookupValue(op.getOperand()),
-                                 build_vec_idx<size_t>(op.start_indices()),
-                                 build_vec_idx<size_t>(op.limit_indices()),
-                                 build_vec_idx<size_t>(op.strides())));
+                                 indices<size_t>(op.start_indices()),
+                                 indices<size_t>(op.limit_indices()),
+                                 indices<size_t>(op.strides())));
 }
 
 void PPHloExecutor::execute(mlir::pphlo::DbgPrintOp &op) {
@@ -896,7 +1048,8 @@ void PPHloExecutor::execute(mlir::pphlo::ShiftRightLogicalOp &op) {
   std::vector<int64_t> indicies(rhs.shape().size(), 0);
 
   const auto &lhs = lookupValue(op.lhs());
-  auto result = hal::makeValue(lhs, lhs.dtype());
+  // lhs may be a view shared with other values, write into a private copy.
+  auto result = lhs.clone();
 
   do {
     auto bits = extractShiftBits(rhs.GetElementAt(indicies));
@@ -918,7 +1071,8 @@ void PPHloExecutor::execute(mlir::pphlo::ShiftLeftOp &op) {
   std::vector<int64_t> indicies(rhs.shape().size(), 0);
 
   const auto &lhs = lookupValue(op.lhs());
-  auto result = hal::makeValue(lhs, lhs.dtype());
+  // lhs may be a view shared with other values, write into a private copy.
+  auto result = lhs.clone();
 
   do {
     auto bits = extractShiftBits(rhs.GetElementAt(indicies));
@@ -943,7 +1097,7 @@ void PPHloExecutor::errorUnknownOp(mlir::Operation &op) {
 void PPHloExecutor::execute(mlir::pphlo::ReverseOp &op) {
   getCurrentFrame()->addValue(
       op.getResult(), hal::reverse(ctx_, lookupValue(op.getOperand()),
-                                   build_vec_idx<size_t>(op.dimensions())));
+                                   indices<size_t>(op.dimensions())));
 }
 
 void PPHloExecutor::execute(mlir::pphlo::PadOp &op) {
@@ -952,11 +1106,11 @@ void PPHloExecutor::execute(mlir::pphlo::PadOp &op) {
   const auto &padding_value = lookupValue(op.padding_value());
   PPU_ENFORCE(padding_value.shape().empty());
 
-  auto edge_padding_low = build_vec_idx<size_t>(op.edge_padding_low());
+  auto edge_padding_low = indices<size_t>(op.edge_padding_low());
   PPU_ENFORCE(edge_padding_low.size() == operand_rank);
-  auto edge_padding_high = build_vec_idx<size_t>(op.edge_padding_high());
+  auto edge_padding_high = indices<size_t>(op.edge_padding_high());
   PPU_ENFORCE(edge_padding_high.size() == operand_rank);
-  auto interior_padding = build_vec_idx<size_t>(op.interior_padding());
+  auto interior_padding = indices<size_t>(op.interior_padding());
   PPU_ENFORCE(interior_padding.size() == operand_rank);
 
   getCurrentFrame()->addValue(
@@ -1022,18 +1176,18 @@ void PPHloExecutor::execute(mlir::pphlo::ReduceWindowOp &op) {
   const auto &input = lookupValue(op.inputs());
   const auto &init_val = lookupValue(op.init_values());
 
-  auto window_shape = build_vec_idx<int64_t>(op.window_dimensions());
+  auto window_shape = indices<int64_t>(op.window_dimensions());
 
   // build strides
   std::vector<int64_t> window_strides(window_shape.size(), 1);
   if (op.window_strides().hasValue()) {
-    window_strides = build_vec_idx<int64_t>(*op.window_strides());
+    window_strides = indices<int64_t>(*op.window_strides());
   }
 
   // window dilation
   std::vector<int64_t> window_dilations(window_shape.size(), 1);
   if (op.window_dilations().hasValue()) {
-    window_dilations = build_vec_idx<int64_t>(*op.window_dilations());
+    window_dilations = indices<int64_t>(*op.window_dilations());
   }
 
   // window padding
@@ -1058,7 +1212,7 @@ void PPHloExecutor::execute(mlir::pphlo::ReduceWindowOp &op) {
   // base dilation
   std::vector<int64_t> base_dilation(window_shape.size(), 1);
   if (op.base_dilations().hasValue()) {
-    base_dilation = build_vec_idx<int64_t>(*op.base_dilations());
+    base_dilation = indices<int64_t>(*op.base_dilations());
   }
 
   // For each resulting dimension, calculate and assign computed value.
@@ -1082,11 +1236,13 @@ void PPHloExecutor::execute(mlir::pphlo::ReduceWindowOp &op) {
   // Preallocate result
   auto ret_shape =
       op.getResult().getType().dyn_cast<mlir::RankedTensorType>().getShape();
-  hal::Value ret = hal::broadcast_to(
-      ctx_,
-      hal::make_value(ctx_, input.vtype(),
-                      input.is_int() ? PtBufferView(0) : PtBufferView(0.0F)),
-      build_shape(ret_shape));
+  hal::Value ret =
+      hal::broadcast_to(ctx_,
+                        hal::make_value(ctx_, input.vtype(),
+                                        input.is_int() ? PtBufferView(0)
+                                                       : PtBufferView(0.0F)),
+                        build_shape(ret_shape))
+          .clone();
 
   // For each window index
   auto old_trace = config_.enable_pphlo_trace;
@@ -1121,8 +1277,27 @@ void PPHloExecutor::execute(mlir::pphlo::GatherOp &op) {
   const auto &start_indices_value = reshapedGatherIndices(
       ctx_, dim_numbers.getIndexVectorDim(), lookupValue(op.start_indices()));
 
-  PPU_ENFORCE(start_indices_value.is_public() && start_indices_value.is_int(),
-              "GatherOp start indices must be public integer.");
+  PPU_ENFORCE(start_indices_value.is_int(),
+              "GatherOp start indices must be integer.");
+
+  auto operand_shape =
+      op.operand().getType().dyn_cast<mlir::RankedTensorType>().getShape();
+
+  if (start_indices_value.is_secret()) {
+    // Secret indices can not drive the index iteration below, rewrite row
+    // gathers into an oblivious table lookup.
+    const auto &indices_shape = start_indices_value.shape();
+    PPU_ENFORCE(isRowGather(dim_numbers, operand_shape, op.slice_sizes(),
+                            indices_shape),
+                "GatherOp with secret start indices only supports gathering "
+                "rows of the leading operand dimension.");
+    const auto indices = hal::reshape(
+        ctx_, start_indices_value,
+        std::vector<int64_t>(indices_shape.begin(), indices_shape.end() - 1));
+    getCurrentFrame()->addValue(op.getResult(),
+                                hal::take(ctx_, operand, indices));
+    return;
+  }
 
   auto start_induces =
       hal::test::dump_public_as<int64_t>(ctx_, start_indices_value);
@@ -1138,9 +1313,6 @@ void PPHloExecutor::execute(mlir::pphlo::GatherOp &op) {
 
   // Scratch buffers that hold an index in the output shape and the
   // corresponding index in the input shape.
-  // If input is empty, short circuit it
-  auto operand_shape =
-      op.operand().getType().dyn_cast<mlir::RankedTensorType>().getShape();
   std::vector<int64_t> input_index(operand_shape.size());
   std::vector<int64_t> output_index(output_shape.size());
   std::vector<int64_t> input_index_clamped(operand_shape.size());
@@ -1152,11 +1324,13 @@ void PPHloExecutor::execute(mlir::pphlo::GatherOp &op) {
       dim_numbers, /*input_shape=*/operand_shape,
       /*output_shape=*/output_shape);
 
-  hal::Value result = hal::broadcast_to(
-      ctx_,
-      hal::make_value(ctx_, operand.vtype(),
-                      operand.is_int() ? PtBufferView(0) : PtBufferView(0.0F)),
-      build_shape(output_shape));
+  hal::Value result =
+      hal::broadcast_to(ctx_,
+                        hal::make_value(ctx_, operand.vtype(),
+                                        operand.is_int() ? PtBufferView(0)
+                                                         : PtBufferView(0.0F)),
+                        build_shape(output_shape))
+          .clone();
 
   auto gather_inner_loop_body =
       [&](llvm::ArrayRef<int64_t> output_window_index,
@@ -1226,14 +1400,12 @@ void PPHloExecutor::execute(mlir::pphlo::GatherOp &op) {
 void PPHloExecutor::execute(mlir::pphlo::ConvOp &op) {
   // Restriction 1.
   if (op.lhs_dilation().hasValue()) {
-    const auto lhs_dilation =
-        build_vec_idx<size_t>(op.lhs_dilation().getValue());
+    const auto lhs_dilation = indices<size_t>(op.lhs_dilation().getValue());
     PPU_ENFORCE(std::all_of(lhs_dilation.begin(), lhs_dilation.end(),
                             [](size_t i) { return i == 1; }));
   }
   if (op.rhs_dilation().hasValue()) {
-    const auto rhs_dilation =
-        build_vec_idx<size_t>(op.rhs_dilation().getValue());
+    const auto rhs_dilation = indices<size_t>(op.rhs_dilation().getValue());
     PPU_ENFORCE(std::all_of(rhs_dilation.begin(), rhs_dilation.end(),
                             [](size_t i) { return i == 1; }));
   }
@@ -1244,7 +1416,7 @@ void PPHloExecutor::execute(mlir::pphlo::ConvOp &op) {
 
   std::vector<size_t> window_strides =
       op.window_strides().hasValue()
-          ? build_vec_idx<size_t>(op.window_strides().getValue())
+          ? indices<size_t>(op.window_strides().getValue())
           : std::vector<size_t>(1, 2);
 
   std::vector<std::pair<size_t, size_t>> padding(2, {0, 0});
@@ -1357,15 +1529,56 @@ std::vector<hal::Value> PPHloExecutor::executeTerminator(mlir::Operation &op) {
   llvm_unreachable("Unknown block terminator");
 }
 
+void PPHloExecutor::executeOp(mlir::Operation &op,
+                              PPHloProgram::Handler handler) {
+  // Pre-execution meta
+  if (config_.enable_pphlo_trace) {
+    debug_print(op, true);
+  }
+  const auto op_name = op.getName().getStringRef();
+  PPU_TIMELINE_SCOPE(timeline(), "pphlo",
+                     std::string_view(op_name.data(), op_name.size()));
+
+  ProfileMark mark;
+  if (config_.collect_profiling_data) {
+    mark = profileBegin();
+  }
+
+  // Execute op
+  handler(this, op);
+
+  // Post execution meta
+  if (config_.collect_profiling_data) {
+    profileEnd(op_name.str(), mark);
+  }
+  if (config_.enable_pphlo_trace) {
+    debug_print(op, false);
+  }
+}
+
 std::vector<hal::Value> PPHloExecutor::executeBlock(mlir::Block &block) {
-  for (auto &op : block.without_terminator()) {
-    dispatchOp<
-#define GET_OP_LIST
-#include "ppu/dialect/pphlo_ops.cc.inc"
-        >(op);
+  // blocks out of a program are lowered on the fly.
+  PPHloProgram::Schedule local;
+  const auto *schedule =
+      program_ != nullptr ? program_->getSchedule(&block) : nullptr;
+  if (schedule == nullptr) {
+    local = PPHloProgram::lowerBlock(block);
+    schedule = &local;
+  }
+
+  const bool lazy_trunc = ctx_->rt_config().enable_lazy_truncation();
+  for (const auto &instr : schedule->instrs) {
+    // only linear ops could consume a lazy value.
+    if (lazy_trunc && !instr.linear) {
+      settleLazyOperands(*instr.op);
+    }
+    executeOp(*instr.op, instr.handler);
   }
 
-  if (auto *termOp = block.getTerminator()) {
+  if (auto *termOp = schedule->terminator) {
+    if (lazy_trunc) {
+      settleLazyOperands(*termOp);
+    }
     if (config_.enable_pphlo_trace) {
       debug_print(*termOp, true);
     }
@@ -1405,6 +1618,16 @@ PPHloExecutor::executeModule(mlir::ModuleOp &op,
   return executeFunc(entry_function, inputs);
 }
 
+std::vector<hal::Value>
+PPHloExecutor::executeProgram(const PPHloProgram &program,
+                              llvm::ArrayRef<hal::Value> inputs) {
+  program_ = &program;
+  auto entry_function = program.entry();
+  auto results = executeFunc(entry_function, inputs);
+  program_ = nullptr;
+  return results;
+}
+
 void PPHloExecutor::debug_print(mlir::Operation &op, bool before) const {
   if (before) {
     if (ctx_->lctx() && ctx_->lctx()->Rank() == 0) {
@@ -1423,4 +1646,129 @@ void PPHloExecutor::debug_print(mlir::Operation &op, bool before) const {
   }
 }
 
+Timeline *PPHloExecutor::timeline() const {
+  return ctx_->lctx() ? ctx_->lctx()->GetTimeline().get() : nullptr;
+}
+
+PPHloExecutor::ProfileMark PPHloExecutor::profileBegin() const {
+  return {std::chrono::high_resolution_clock::now(),
+          ctx_->prot()->getCommCost()};
+}
+
+void PPHloExecutor::profileEnd(const std::string &op_name,
+                               const ProfileMark &mark) {
+  const auto end = std::chrono::high_resolution_clock::now();
+  const auto cost = ctx_->prot()->getCommCost();
+
+  const auto duration =
+      std::chrono::duration_cast<std::chrono::duration<double>>(end -
+                                                                mark.time);
+  const auto recv_wait =
+      std::chrono::duration_cast<std::chrono::duration<double>>(
+          cost.recv_wait - mark.cost.recv_wait);
+
+  auto &prof = op_profiling_data_[op_name];
+  ++prof.count;
+  prof.duration += duration;
+  prof.compute_time += std::max(duration - recv_wait,
+                                std::chrono::duration<double>::zero());
+  prof.latency += cost.latency - mark.cost.latency;
+  prof.comm += cost.comm - mark.cost.comm;
+  prof.sent_bytes += cost.sent_bytes - mark.cost.sent_bytes;
+}
+
+PPHloProgram::PPHloProgram(mlir::OwningOpRef<mlir::ModuleOp> module)
+    : module_(std::move(module)) {
+  PPU_ENFORCE(module_, "invalid pphlo module");
+  entry_ = module_->lookupSymbol<mlir::FuncOp>("main");
+  PPU_ENFORCE(entry_);
+
+  entry_.walk([&](mlir::Operation *op) {
+    for (auto &region : op->getRegions()) {
+      for (auto &block : region) {
+        schedules_.try_emplace(&block, lowerBlock(block));
+      }
+    }
+    decodeIndices(*op);
+  });
+}
+
+const PPHloProgram::Schedule *
+PPHloProgram::getSchedule(mlir::Block *block) const {
+  const auto iter = schedules_.find(block);
+  return iter == schedules_.end() ? nullptr : &iter->second;
+}
+
+const std::vector<int64_t> *
+PPHloProgram::getIndices(mlir::Attribute attr) const {
+  const auto iter = indices_.find(attr);
+  return iter == indices_.end() ? nullptr : &iter->second;
+}
+
+PPHloProgram::Schedule PPHloProgram::lowerBlock(mlir::Block &block) {
+  Schedule schedule;
+  for (auto &op : block.without_terminator()) {
+    const auto handler = PPHloExecutor::resolveHandler<
+#define GET_OP_LIST
+#include "ppu/dialect/pphlo_ops.cc.inc"
+        >(op);
+    const bool linear =
+        llvm::isa<mlir::pphlo::AddOp, mlir::pphlo::SubOp, mlir::pphlo::NegOp>(
+            op);
+    schedule.instrs.push_back({&op, handler, linear});
+  }
+  schedule.terminator = block.getTerminator();
+  return schedule;
+}
+
+void PPHloProgram::decodeIndices(mlir::Operation &op) {
+  // attributes are uniqued by the context, identical ones are decoded once.
+  auto decode = [&](mlir::DenseIntElementsAttr attr) {
+    if (attr && indices_.count(attr) == 0) {
+      indices_.try_emplace(attr, build_vec_idx<int64_t>(attr));
+    }
+  };
+
+  llvm::TypeSwitch<mlir::Operation *>(&op)
+      .Case<mlir::pphlo::TransposeOp>(
+          [&](auto casted) { decode(casted.permutation()); })
+      .Case<mlir::pphlo::BroadcastOp>(
+          [&](auto casted) { decode(casted.broadcast_dimensions()); })
+      .Case<mlir::pphlo::ReduceOp, mlir::pphlo::ReverseOp>(
+          [&](auto casted) { decode(casted.dimensions()); })
+      .Case<mlir::pphlo::SliceOp>([&](auto casted) {
+        decode(casted.start_indices());
+        decode(casted.limit_indices());
+        decode(casted.strides());
+      })
+      .Case<mlir::pphlo::PadOp>([&](auto casted) {
+        decode(casted.edge_padding_low());
+        decode(casted.edge_padding_high());
+        decode(casted.interior_padding());
+      })
+      .Case<mlir::pphlo::ReduceWindowOp>([&](auto casted) {
+        decode(casted.window_dimensions());
+        if (auto strides = casted.window_strides()) {
+          decode(*strides);
+        }
+        if (auto dilations = casted.window_dilations()) {
+          decode(*dilations);
+        }
+        if (auto dilations = casted.base_dilations()) {
+          decode(*dilations);
+        }
+      })
+      .Case<mlir::pphlo::ConvOp>([&](auto casted) {
+        if (auto strides = casted.window_strides()) {
+          decode(*strides);
+        }
+        if (auto dilation = casted.lhs_dilation()) {
+          decode(*dilation);
+        }
+        if (auto dilation = casted.rhs_dilation()) {
+          decode(*dilation);
+        }
+      });
+}
+
 } // namespace ppu::device
@@ -19,11 +19,14 @@
 #include <deque>
 #include <unordered_map>
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
 
 #include "ppu/dialect/pphlo_ops.h"
 #include "ppu/hal/value.h"
+#include "ppu/mpc/object.h"
 
 namespace ppu {
 
@@ -32,6 +35,7 @@ class HalContext;
 namespace device {
 
 class Frame;
+class PPHloExecutor;
 
 // PPHlo executor can modify this config on the fly, so here we make a partial
 // copy of protbuf runtime config
@@ -41,7 +45,72 @@ struct PPHloExecutorConfig {
   bool collect_profiling_data;
 };
 
+// Accumulated profiling data of one kind of op. Ops with regions (while, if)
+// include the cost of their nested ops.
+struct OpProfile {
+  uint64_t count = 0;
+
+  // Wall time.
+  std::chrono::duration<double> duration{0};
+
+  // Wall time minus the time blocked on receiving from peers.
+  std::chrono::duration<double> compute_time{0};
+
+  // Communication rounds and bytes, see mpc::CommCost.
+  size_t latency = 0;
+  size_t comm = 0;
+  size_t sent_bytes = 0;
+};
+
+// A pphlo module lowered ahead of time, shared by all runs of an executable.
+// Every block is flattened into a schedule with the op handlers resolved, and
+// index attributes (permutations, slice bounds, windows...) are decoded once,
+// so a run neither walks the dyn_cast dispatch chain nor re-parses attributes.
+// It is read only once built, concurrent executors may share it.
+//
+// Note: the schedule still points into the parsed module, handlers take the
+// mlir::Operation and operands are looked up by mlir::Value, so a program is
+// in-memory only and can not be serialized or cached on disk.
+class PPHloProgram {
+public:
+  using Handler = void (*)(PPHloExecutor *, mlir::Operation &);
+
+  struct Instr {
+    mlir::Operation *op;
+    Handler handler;
+    // Whether the op is linear, i.e. may consume a lazily truncated operand.
+    bool linear;
+  };
+
+  struct Schedule {
+    std::vector<Instr> instrs;
+    mlir::Operation *terminator = nullptr;
+  };
+
+  explicit PPHloProgram(mlir::OwningOpRef<mlir::ModuleOp> module);
+
+  mlir::FuncOp entry() const { return entry_; }
+
+  // Return nullptr if the block is not part of this program.
+  const Schedule *getSchedule(mlir::Block *block) const;
+
+  // Return nullptr if the attribute was not decoded ahead of time.
+  const std::vector<int64_t> *getIndices(mlir::Attribute attr) const;
+
+  static Schedule lowerBlock(mlir::Block &block);
+
+private:
+  void decodeIndices(mlir::Operation &op);
+
+  mlir::OwningOpRef<mlir::ModuleOp> module_;
+  mlir::FuncOp entry_;
+  llvm::DenseMap<mlir::Block *, Schedule> schedules_;
+  llvm::DenseMap<mlir::Attribute, std::vector<int64_t>> indices_;
+};
+
 class PPHloExecutor {
+  friend class PPHloProgram;
+
 public:
   explicit PPHloExecutor(HalContext *ctx, PPHloExecutorConfig config)
       : ctx_(ctx), config_(config) {}
@@ -49,6 +118,9 @@ public:
   std::vector<hal::Value> executeModule(mlir::ModuleOp &op,
                                         llvm::ArrayRef<hal::Value> inputs);
 
+  std::vector<hal::Value> executeProgram(const PPHloProgram &program,
+                                         llvm::ArrayRef<hal::Value> inputs);
+
   std::vector<hal::Value> executeRegion(mlir::Region &region,
                                         llvm::ArrayRef<hal::Value> inputs);
 
@@ -64,49 +136,28 @@ private:
 
   void debug_print(mlir::Operation &op, bool before_execution) const;
 
+  template <typename OpT>
+  static void invoke(PPHloExecutor *self, mlir::Operation &op) {
+    auto casted = llvm::cast<OpT>(op);
+    self->execute(casted);
+  }
+
   template <typename OpT, typename... MoreOpT>
-  void dispatchOp(mlir::Operation &op) {
-    if (auto casted = llvm::dyn_cast<OpT>(op)) {
-      // Pre-execution meta
-      if (config_.enable_pphlo_trace) {
-        debug_print(op, true);
-      }
-      std::chrono::high_resolution_clock::time_point s;
-      if (config_.collect_profiling_data) {
-        s = std::chrono::high_resolution_clock::now();
-      }
-
-      // Execute op
-      execute(casted);
-
-      // Post execution meta
-      if (config_.collect_profiling_data) {
-        auto e = std::chrono::high_resolution_clock::now();
-        auto opName = op.getName().getIdentifier().str();
-        auto duration =
-            std::chrono::duration_cast<std::chrono::duration<double>>(e - s);
-        auto iter = op_profiling_data_.find(opName);
-        if (iter == op_profiling_data_.end()) {
-          op_profiling_data_.emplace(opName, std::make_pair(1, duration));
-        } else {
-          ++iter->second.first;
-          iter->second.second += duration;
-        }
-      }
-      if (config_.enable_pphlo_trace) {
-        debug_print(op, false);
-      }
+  static PPHloProgram::Handler resolveHandler(mlir::Operation &op) {
+    if (llvm::isa<OpT>(op)) {
+      return &invoke<OpT>;
+    }
+    if constexpr (!sizeof...(MoreOpT)) {
+      // If there is no more op types to dispatch, and the previous cast
+      // fails..print error message
+      errorUnknownOp(op);
     } else {
-      if constexpr (!sizeof...(MoreOpT)) {
-        // If there is no more op types to dispatch, and the previous cast
-        // fails..print error message
-        errorUnknownOp(op);
-      } else {
-        dispatchOp<MoreOpT...>(op);
-      }
+      return resolveHandler<MoreOpT...>(op);
     }
   }
 
+  void executeOp(mlir::Operation &op, PPHloProgram::Handler handler);
+
   /// Unary ops
   void execute(mlir::pphlo::ReciprocalOp &op);
   void execute(mlir::pphlo::NegOp &op);
@@ -184,25 +235,50 @@ private:
   void execute(mlir::pphlo::LessEqualOp &op);
   void execute(mlir::pphlo::GreaterEqualOp &op);
   void execute(mlir::pphlo::DivOp &op);
-  void errorUnknownOp(mlir::Operation &op);
+  [[noreturn]] static void errorUnknownOp(mlir::Operation &op);
 
   void executeVReduce(mlir::pphlo::ReduceOp &op);
+  std::vector<hal::Value> executeObliviousWhile(mlir::pphlo::WhileOp &op,
+                                                std::vector<hal::Value> inputs,
+                                                hal::Value active);
 
   Frame *getCurrentFrame() const { return frames_.back(); }
 
   const hal::Value &lookupValue(::mlir::Value v) const;
+
+  // Index attribute, decoded by the program if possible.
+  template <typename T>
+  std::vector<T> indices(const mlir::DenseIntElementsAttr &attr) const;
+
+  // Lazy truncation, see RuntimeConfig.enable_lazy_truncation.
+  bool canDeferTrunc(const hal::Value &x, const hal::Value &y) const;
+  bool isLazyValue(::mlir::Value v) const;
+  void settleLazyOperands(mlir::Operation &op);
+  void executeLinear(::mlir::Value result, ::mlir::Value lhs,
+                     ::mlir::Value rhs,
+                     hal::Value (*fn)(HalContext *, const hal::Value &,
+                                      const hal::Value &));
   size_t extractShiftBits(const hal::Value &op) const;
   bool getConditionValue(const hal::Value &v) const;
 
+  Timeline *timeline() const;
+
+  struct ProfileMark {
+    std::chrono::high_resolution_clock::time_point time;
+    mpc::CommCost cost;
+  };
+
+  ProfileMark profileBegin() const;
+  void profileEnd(const std::string &op_name, const ProfileMark &mark);
+
   HalContext *ctx_{nullptr};
+  const PPHloProgram *program_{nullptr};
   std::deque<Frame *> frames_;
   mlir::pphlo::TypeTools type_tools_;
   PPHloExecutorConfig config_;
 
   // Profiling thingy
-  std::unordered_map<std::string,
-                     std::pair<uint64_t, std::chrono::duration<double>>>
-      op_profiling_data_;
+  std::unordered_map<std::string, OpProfile> op_profiling_data_;
 };
 
 } // namespace device
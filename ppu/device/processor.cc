@@ -16,7 +16,9 @@
 #include "ppu/device/processor.h"
 
 #include <chrono>
+#include <exception>
 #include <fstream>
+#include <future>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -47,6 +49,9 @@ namespace ppu::device {
 
 static std::mutex ErrorHandlerMutex;
 
+// default of RuntimeConfig.max_cached_programs.
+constexpr size_t kDefaultMaxPrograms = 64;
+
 Processor::Processor(RuntimeConfig config, std::shared_ptr<link::Context> lctx)
     : rt_config_(config), lctx_(lctx) {
   // Set an error handler
@@ -74,6 +79,98 @@ void Processor::run(const ExecutableProto &exec) { runWithEnv(exec, getEnv()); }
 
 void Processor::runWithEnv(const ExecutableProto &exec,
                            SymbolTable *sym_table) {
+  execute(hal_ctx_.get(), exec, sym_table);
+}
+
+void Processor::runConcurrently(const std::vector<ExecutableProto> &execs,
+                                const std::vector<SymbolTable *> &sym_tables) {
+  PPU_ENFORCE(execs.size() == sym_tables.size(),
+              "num of executables={} and environments={} mismatch",
+              execs.size(), sym_tables.size());
+
+  std::vector<Session *> sessions;
+  {
+    std::lock_guard<std::mutex> guard(sessions_mutex_);
+    // sub-contexts are named by spawn order, spawn in session order so that
+    // session i pairs up with session i of the other parties.
+    while (sessions_.size() < execs.size()) {
+      auto session = std::make_unique<Session>();
+      session->lctx = lctx_->Spawn();
+      // the parent timeline is dumped and cleared by other runs.
+      session->lctx->SetTimeline(
+          std::make_shared<Timeline>(session->lctx->Rank()));
+      session->hctx = std::make_unique<HalContext>(rt_config_, session->lctx);
+      sessions_.push_back(std::move(session));
+    }
+    for (size_t idx = 0; idx < execs.size(); idx++) {
+      sessions.push_back(sessions_[idx].get());
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t idx = 0; idx < execs.size(); idx++) {
+    futures.push_back(std::async(std::launch::async, [&, idx] {
+      execute(sessions[idx]->hctx.get(), execs[idx], sym_tables[idx],
+              fmt::format("_session{}", idx));
+    }));
+  }
+
+  std::exception_ptr error;
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+size_t Processor::numSessions() {
+  std::lock_guard<std::mutex> guard(sessions_mutex_);
+  return sessions_.size();
+}
+
+void Processor::compile(const ExecutableProto &exec) { getProgram(exec); }
+
+size_t Processor::numPrograms() {
+  std::lock_guard<std::mutex> guard(programs_mutex_);
+  return programs_lru_.size();
+}
+
+std::shared_ptr<const PPHloProgram>
+Processor::getProgram(const ExecutableProto &exec) {
+  std::lock_guard<std::mutex> guard(programs_mutex_);
+  auto iter = programs_.find(exec.code());
+  if (iter != programs_.end()) {
+    programs_lru_.splice(programs_lru_.end(), programs_lru_, iter->second);
+    return iter->second->second;
+  }
+
+  auto program = std::make_shared<PPHloProgram>(
+      mlir::parseSourceString(exec.code(), mlir_context_.get()));
+  programs_lru_.emplace_back(exec.code(), program);
+  programs_.emplace(programs_lru_.back().first, std::prev(programs_lru_.end()));
+
+  // runs in flight keep evicted programs alive through their shared_ptr.
+  const size_t max_programs = rt_config_.max_cached_programs() > 0
+                                  ? rt_config_.max_cached_programs()
+                                  : kDefaultMaxPrograms;
+  while (programs_lru_.size() > max_programs) {
+    programs_.erase(programs_lru_.front().first);
+    programs_lru_.pop_front();
+  }
+  return program;
+}
+
+void Processor::execute(HalContext *hctx, const ExecutableProto &exec,
+                        SymbolTable *sym_table,
+                        const std::string &timeline_suffix) {
+  const auto &lctx = hctx->lctx();
   // Profile: start stamp
   auto start = std::chrono::high_resolution_clock::now();
   // Process inputs
@@ -95,7 +192,7 @@ void Processor::runWithEnv(const ExecutableProto &exec,
     std::filesystem::path dump_folder = rt_config_.processor_dump_dir();
     {
       auto fname = fmt::format("{}/exec_{}_{}.txt", dump_folder, exec.name(),
-                               lctx_->Rank());
+                               lctx->Rank());
       std::ofstream ir_file(fname, std::ios::binary);
       ir_file << exec.SerializeAsString();
     }
@@ -104,14 +201,13 @@ void Processor::runWithEnv(const ExecutableProto &exec,
     for (const auto &val : inputs) {
       std::ofstream inputs_file(
           dump_folder /
-              (fmt::format("processor{}{}.txt", lctx_->Rank(), var_counter++)),
+              (fmt::format("processor{}{}.txt", lctx->Rank(), var_counter++)),
           std::ios::binary);
       inputs_file << val.toProto().SerializeAsString();
     }
   }
 
-  auto module = mlir::parseSourceString(exec.code(), mlir_context_.get());
-  auto moduleOp = module.get();
+  const auto program = getProgram(exec);
 
   PPHloExecutorConfig config{};
   config.enable_pphlo_trace = rt_config_.enable_pphlo_trace();
@@ -120,8 +216,8 @@ void Processor::runWithEnv(const ExecutableProto &exec,
 
   // Profile: before execution stamp
   auto exec_start = std::chrono::high_resolution_clock::now();
-  PPHloExecutor executor(hal_ctx_.get(), config);
-  auto outputs = executor.executeModule(moduleOp, inputs);
+  PPHloExecutor executor(hctx, config);
+  auto outputs = executor.executeProgram(*program, inputs);
 
   // Profile: after execution stamp
   auto exec_end = std::chrono::high_resolution_clock::now();
@@ -158,9 +254,33 @@ void Processor::runWithEnv(const ExecutableProto &exec,
     SPDLOG_INFO("Detailed operation profiling data:");
     const auto &data = executor.getOpProfilingData();
     for (const auto &[name, meta] : data) {
-      SPDLOG_INFO("Operation {}, executed {} times, duration {}s", name,
-                  meta.first, meta.second.count());
+      SPDLOG_INFO("Operation {}, executed {} times, duration {}s, compute {}s, "
+                  "latency {}, comm {} bytes, sent {} bytes",
+                  name, meta.count, meta.duration.count(),
+                  meta.compute_time.count(), meta.latency, meta.comm,
+                  meta.sent_bytes);
     }
+
+    SPDLOG_INFO("Detailed kernel profiling data:");
+    for (const auto &[name, prof] : hctx->prot()->getProfiles()) {
+      SPDLOG_INFO("Kernel {}, executed {} times, duration {}s, compute {}s, "
+                  "latency {}, comm {} bytes, sent {} bytes",
+                  name, prof.num_calls,
+                  std::chrono::duration<double>(prof.wall_time).count(),
+                  std::chrono::duration<double>(prof.compute_time).count(),
+                  prof.latency, prof.comm, prof.sent_bytes);
+    }
+    hctx->prot()->resetProfiles();
+  }
+
+  if (rt_config_.enable_timeline()) {
+    auto timeline = lctx->GetTimeline();
+    std::filesystem::path dump_folder = rt_config_.timeline_dump_dir();
+    timeline->dumpChromeTrace(
+        dump_folder /
+        fmt::format("timeline_{}_{}{}.json", exec.name(), lctx->Rank(),
+                    timeline_suffix));
+    timeline->clear();
   }
 }
 
@@ -184,6 +304,18 @@ const std::string &Processor::getVar(const std::string &name) const {
   return sym_table_.getVar(name);
 }
 
+void Processor::setVarChunk(const std::string &name,
+                            const std::string &chunk) {
+  ValueChunkProto chunk_pb;
+  PPU_ENFORCE(chunk_pb.ParseFromString(chunk));
+  sym_table_.setVarChunk(name, chunk_pb);
+}
+
+std::string Processor::getVarChunk(const std::string &name, int64_t row_begin,
+                                   int64_t row_end) const {
+  return sym_table_.getVarChunk(name, row_begin, row_end).SerializeAsString();
+}
+
 void Processor::clearVars() { sym_table_.clear(); }
 
 } // namespace ppu::device
@@ -16,8 +16,14 @@
 #pragma once
 
 #include <filesystem>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "mlir/IR/MLIRContext.h"
 
@@ -30,6 +36,8 @@
 
 namespace ppu::device {
 
+class PPHloProgram;
+
 class Processor final {
   const RuntimeConfig rt_config_;
 
@@ -41,6 +49,33 @@ class Processor final {
 
   std::unique_ptr<mlir::MLIRContext> mlir_context_;
 
+  // An execution slot of runConcurrently, a link sub-context with protocol
+  // states and timeline of its own.
+  struct Session {
+    std::shared_ptr<link::Context> lctx;
+    std::unique_ptr<HalContext> hctx;
+  };
+
+  std::mutex sessions_mutex_;
+  std::vector<std::unique_ptr<Session>> sessions_;
+
+  // Executables lowered ahead of time, keyed by code, least recently used
+  // first and capped by RuntimeConfig.max_cached_programs. Declared after
+  // mlir_context_ which owns their modules.
+  using ProgramEntry =
+      std::pair<std::string, std::shared_ptr<const PPHloProgram>>;
+  std::mutex programs_mutex_;
+  std::list<ProgramEntry> programs_lru_;
+  std::unordered_map<std::string_view, std::list<ProgramEntry>::iterator>
+      programs_;
+
+  std::shared_ptr<const PPHloProgram> getProgram(const ExecutableProto &exec);
+
+  // `timeline_suffix` tells apart the timeline dumps of concurrent runs.
+  void execute(HalContext *hctx, const ExecutableProto &exec,
+               SymbolTable *sym_table,
+               const std::string &timeline_suffix = "");
+
 public:
   explicit Processor(RuntimeConfig config, std::shared_ptr<link::Context> lctx);
   ~Processor();
@@ -62,6 +97,28 @@ public:
   /// Evaluate a ppu executable with given environment.
   void runWithEnv(const ExecutableProto &exec, SymbolTable *sym_table);
 
+  /// Evaluate several executables concurrently, each with its own
+  /// environment.
+  ///
+  /// The i-th executable runs on session i, a link sub-context spawned from
+  /// lctx() with independent PRG/beaver states. Sessions are created on first
+  /// use, in order, and reused by later calls, so all parties should call it
+  /// with the same number of executables. Errors are rethrown once all runs
+  /// finished.
+  void runConcurrently(const std::vector<ExecutableProto> &execs,
+                       const std::vector<SymbolTable *> &sym_tables);
+
+  /// Number of sessions created by runConcurrently.
+  size_t numSessions();
+
+  /// Lower an executable ahead of its first run. Runs lower on demand too,
+  /// either way the code is parsed and lowered once while it stays among the
+  /// RuntimeConfig.max_cached_programs most recently run executables.
+  void compile(const ExecutableProto &exec);
+
+  /// Number of executables kept lowered.
+  size_t numPrograms();
+
   /// Evaluate a PPHlo code(function) on default environment, with given
   /// input/output name bindings.
   void run(const std::string &pphlo,
@@ -72,6 +129,15 @@ public:
 
   const std::string &getVar(const std::string &name) const;
 
+  /// Streaming infeed, add a row-block (serialized ValueChunkProto) of a
+  /// variable, it becomes visible once all rows arrived.
+  void setVarChunk(const std::string &name, const std::string &chunk);
+
+  /// Streaming outfeed, get rows [row_begin, row_end) of a variable as a
+  /// serialized ValueChunkProto.
+  std::string getVarChunk(const std::string &name, int64_t row_begin,
+                          int64_t row_end) const;
+
   void clearVars();
 };
 
@@ -16,6 +16,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
 #include <future>
 #include <limits>
 #include <memory>
@@ -94,6 +95,15 @@ public:
     verifyOutput(&expected, idx);
   }
 
+  // Secret fixed-point truncation may be off by a few LSBs.
+  void verifyScalarOutputNear(float expected, float abs_error,
+                              size_t idx = 0) {
+    const auto &out =
+        io_->OutFeed(fmt::format("output{}", idx), PtType::PT_F32);
+    ASSERT_EQ(out.numel(), 1);
+    EXPECT_NEAR(*static_cast<const float *>(out.data()), expected, abs_error);
+  }
+
 private:
   size_t world_size_;
   RuntimeConfig config_;
@@ -122,6 +132,159 @@ func @main(%arg0: tensor<!pphlo.pint>, %arg1: tensor<!pphlo.pint>) -> (tensor<!p
   r.verifyScalarOutput(3);
 }
 
+TEST_P(ProcessorTest, RunConcurrently) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+  constexpr size_t kNumRuns = 3;
+
+  RuntimeConfig config;
+  config.set_field(std::get<1>(GetParam()));
+  config.set_protocol(std::get<2>(GetParam()));
+
+  // every session dumps a timeline of its own.
+  const auto timeline_dir =
+      std::filesystem::temp_directory_path() /
+      fmt::format("ppu_run_concurrently_{}_{}_{}", kWorldSize,
+                  FieldType_Name(config.field()),
+                  ProtocolKind_Name(config.protocol()));
+  std::filesystem::create_directories(timeline_dir);
+  config.set_enable_timeline(true);
+  config.set_timeline_dump_dir(timeline_dir.string());
+
+  ExecutableProto exec;
+  exec.set_name("mul");
+  exec.add_input_names("x");
+  exec.add_input_names("y");
+  exec.add_output_names("z");
+  exec.set_code(R"(
+func @main(%arg0: tensor<2x2x!pphlo.sint>, %arg1: tensor<2x2x!pphlo.sint>) -> (tensor<2x2x!pphlo.sint>) {
+  %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<2x2x!pphlo.sint>, tensor<2x2x!pphlo.sint>) -> tensor<2x2x!pphlo.sint>
+  return %0 : tensor<2x2x!pphlo.sint>
+})");
+
+  // each run has its own inputs and environment.
+  std::vector<std::unique_ptr<LocalIo>> ios;
+  std::vector<std::array<int, 4>> expected;
+  for (size_t idx = 0; idx < kNumRuns; idx++) {
+    const int base = static_cast<int>(idx) + 1;
+    const std::array<int, 4> x = {base, -base, 2 * base, 3};
+    const std::array<int, 4> y = {4, 5, -base, 7 * base};
+    ios.push_back(std::make_unique<LocalIo>(kWorldSize, config));
+    ios.back()->InFeed("x", PtBufferView(x.data(), PT_I32, {2, 2}, {2, 1}),
+                       Visibility::VIS_SECRET);
+    ios.back()->InFeed("y", PtBufferView(y.data(), PT_I32, {2, 2}, {2, 1}),
+                       Visibility::VIS_SECRET);
+    expected.push_back({x[0] * y[0], x[1] * y[1], x[2] * y[2], x[3] * y[3]});
+  }
+
+  ::ppu::mpc::util::simulate(
+      kWorldSize, [&](const std::shared_ptr<link::Context> &lctx) {
+        Processor processor(config, lctx);
+        std::vector<ExecutableProto> execs(kNumRuns, exec);
+        std::vector<SymbolTable *> envs;
+        for (auto &io : ios) {
+          envs.push_back(io->GetSymbolTable(lctx->Rank()));
+        }
+
+        processor.runConcurrently(execs, envs);
+        // sessions are reused.
+        processor.runConcurrently(execs, envs);
+        EXPECT_EQ(processor.numSessions(), kNumRuns);
+
+        // the default session still works.
+        processor.runWithEnv(exec, envs[0]);
+      });
+
+  for (size_t idx = 0; idx < kNumRuns; idx++) {
+    auto out = ios[idx]->OutFeed("z", PtType::PT_I32);
+    ASSERT_EQ(out.numel(), 4);
+    const auto *out_ptr = static_cast<const int *>(out.data());
+    for (size_t pos = 0; pos < 4; pos++) {
+      EXPECT_EQ(out_ptr[pos], expected[idx][pos]) << "run " << idx;
+    }
+  }
+
+  for (size_t rank = 0; rank < kWorldSize; rank++) {
+    for (size_t idx = 0; idx < kNumRuns; idx++) {
+      EXPECT_TRUE(std::filesystem::exists(
+          timeline_dir /
+          fmt::format("timeline_mul_{}_session{}.json", rank, idx)));
+    }
+  }
+  std::filesystem::remove_all(timeline_dir);
+}
+
+TEST_P(ProcessorTest, CompileAhead) {
+  const size_t kWorldSize = std::get<0>(GetParam());
+
+  RuntimeConfig config;
+  config.set_field(std::get<1>(GetParam()));
+  config.set_protocol(std::get<2>(GetParam()));
+
+  ExecutableProto exec;
+  exec.add_input_names("x");
+  exec.add_output_names("y");
+  exec.set_code(R"(
+func @main(%arg0: tensor<2x3x!pphlo.sint>) -> (tensor<2x2x!pphlo.sint>) {
+  %0 = "pphlo.transpose"(%arg0) {permutation = dense<[1, 0]> : tensor<2xi64>} : (tensor<2x3x!pphlo.sint>) -> tensor<3x2x!pphlo.sint>
+  %1 = "pphlo.slice"(%0) {limit_indices = dense<[3, 2]> : tensor<2xi64>, start_indices = dense<[1, 0]> : tensor<2xi64>, strides = dense<[1, 1]> : tensor<2xi64>} : (tensor<3x2x!pphlo.sint>) -> tensor<2x2x!pphlo.sint>
+  return %1 : tensor<2x2x!pphlo.sint>
+})");
+
+  // the same executable runs twice on different inputs.
+  std::vector<std::unique_ptr<LocalIo>> ios;
+  for (int base : {0, 10}) {
+    const std::array<int, 6> x = {base,     base + 1, base + 2,
+                                  base + 3, base + 4, base + 5};
+    ios.push_back(std::make_unique<LocalIo>(kWorldSize, config));
+    ios.back()->InFeed("x", PtBufferView(x.data(), PT_I32, {2, 3}, {3, 1}),
+                       Visibility::VIS_SECRET);
+  }
+
+  ::ppu::mpc::util::simulate(
+      kWorldSize, [&](const std::shared_ptr<link::Context> &lctx) {
+        Processor processor(config, lctx);
+        processor.compile(exec);
+        for (auto &io : ios) {
+          processor.runWithEnv(exec, io->GetSymbolTable(lctx->Rank()));
+        }
+        // parsed and lowered only once.
+        EXPECT_EQ(processor.numPrograms(), 1U);
+      });
+
+  // the least recently run executable is dropped beyond the cap, and lowered
+  // again on its next run.
+  config.set_max_cached_programs(1);
+  ExecutableProto other = exec;
+  other.set_code(R"(
+func @main(%arg0: tensor<2x3x!pphlo.sint>) -> (tensor<2x2x!pphlo.sint>) {
+  %0 = "pphlo.slice"(%arg0) {limit_indices = dense<[2, 2]> : tensor<2xi64>, start_indices = dense<[0, 0]> : tensor<2xi64>, strides = dense<[1, 1]> : tensor<2xi64>} : (tensor<2x3x!pphlo.sint>) -> tensor<2x2x!pphlo.sint>
+  return %0 : tensor<2x2x!pphlo.sint>
+})");
+  ::ppu::mpc::util::simulate(
+      kWorldSize, [&](const std::shared_ptr<link::Context> &lctx) {
+        Processor processor(config, lctx);
+        processor.compile(other);
+        processor.compile(exec);
+        EXPECT_EQ(processor.numPrograms(), 1U);
+        for (auto &io : ios) {
+          processor.runWithEnv(exec, io->GetSymbolTable(lctx->Rank()));
+        }
+        EXPECT_EQ(processor.numPrograms(), 1U);
+      });
+
+  for (size_t idx = 0; idx < ios.size(); idx++) {
+    const int base = static_cast<int>(idx) * 10;
+    auto out = ios[idx]->OutFeed("y", PtType::PT_I32);
+    ASSERT_EQ(out.numel(), 4);
+    const auto *out_ptr = static_cast<const int *>(out.data());
+    const std::array<int, 4> expected = {base + 1, base + 4, base + 2,
+                                         base + 5};
+    for (size_t pos = 0; pos < 4; pos++) {
+      EXPECT_EQ(out_ptr[pos], expected[pos]) << "run " << idx;
+    }
+  }
+}
+
 TEST_P(ProcessorTest, WithConst) {
   Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
            std::get<2>(GetParam()));
@@ -263,6 +426,149 @@ func @main(%arg0: tensor<!pphlo.pint>, %arg1: tensor<!pphlo.pint>) -> tensor<!pp
   r.verifyScalarOutput(3);
 }
 
+TEST_P(ProcessorTest, WhileWithSecretCond) {
+  // while(x < 3) { x = x + 1; y = y + y; }
+  const auto *prog = R"(
+func @main(%arg0: tensor<!pphlo.sint>, %arg1: tensor<!pphlo.sfxp>) -> (tensor<!pphlo.sint>, tensor<!pphlo.sfxp>) {
+  %0, %1 = "pphlo.while"(%arg0, %arg1) ( {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.sfxp>):  // no predecessors
+    %2 = "pphlo.constant"() {value = dense<3> : tensor<i64>} : () -> tensor<!pphlo.pint>
+    %3 = "pphlo.less"(%arg2, %2) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    "pphlo.return"(%3) : (tensor<!pphlo.sint>) -> ()
+  },  {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.sfxp>):  // no predecessors
+    %2 = "pphlo.constant"() {value = dense<1> : tensor<i64>} : () -> tensor<!pphlo.pint>
+    %3 = "pphlo.add"(%arg2, %2) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    %4 = "pphlo.add"(%arg3, %arg3) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+    "pphlo.return"(%3, %4) : (tensor<!pphlo.sint>, tensor<!pphlo.sfxp>) -> ()
+  }) : (tensor<!pphlo.sint>, tensor<!pphlo.sfxp>) -> (tensor<!pphlo.sint>, tensor<!pphlo.sfxp>)
+  return %0, %1 : tensor<!pphlo.sint>, tensor<!pphlo.sfxp>
+})";
+
+  // default
+  {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+
+    r.addInput(1, VIS_SECRET);
+    r.addInput(1.5F, VIS_SECRET);
+
+    EXPECT_THROW(r.run(prog, 2), EnforceNotMet);
+  }
+  // oblivious
+  {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+
+    r.getConfig().set_oblivious_while_max_iters(5);
+
+    r.addInput(1, VIS_SECRET);
+    r.addInput(1.5F, VIS_SECRET);
+
+    r.run(prog, 2);
+
+    r.verifyScalarOutput(3, 0);
+    r.verifyScalarOutput(6.0F, 1);
+  }
+}
+
+TEST_P(ProcessorTest, WhileWithSecretCondPublicCarry) {
+  // while(x < y) { x = x + 1; }, y is public and never updated.
+  const auto *invariant = R"(
+func @main(%arg0: tensor<!pphlo.sint>, %arg1: tensor<!pphlo.pint>) -> (tensor<!pphlo.sint>, tensor<!pphlo.pint>) {
+  %0, %1 = "pphlo.while"(%arg0, %arg1) ( {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.pint>):  // no predecessors
+    %2 = "pphlo.less"(%arg2, %arg3) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    "pphlo.return"(%2) : (tensor<!pphlo.sint>) -> ()
+  },  {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.pint>):  // no predecessors
+    %2 = "pphlo.constant"() {value = dense<1> : tensor<i64>} : () -> tensor<!pphlo.pint>
+    %3 = "pphlo.add"(%arg2, %2) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    "pphlo.return"(%3, %arg3) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> ()
+  }) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> (tensor<!pphlo.sint>, tensor<!pphlo.pint>)
+  return %0, %1 : tensor<!pphlo.sint>, tensor<!pphlo.pint>
+})";
+
+  // while(x < 3) { x = x + 1; n = n + 1; }, n is public but updated.
+  const auto *updated = R"(
+func @main(%arg0: tensor<!pphlo.sint>, %arg1: tensor<!pphlo.pint>) -> (tensor<!pphlo.sint>, tensor<!pphlo.pint>) {
+  %0, %1 = "pphlo.while"(%arg0, %arg1) ( {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.pint>):  // no predecessors
+    %2 = "pphlo.constant"() {value = dense<3> : tensor<i64>} : () -> tensor<!pphlo.pint>
+    %3 = "pphlo.less"(%arg2, %2) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    "pphlo.return"(%3) : (tensor<!pphlo.sint>) -> ()
+  },  {
+  ^bb0(%arg2: tensor<!pphlo.sint>, %arg3: tensor<!pphlo.pint>):  // no predecessors
+    %2 = "pphlo.constant"() {value = dense<1> : tensor<i64>} : () -> tensor<!pphlo.pint>
+    %3 = "pphlo.add"(%arg2, %2) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> tensor<!pphlo.sint>
+    %4 = "pphlo.add"(%arg3, %2) : (tensor<!pphlo.pint>, tensor<!pphlo.pint>) -> tensor<!pphlo.pint>
+    "pphlo.return"(%3, %4) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> ()
+  }) : (tensor<!pphlo.sint>, tensor<!pphlo.pint>) -> (tensor<!pphlo.sint>, tensor<!pphlo.pint>)
+  return %0, %1 : tensor<!pphlo.sint>, tensor<!pphlo.pint>
+})";
+
+  {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+    r.getConfig().set_oblivious_while_max_iters(5);
+
+    r.addInput(1, VIS_SECRET);
+    r.addInput(4);
+
+    r.run(invariant, 2);
+
+    r.verifyScalarOutput(4, 0);
+    r.verifyScalarOutput(4, 1);
+  }
+
+  {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+    r.getConfig().set_oblivious_while_max_iters(5);
+
+    r.addInput(1, VIS_SECRET);
+    r.addInput(0);
+
+    EXPECT_THROW(r.run(updated, 2), EnforceNotMet);
+  }
+}
+
+TEST_P(ProcessorTest, LazyTruncation) {
+  // r0 = a * b + c * d - (-(e * f)) + 1, r1 = r0 * r0
+  const auto *prog = R"(
+func @main(%arg0: tensor<!pphlo.sfxp>, %arg1: tensor<!pphlo.sfxp>, %arg2: tensor<!pphlo.sfxp>, %arg3: tensor<!pphlo.pfxp>, %arg4: tensor<!pphlo.sfxp>, %arg5: tensor<!pphlo.sfxp>) -> (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) {
+  %0 = "pphlo.multiply"(%arg0, %arg1) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  %1 = "pphlo.multiply"(%arg2, %arg3) : (tensor<!pphlo.sfxp>, tensor<!pphlo.pfxp>) -> tensor<!pphlo.sfxp>
+  %2 = "pphlo.multiply"(%arg4, %arg5) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  %3 = "pphlo.negate"(%2) : (tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  %4 = "pphlo.add"(%0, %1) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  %5 = "pphlo.subtract"(%4, %3) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  %6 = "pphlo.constant"() {value = dense<1> : tensor<i64>} : () -> tensor<!pphlo.pint>
+  %7 = "pphlo.add"(%5, %6) : (tensor<!pphlo.sfxp>, tensor<!pphlo.pint>) -> tensor<!pphlo.sfxp>
+  %8 = "pphlo.multiply"(%7, %7) : (tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>) -> tensor<!pphlo.sfxp>
+  return %7, %8 : tensor<!pphlo.sfxp>, tensor<!pphlo.sfxp>
+})";
+
+  for (const bool lazy : {false, true}) {
+    Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
+             std::get<2>(GetParam()));
+
+    r.getConfig().set_enable_lazy_truncation(lazy);
+
+    r.addInput(1.5F, VIS_SECRET);
+    r.addInput(2.0F, VIS_SECRET);
+    r.addInput(-0.5F, VIS_SECRET);
+    r.addInput(3.0F);
+    r.addInput(2.5F, VIS_SECRET);
+    r.addInput(4.0F, VIS_SECRET);
+
+    r.run(prog, 2);
+
+    r.verifyScalarOutputNear(12.5F, 0.02F, 0);
+    r.verifyScalarOutputNear(156.25F, 0.5F, 1);
+  }
+}
+
 TEST_P(ProcessorTest, Reduce) {
   Runner r(std::get<0>(GetParam()), std::get<1>(GetParam()),
            std::get<2>(GetParam()));
@@ -15,13 +15,67 @@
 
 #include "ppu/device/symbol_table.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+#include "ppu/core/shape_util.h"
+#include "ppu/core/type.h"
 #include "ppu/core/type_util.h"
 #include "ppu/utils/exception.h"
 
 namespace ppu::device {
+namespace {
+
+using google::protobuf::internal::WireFormatLite;
+
+constexpr int kValueContentField = ValueProto::kContentFieldNumber;
+
+// rows of the first dimension, a scalar is a single row.
+int64_t NumRows(const ShapeProto &shape) {
+  return shape.dims_size() == 0 ? 1 : shape.dims(0);
+}
+
+int64_t ContentBytes(const std::string &type_data, const ShapeProto &shape) {
+  std::vector<int64_t> dims(shape.dims().begin(), shape.dims().end());
+  return numel(dims) * static_cast<int64_t>(Type::fromString(type_data).size());
+}
+
+// Locate the content field in a serialized ValueProto without parsing (and
+// copying) it, the meta fields are parsed into `meta`.
+size_t LocateContent(const std::string &serialized, ValueProto *meta) {
+  google::protobuf::io::CodedInputStream in(
+      reinterpret_cast<const uint8_t *>(serialized.data()),
+      static_cast<int>(serialized.size()));
+
+  // proto3 omits empty bytes fields.
+  size_t offset = serialized.size();
+  while (uint32_t tag = in.ReadTag()) {
+    if (WireFormatLite::GetTagFieldNumber(tag) == kValueContentField) {
+      uint32_t length;
+      PPU_ENFORCE(in.ReadVarint32(&length));
+      offset = in.CurrentPosition();
+      PPU_ENFORCE(in.Skip(static_cast<int>(length)));
+    } else if (WireFormatLite::GetTagFieldNumber(tag) ==
+               ValueProto::kTypeDataFieldNumber) {
+      PPU_ENFORCE(WireFormatLite::ReadString(&in, meta->mutable_type_data()));
+    } else if (WireFormatLite::GetTagFieldNumber(tag) ==
+               ValueProto::kShapeFieldNumber) {
+      PPU_ENFORCE(WireFormatLite::ReadMessage(&in, meta->mutable_shape()));
+    } else {
+      PPU_ENFORCE(WireFormatLite::SkipField(&in, tag));
+    }
+  }
+  return offset;
+}
+
+} // namespace
 
 void SymbolTable::setVar(const std::string &name, const std::string &val) {
   sym_table_[name] = val;
@@ -39,6 +93,125 @@ bool SymbolTable::hasVar(const std::string &name) const {
   return sym_table_.find(name) != sym_table_.end();
 }
 
-void SymbolTable::clear() { sym_table_.clear(); }
+void SymbolTable::setVarChunk(const std::string &name,
+                              const ValueChunkProto &chunk) {
+  auto itr = partial_vars_.find(name);
+  if (itr == partial_vars_.end()) {
+    // protobuf merges concatenated messages, so the serialized value is the
+    // meta fields followed by a preallocated content field.
+    ValueProto meta;
+    meta.set_type_data(chunk.type_data());
+    *meta.mutable_shape() = chunk.shape();
+
+    PartialVar var;
+    var.type_data = chunk.type_data();
+    var.shape = chunk.shape();
+    var.num_rows = NumRows(chunk.shape());
+    const int64_t content_bytes =
+        ContentBytes(chunk.type_data(), chunk.shape());
+    var.row_bytes = var.num_rows == 0 ? 0 : content_bytes / var.num_rows;
+
+    var.serialized = meta.SerializeAsString();
+    var.serialized.push_back(static_cast<char>(WireFormatLite::MakeTag(
+        kValueContentField, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)));
+    uint64_t length = content_bytes;
+    do {
+      const uint8_t byte = length & 0x7f;
+      length >>= 7;
+      var.serialized.push_back(static_cast<char>(byte | (length ? 0x80 : 0)));
+    } while (length != 0);
+    var.content_offset = var.serialized.size();
+    var.serialized.resize(var.content_offset + content_bytes);
+
+    itr = partial_vars_.emplace(name, std::move(var)).first;
+  }
+
+  auto &var = itr->second;
+  PPU_ENFORCE(chunk.type_data() == var.type_data,
+              "chunk of {} type mismatch, got={}, expected={}", name,
+              chunk.type_data(), var.type_data);
+  PPU_ENFORCE(std::equal(chunk.shape().dims().begin(),
+                         chunk.shape().dims().end(),
+                         var.shape.dims().begin(), var.shape.dims().end()),
+              "chunk of {} shape mismatch", name);
+
+  const int64_t rows = chunk.row_end() - chunk.row_begin();
+  PPU_ENFORCE(chunk.row_begin() >= 0 && rows >= 0 &&
+                  chunk.row_end() <= var.num_rows,
+              "invalid rows [{}, {}) of {}, num_rows={}", chunk.row_begin(),
+              chunk.row_end(), name, var.num_rows);
+  PPU_ENFORCE(static_cast<int64_t>(chunk.content().size()) ==
+                  rows * var.row_bytes,
+              "chunk of {} size mismatch, got={}, expected={}", name,
+              chunk.content().size(), rows * var.row_bytes);
+
+  if (rows > 0) {
+    // the first range ending after row_begin must start at or after row_end.
+    auto next = var.received.upper_bound(chunk.row_begin());
+    auto prev = next == var.received.begin() ? var.received.end()
+                                             : std::prev(next);
+    PPU_ENFORCE((prev == var.received.end() ||
+                 prev->second <= chunk.row_begin()) &&
+                    (next == var.received.end() ||
+                     next->first >= chunk.row_end()),
+                "rows [{}, {}) of {} overlap rows already received",
+                chunk.row_begin(), chunk.row_end(), name);
+
+    std::memcpy(var.serialized.data() + var.content_offset +
+                    chunk.row_begin() * var.row_bytes,
+                chunk.content().data(), chunk.content().size());
+
+    int64_t begin = chunk.row_begin();
+    int64_t end = chunk.row_end();
+    if (prev != var.received.end() && prev->second == begin) {
+      begin = prev->first;
+      var.received.erase(prev);
+    }
+    if (next != var.received.end() && next->first == end) {
+      end = next->second;
+      var.received.erase(next);
+    }
+    var.received.emplace(begin, end);
+  }
+
+  const bool complete =
+      var.num_rows == 0 ||
+      (var.received.size() == 1 && var.received.begin()->first == 0 &&
+       var.received.begin()->second == var.num_rows);
+  if (complete) {
+    sym_table_[name] = std::move(var.serialized);
+    partial_vars_.erase(itr);
+  }
+}
+
+ValueChunkProto SymbolTable::getVarChunk(const std::string &name,
+                                         int64_t row_begin,
+                                         int64_t row_end) const {
+  const auto &serialized = getVar(name);
+
+  ValueProto meta;
+  const size_t content_offset = LocateContent(serialized, &meta);
+
+  const int64_t num_rows = NumRows(meta.shape());
+  PPU_ENFORCE(0 <= row_begin && row_begin <= row_end && row_end <= num_rows,
+              "invalid rows [{}, {}) of {}, num_rows={}", row_begin, row_end,
+              name, num_rows);
+  const int64_t content_bytes = ContentBytes(meta.type_data(), meta.shape());
+  const int64_t row_bytes = num_rows == 0 ? 0 : content_bytes / num_rows;
+
+  ValueChunkProto chunk;
+  chunk.set_type_data(meta.type_data());
+  *chunk.mutable_shape() = meta.shape();
+  chunk.set_row_begin(row_begin);
+  chunk.set_row_end(row_end);
+  chunk.set_content(serialized.data() + content_offset + row_begin * row_bytes,
+                    (row_end - row_begin) * row_bytes);
+  return chunk;
+}
+
+void SymbolTable::clear() {
+  sym_table_.clear();
+  partial_vars_.clear();
+}
 
 } // namespace ppu::device
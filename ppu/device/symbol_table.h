@@ -15,9 +15,12 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <unordered_map>
 
+#include "ppu/ppu.pb.h"
+
 namespace ppu::device {
 
 class SymbolTable {
@@ -47,11 +50,44 @@ public:
   ///@return false
   bool hasVar(const std::string &name) const;
 
+  ///@brief Add a row-block of a variable, for streaming infeed
+  ///
+  /// The serialized variable is preallocated on the first chunk, chunks are
+  /// copied in place, the variable becomes visible once every row is covered.
+  /// A chunk overlapping rows already received, or whose type/shape differs
+  /// from the first chunk, is rejected.
+  ///
+  ///@param name
+  ///@param chunk
+  void setVarChunk(const std::string &name, const ValueChunkProto &chunk);
+
+  ///@brief Get a row-block of a variable, for streaming outfeed
+  ///
+  ///@param name
+  ///@param row_begin
+  ///@param row_end
+  ///@return rows [row_begin, row_end) of the variable
+  ValueChunkProto getVarChunk(const std::string &name, int64_t row_begin,
+                              int64_t row_end) const;
+
   ///@brief Clear the symbol table
   void clear();
 
 private:
   std::unordered_map<std::string, std::string> sym_table_;
+
+  // variables under streaming infeed.
+  struct PartialVar {
+    std::string type_data;
+    ShapeProto shape;
+    std::string serialized;
+    size_t content_offset;
+    int64_t num_rows;
+    int64_t row_bytes;
+    // received row ranges, begin -> end, adjacent ranges are merged.
+    std::map<int64_t, int64_t> received;
+  };
+  std::unordered_map<std::string, PartialVar> partial_vars_;
 };
 
 } // namespace ppu::device
@@ -97,6 +97,22 @@ Attribute PPHloDialect::parseAttribute(DialectAsmParser& parser,
   return {};
 }
 
+Operation* PPHloDialect::materializeConstant(OpBuilder& builder,
+                                             Attribute value, Type type,
+                                             Location loc) {
+  // Folded values are plaintext, they only materialize as public constants.
+  auto elements = value.dyn_cast<DenseElementsAttr>();
+  auto tensor_type = type.dyn_cast<RankedTensorType>();
+  TypeTools tools;
+  if (!elements || !tensor_type || !tools.isPublicType(type) ||
+      elements.getType().getShape() != tensor_type.getShape() ||
+      elements.getType().getElementType().isa<FloatType>() !=
+          tools.isFxpType(type)) {
+    return nullptr;
+  }
+  return builder.create<ConstOp>(loc, elements);
+}
+
 void PPHloDialect::printAttribute(Attribute attr, DialectAsmPrinter& os) const {
   LogicalResult result = generatedAttributePrinter(attr, os);
   (void)result;
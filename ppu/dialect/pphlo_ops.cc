@@ -18,6 +18,8 @@
 #include <set>
 #include <unordered_map>
 
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/Builders.h"
@@ -48,6 +50,82 @@ static LogicalResult Verify(T op) {
   return success();
 }
 
+// Folds an elementwise op on plaintext constants, returns null if any operand
+// is not a constant or the result is not public.
+template <typename FloatFn, typename IntFn>
+static Attribute foldUnary(ArrayRef<Attribute> operands, Type result_type,
+                           FloatFn&& float_fn, IntFn&& int_fn) {
+  auto in = operands[0].dyn_cast_or_null<DenseElementsAttr>();
+  if (!in || !TypeTools().isPublicType(result_type)) {
+    return {};
+  }
+
+  const auto shaped_type = in.getType();
+  if (in.isa<DenseFPElementsAttr>()) {
+    if (in.isSplat()) {
+      return DenseElementsAttr::get(shaped_type,
+                                    float_fn(in.getSplatValue<APFloat>()));
+    }
+    llvm::SmallVector<APFloat, 4> values;
+    for (const auto& x : in.getValues<APFloat>()) {
+      values.push_back(float_fn(x));
+    }
+    return DenseElementsAttr::get(shaped_type, values);
+  }
+
+  // pred has logical semantics, leave it to the runtime.
+  if (!in.isa<DenseIntElementsAttr>() ||
+      shaped_type.getElementType().isInteger(1)) {
+    return {};
+  }
+  const bool is_unsigned = shaped_type.getElementType().isUnsignedInteger();
+  llvm::SmallVector<APInt, 4> values;
+  for (const auto& x : in.getValues<APInt>()) {
+    values.push_back(int_fn(APSInt(x, is_unsigned)));
+  }
+  return DenseElementsAttr::get(shaped_type, values);
+}
+
+template <typename FloatFn, typename IntFn>
+static Attribute foldBinary(ArrayRef<Attribute> operands, Type result_type,
+                            FloatFn&& float_fn, IntFn&& int_fn) {
+  auto lhs = operands[0].dyn_cast_or_null<DenseElementsAttr>();
+  auto rhs = operands[1].dyn_cast_or_null<DenseElementsAttr>();
+  if (!lhs || !rhs || lhs.getType() != rhs.getType() ||
+      !TypeTools().isPublicType(result_type)) {
+    return {};
+  }
+
+  const auto shaped_type = lhs.getType();
+  if (lhs.isa<DenseFPElementsAttr>()) {
+    if (lhs.isSplat() && rhs.isSplat()) {
+      return DenseElementsAttr::get(
+          shaped_type, float_fn(lhs.getSplatValue<APFloat>(),
+                                rhs.getSplatValue<APFloat>()));
+    }
+    llvm::SmallVector<APFloat, 4> values;
+    for (const auto& it :
+         llvm::zip(lhs.getValues<APFloat>(), rhs.getValues<APFloat>())) {
+      values.push_back(float_fn(std::get<0>(it), std::get<1>(it)));
+    }
+    return DenseElementsAttr::get(shaped_type, values);
+  }
+
+  // pred has logical semantics, leave it to the runtime.
+  if (!lhs.isa<DenseIntElementsAttr>() ||
+      shaped_type.getElementType().isInteger(1)) {
+    return {};
+  }
+  const bool is_unsigned = shaped_type.getElementType().isUnsignedInteger();
+  llvm::SmallVector<APInt, 4> values;
+  for (const auto& it :
+       llvm::zip(lhs.getValues<APInt>(), rhs.getValues<APInt>())) {
+    values.push_back(int_fn(APSInt(std::get<0>(it), is_unsigned),
+                            APSInt(std::get<1>(it), is_unsigned)));
+  }
+  return DenseElementsAttr::get(shaped_type, values);
+}
+
 // Builds a constant op with the specified attribute `value`.
 void ConstOp::build(OpBuilder& builder, OperationState& result,
                     Attribute value) {
@@ -110,6 +188,51 @@ OpFoldResult ReciprocalOp::fold(ArrayRef<Attribute> operands) {
                                   values);
 }
 
+OpFoldResult NegOp::fold(ArrayRef<Attribute> operands) {
+  return foldUnary(
+      operands, getType(), [](const APFloat& x) { return neg(x); },
+      [](const APSInt& x) -> APInt { return -x; });
+}
+
+OpFoldResult AddOp::fold(ArrayRef<Attribute> operands) {
+  return foldBinary(
+      operands, getType(),
+      [](const APFloat& x, const APFloat& y) { return x + y; },
+      [](const APSInt& x, const APSInt& y) -> APInt { return x + y; });
+}
+
+OpFoldResult SubOp::fold(ArrayRef<Attribute> operands) {
+  return foldBinary(
+      operands, getType(),
+      [](const APFloat& x, const APFloat& y) { return x - y; },
+      [](const APSInt& x, const APSInt& y) -> APInt { return x - y; });
+}
+
+OpFoldResult MulOp::fold(ArrayRef<Attribute> operands) {
+  return foldBinary(
+      operands, getType(),
+      [](const APFloat& x, const APFloat& y) { return x * y; },
+      [](const APSInt& x, const APSInt& y) -> APInt { return x * y; });
+}
+
+OpFoldResult MaxOp::fold(ArrayRef<Attribute> operands) {
+  return foldBinary(
+      operands, getType(),
+      [](const APFloat& x, const APFloat& y) { return maxnum(x, y); },
+      [](const APSInt& x, const APSInt& y) -> APInt {
+        return x < y ? y : x;
+      });
+}
+
+OpFoldResult MinOp::fold(ArrayRef<Attribute> operands) {
+  return foldBinary(
+      operands, getType(),
+      [](const APFloat& x, const APFloat& y) { return minnum(x, y); },
+      [](const APSInt& x, const APSInt& y) -> APInt {
+        return x < y ? x : y;
+      });
+}
+
 OpFoldResult ReshapeOp::fold(ArrayRef<Attribute> operands) {
   auto operand_shape = getOperand().getType().cast<TensorType>().getShape();
   auto result_shape = getResult().getType().cast<TensorType>().getShape();
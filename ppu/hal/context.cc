@@ -15,7 +15,9 @@
 
 #include "ppu/hal/context.h"
 
+#include "ppu/mpc/abkernels.h"
 #include "ppu/mpc/factory.h"
+#include "ppu/mpc/util/communicator.h"
 
 namespace ppu {
 
@@ -24,6 +26,24 @@ HalContext::HalContext(RuntimeConfig config,
     : rt_config_(config),
       lctx_(lctx),
       rand_engine_(config.public_random_seed()),
-      prot_(mpc::Factory::CreateCompute(config.protocol(), lctx)) {}
+      prot_(mpc::Factory::CreateCompute(config.protocol(), lctx)) {
+  // per-kernel cost is collected together with per-op profiling data.
+  prot_->enableProfile(config.enable_op_time_profile());
+
+  if (lctx_ && config.comm_num_streams() > 1 &&
+      prot_->hasState<mpc::Communicator>()) {
+    prot_->getState<mpc::Communicator>()->setStreams(
+        config.comm_num_streams(), config.comm_stripe_min_bytes());
+  }
+
+  if (config.msb_field() != FT_INVALID && prot_->hasState<mpc::ABState>()) {
+    prot_->getState<mpc::ABState>()->msb_field = config.msb_field();
+  }
+
+  if (lctx_) {
+    lctx_->GetTimeline()->enable(config.enable_timeline());
+    prot_->setTimeline(lctx_->GetTimeline());
+  }
+}
 
 }  // namespace ppu
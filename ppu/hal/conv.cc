@@ -15,18 +15,22 @@
 
 #include "ppu/hal/conv.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <tuple>
 #include <vector>
 
-#include "io_ops.h"
-#include "shape_ops.h"
-
+#include "ppu/hal/io_ops.h"
 #include "ppu/hal/polymorphic.h"
-#include "ppu/hal/reduce.h"
 #include "ppu/hal/shape_ops.h"
 
 namespace ppu::hal {
+namespace {
+
+constexpr int64_t kDefaultConvTileBytes = 64 * 1024 * 1024;
+
+}  // namespace
 
 Value conv2d_b01f_01io_b01f(
     HalContext* ctx, const Value& input, const Value& kernel,
@@ -35,128 +39,91 @@ Value conv2d_b01f_01io_b01f(
   PPU_ENFORCE(input.shape().size() == 4 && kernel.shape().size() == 4);
   PPU_ENFORCE(input.shape()[3] == kernel.shape()[2]);
   PPU_ENFORCE(window_strides.size() == 2 && padding.size() == 2);
-
-  // 01io -> o01i
-  auto transposed_kernel = transpose(ctx, kernel, {3, 0, 1, 2});
-
-  PPU_ENFORCE(input.shape()[3] == transposed_kernel.shape()[3]);
-
-  const auto batch = input.shape()[0];
-  const auto feature = input.shape()[3];
-  const auto input_h = input.shape()[1];
-  const auto input_w = input.shape()[2];
-  const auto out = transposed_kernel.shape()[0];
-  const auto kernel_h = transposed_kernel.shape()[1];
-  const auto kernel_w = transposed_kernel.shape()[2];
-
-  // add padding
-  auto padding_value = input.dtype() == DT_INT
-                           ? make_value(ctx, input.vtype(), 0)
-                           : make_value(ctx, input.vtype(), 0.0);
-  auto padded_input =
-      pad(ctx, input, padding_value, {0, padding[0].first, padding[1].first, 0},
-          {0, padding[0].second, padding[1].second, 0}, {0, 0, 0, 0});
-
-  PPU_ENFORCE((input_h + padding[0].first + padding[0].second) >=
-              static_cast<size_t>(kernel_h));
-  PPU_ENFORCE((input_w + padding[1].first + padding[1].second) >=
-              static_cast<size_t>(kernel_w));
-
-  const size_t out_h =
-      (input_h - kernel_h + padding[0].first + padding[0].second) /
-          window_strides[0] +
-      1;
-  const size_t out_w =
-      (input_w - kernel_w + padding[1].first + padding[1].second) /
-          window_strides[1] +
-      1;
-
-  DataType ret_dtype = input.dtype();
-
-  if (kernel.dtype() != ret_dtype) {
-    // If input dtype is different from kernel, it must be DT_INT + DT_FXP,
-    // thus, result must be DT_FXP
-    ret_dtype = DT_FXP;
-  }
-
-#define OPTIMIZED
-#ifdef OPTIMIZED
-  std::vector<Value> im2col_elements;
-
-  const Value flattened_transposed_kernel =
-      reshape(ctx, transposed_kernel, {out, feature * kernel_h * kernel_w});
-  for (size_t i = 0;
-       i <= input_h - kernel_h + padding[0].first + padding[0].second;
-       i += window_strides[0]) {
-    for (size_t j = 0;
-         j <= input_w - kernel_w + padding[1].first + padding[1].second;
-         j += window_strides[1]) {
-      const auto sliced_input =
-          reshape(ctx,
-                  slice(ctx, padded_input, {0, i, j, 0},
-                        {static_cast<size_t>(batch), i + kernel_h, j + kernel_w,
-                         static_cast<size_t>(feature)},
-                        {}),
-                  {batch, feature * kernel_h * kernel_w});
-
-      im2col_elements.emplace_back(sliced_input);
+  PPU_ENFORCE(window_strides[0] > 0 && window_strides[1] > 0);
+
+  const int64_t batch = input.shape()[0];
+  const int64_t feature = input.shape()[3];
+  const int64_t kernel_h = kernel.shape()[0];
+  const int64_t kernel_w = kernel.shape()[1];
+  const int64_t out = kernel.shape()[3];
+  const int64_t stride_h = window_strides[0];
+  const int64_t stride_w = window_strides[1];
+
+  // add padding, the patches are copied from a compact b01f layout.
+  Value padded_input;
+  if (padding[0].first == 0 && padding[0].second == 0 &&
+      padding[1].first == 0 && padding[1].second == 0) {
+    padded_input = input.isCompact() ? input : input.clone();
+  } else {
+    auto padding_value = input.dtype() == DT_INT
+                             ? make_value(ctx, input.vtype(), 0)
+                             : make_value(ctx, input.vtype(), 0.0);
+    padded_input = pad(ctx, input, padding_value,
+                       {0, padding[0].first, padding[1].first, 0},
+                       {0, padding[0].second, padding[1].second, 0},
+                       {0, 0, 0, 0});
+    if (!padded_input.isCompact()) {
+      padded_input = padded_input.clone();
     }
   }
 
-  PPU_ENFORCE(!im2col_elements.empty());
-
-  Value im2col = concatenate(ctx, im2col_elements, 1);
-
-  im2col = reshape(ctx, im2col,
-                   {static_cast<int64_t>(batch * out_h * out_w),
-                    feature * kernel_h * kernel_w});
-
-  auto ret = matmul(ctx, im2col, transpose(ctx, flattened_transposed_kernel));
-
-  return reshape(
-      ctx, ret,
-      {batch, static_cast<int64_t>(out_h), static_cast<int64_t>(out_w), out});
-#else
-  Value ret = makeValue(NdArrayRef(input.eltype().as<ValueTy>()->mpc_type(),
-                                   {out_h * out_w * batch * out}),
-                        ret_dtype);
-
-  auto init_val = make_value(ctx, VIS_PUBLIC, 0);
-
-  size_t idx = 0;
-  for (size_t b = 0; b < batch; b++) {
-    for (size_t o = 0; o < out; o++) {
-      for (size_t i = 0;
-           i <= input_h - kernel_h + padding[0].first + padding[0].second;
-           i += window_strides[0]) {
-        for (size_t j = 0;
-             j <= input_w - kernel_w + padding[1].first + padding[1].second;
-             j += window_strides[1]) {
-          auto sliced_input =
-              slice(ctx, padded_input, {b, i, j, 0},
-                    {b + 1, i + kernel_h, j + kernel_w, feature}, {});
-
-          auto sliced_kernel = slice(ctx, transposed_kernel, {o, 0, 0, 0},
-                                     {o + 1, kernel_h, kernel_w, feature}, {});
-
-          auto prod = mul(ctx, sliced_input, sliced_kernel);
-
-          auto reduced_sum = reduce(ctx, prod, init_val, {3, 2, 1},
-                                    [&ctx](const Value& a, const Value& b) {
-                                      return add(ctx, a, b);
-                                    });
-          PPU_ENFORCE(reduced_sum.numel() == 1);
-          ret.CopyElementFrom(reduced_sum, 0, idx++);
-        }
+  const int64_t padded_h = padded_input.shape()[1];
+  const int64_t padded_w = padded_input.shape()[2];
+  PPU_ENFORCE(padded_h >= kernel_h && padded_w >= kernel_w);
+
+  const int64_t out_h = (padded_h - kernel_h) / stride_h + 1;
+  const int64_t out_w = (padded_w - kernel_w) / stride_w + 1;
+
+  // 01io -> (01i)o, matches the (01f) order of a patch row below.
+  const int64_t patch_size = kernel_h * kernel_w * feature;
+  const Value flattened_kernel = reshape(ctx, kernel, {patch_size, out});
+
+  // Instead of building the whole im2col matrix, patches are written into a
+  // tile of at most `conv_tile_bytes`, and each tile is multiplied with the
+  // kernel separately, so the peak memory is bounded by the tile size.
+  const int64_t elsize = padded_input.elsize();
+  const int64_t tile_bytes = ctx->rt_config().conv_tile_bytes() > 0
+                                 ? ctx->rt_config().conv_tile_bytes()
+                                 : kDefaultConvTileBytes;
+  const int64_t num_patches = batch * out_h * out_w;
+  const int64_t rows_per_tile =
+      std::clamp<int64_t>(tile_bytes / (patch_size * elsize), 1, num_patches);
+
+  // in b01f layout, kernel_w x feature elements of a patch are contiguous.
+  const auto* src = static_cast<const std::byte*>(padded_input.data());
+  const int64_t patch_row_bytes = kernel_w * feature * elsize;
+
+  Value ret;
+  for (int64_t begin = 0; begin < num_patches; begin += rows_per_tile) {
+    const int64_t end = std::min(begin + rows_per_tile, num_patches);
+
+    Value im2col(padded_input.eltype(), {end - begin, patch_size});
+    auto* dst = static_cast<std::byte*>(im2col.data());
+    for (int64_t idx = begin; idx < end; ++idx) {
+      const int64_t b = idx / (out_h * out_w);
+      const int64_t i = (idx / out_w) % out_h * stride_h;
+      const int64_t j = idx % out_w * stride_w;
+      for (int64_t ki = 0; ki < kernel_h; ++ki) {
+        const int64_t pos = ((b * padded_h + i + ki) * padded_w + j) * feature;
+        std::memcpy(dst, src + pos * elsize, patch_row_bytes);
+        dst += patch_row_bytes;
       }
     }
+
+    Value prod = matmul(ctx, im2col, flattened_kernel);
+    if (!prod.isCompact()) {
+      prod = prod.clone();
+    }
+
+    if (begin == 0) {
+      ret = Value(prod.eltype(), {num_patches, out});
+    }
+    auto* ret_ptr = static_cast<std::byte*>(ret.data());
+    std::memcpy(ret_ptr + begin * out * ret.elsize(), prod.data(),
+                prod.numel() * prod.elsize());
   }
-  // bf01
-  ret = reshape(ctx, ret, {batch, out, out_h, out_w});
 
-  // bf01 -> b01f
-  return transpose(ctx, ret, {0, 2, 3, 1});
-#endif
+  return reshape(ctx, ret, {batch, out_h, out_w, out});
 }
 
 }  // namespace ppu::hal
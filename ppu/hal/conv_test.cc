@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "gtest/gtest.h"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xio.hpp"
 
 #include "ppu/hal/test_util.h"
@@ -152,5 +153,37 @@ TYPED_TEST(ConvTest, conv2d_b01f_01io_b01f_2432_3322_21_21) {
       << z << std::endl;
 }
 
+// (<2x5x4x2>, <3x2x2x3>), padding is {{1,0},{0,1}}, strides is {2,1}, the
+// im2col patches are split into one row tiles.
+TEST(ConvTileTest, conv2d_b01f_01io_b01f_tiled) {
+  // GIVEN
+  xt::xarray<int32_t> x = xt::arange<int32_t>(2 * 5 * 4 * 2);
+  x.reshape({2, 5, 4, 2});
+  xt::xarray<int32_t> y = xt::arange<int32_t>(3 * 2 * 2 * 3) % 7;
+  y.reshape({3, 2, 2, 3});
+
+  auto conv = [&](int64_t tile_bytes) {
+    RuntimeConfig config;
+    config.set_protocol(ProtocolKind::REF2K);
+    config.set_field(FieldType::FM64);
+    config.set_conv_tile_bytes(tile_bytes);
+    HalContext ctx = test::MakeRefHalContext(config);
+
+    Value a = make_value(&ctx, VIS_SECRET, x);
+    Value b = make_value(&ctx, VIS_PUBLIC, y);
+    Value c = conv2d_b01f_01io_b01f(&ctx, a, b, {2, 1}, {{1, 0}, {0, 1}});
+    return test::dump_public_as<int64_t>(&ctx, _s2p(&ctx, c));
+  };
+
+  // WHAT
+  auto tiled = conv(1);
+  auto untiled = conv(0);
+
+  // THEN
+  EXPECT_EQ(std::vector<int64_t>(tiled.shape().begin(), tiled.shape().end()),
+            std::vector<int64_t>({2, 2, 4, 3}));
+  EXPECT_EQ(tiled, untiled);
+}
+
 }  // namespace
 }  // namespace ppu::hal
@@ -15,9 +15,12 @@
 
 #include "ppu/hal/fxp.h"
 
+#include <cmath>
+
 #include "absl/numeric/bits.h"
 
 #include "ppu/hal/const_util.h"
+#include "ppu/hal/fxp_approx.h"
 #include "ppu/hal/integer.h"
 #include "ppu/hal/public_intrinsic.h"
 #include "ppu/hal/ring.h"
@@ -52,15 +55,16 @@ Value f_polynomial(HalContext* ctx, const Value& x,
   PPU_ENFORCE(x.is_fxp());
   PPU_ENFORCE(!coeffs.empty());
 
+  // the terms are summed before a single truncation.
   Value x_pow = x;
-  Value res = f_mul(ctx, x_pow, coeffs[0]);
+  Value res = _mul(ctx, x_pow, coeffs[0]);
 
   for (size_t i = 1; i < coeffs.size(); i++) {
     x_pow = f_mul(ctx, x_pow, x);
-    res = f_add(ctx, res, f_mul(ctx, x_pow, coeffs[i]));
+    res = _add(ctx, res, _mul(ctx, x_pow, coeffs[i]));
   }
 
-  return res;
+  return _trunc(ctx, res).as_fxp();
 }
 
 // Fill all bits after msb to 1.
@@ -92,6 +96,32 @@ Value highestOneBit(HalContext* ctx, const Value& x) {
   return _xor(ctx, y, y1);
 }
 
+// The position of the single one bit of each element of `x`, among the low
+// `num_bits` bits. Bit j of the position is the parity of the bits whose index
+// has bit j set, parity of xor shares is local, so only the packed position
+// pays a conversion when used arithmetically.
+Value onehot_position(HalContext* ctx, const Value& x, size_t num_bits) {
+  PPU_ENFORCE(num_bits > 1 && num_bits < 64,
+              "num_bits={} out of the int64 masks", num_bits);
+  const auto one = shaped_const(ctx, 1, x.shape());
+
+  Value pos;
+  for (size_t j = 0; (size_t(1) << j) < num_bits; j++) {
+    uint64_t mask = 0;
+    for (size_t idx = 0; idx < num_bits; idx++) {
+      mask |= static_cast<uint64_t>((idx >> j) & 1) << idx;
+    }
+    auto parity = _and(
+        ctx, x, shaped_const(ctx, static_cast<int64_t>(mask), x.shape()));
+    for (size_t offset = 1; offset < num_bits; offset <<= 1) {
+      parity = _xor(ctx, parity, _rshift(ctx, parity, offset));
+    }
+    const auto bit = _lshift(ctx, _and(ctx, parity, one), j);
+    pos = j == 0 ? bit : _xor(ctx, pos, bit);
+  }
+  return pos.as_int();
+}
+
 // Reference:
 //   Charpter 3.4 Division @ Secure Computation With Fixed Point Number
 //   http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.221.1305&rep=rep1&type=pdf
@@ -156,6 +186,29 @@ Value highestOneBit(HalContext* ctx, const Value& x) {
   return f_mul(ctx, r, x_sign);
 }
 
+// Same normalization as goldschmdit, x = c * 2^{m+1-f}, c \in [0.5, 1), then
+//   1/c = 4 / (t + 3), t = 4c - 3 \in [-1, 1)
+// by a degree 7 chebyshev polynomial.
+Value reciprocal_poly(HalContext* ctx, const Value& x) {
+  auto x_sign = f_sign(ctx, x);
+  auto x_abs = f_mul(ctx, x_sign, x);
+
+  const size_t num_fxp_bits = ctx->FxpBits();
+  auto x_msb = highestOneBit(ctx, x_abs);
+
+  // the fixed point repr of 2^{f-1-m}
+  auto factor = _reverse_bits(ctx, x_msb, 0, 2 * num_fxp_bits).as_fxp();
+  auto x_norm = f_mul(ctx, x_abs, factor);
+
+  auto t = f_sub(ctx, _lshift(ctx, x_norm, 2).as_fxp(),
+                 shaped_const(ctx, 3.0f, x.shape()));
+  static const auto kCoeffs = ChebyshevCoeffs(
+      [](double v) { return 4.0 / (v + 3.0); }, -1.0, 1.0, 7);
+  auto r = f_mul(ctx, f_polynomial_ps(ctx, t, kCoeffs), factor);
+
+  return f_mul(ctx, r, x_sign);
+}
+
 [[maybe_unused]] Value reciprocal_newton(HalContext* ctx, const Value& x) {
   // Note(jint), this initialize guess result is far warse than the
   // normalized-goldschmidt method.
@@ -181,6 +234,102 @@ Value highestOneBit(HalContext* ctx, const Value& x) {
   return res;
 }
 
+Value exp_iterative(HalContext* ctx, const Value& x) {
+  const size_t config_iters = ctx->rt_config().fxp_exp_iters();
+  const size_t num_iters = config_iters == 0 ? 8 : config_iters;
+  // see https://lvdmaaten.github.io/publications/papers/crypten.pdf
+  //   exp(x) = (1 + x / n) ^ n, when n is infinite large.
+  Value res = f_add(ctx, _trunc(ctx, x, num_iters).as_fxp(),
+                    shaped_const(ctx, 1.0f, x.shape()));
+
+  for (size_t i = 0; i < num_iters; i++) {
+    res = f_square(ctx, res);
+  }
+
+  return res;
+}
+
+//   exp(x) = exp(x / 2^K) ^ (2^K)
+// where exp on [-1, 1] is a degree 6 chebyshev polynomial, so the result is
+// accurate for |x| <= 2^K.
+Value exp_poly(HalContext* ctx, const Value& x) {
+  const size_t config_iters = ctx->rt_config().fxp_exp_iters();
+  const size_t num_iters = config_iters == 0 ? 4 : config_iters;
+
+  static const auto kCoeffs = ChebyshevCoeffs(
+      [](double v) { return std::exp(v); }, -1.0, 1.0, 6);
+  Value res =
+      f_polynomial_ps(ctx, _trunc(ctx, x, num_iters).as_fxp(), kCoeffs);
+
+  for (size_t i = 0; i < num_iters; i++) {
+    res = f_square(ctx, res);
+  }
+
+  return res;
+}
+
+// See P11, A.2.4 Logarithm and Exponent,
+// https://lvdmaaten.github.io/publications/papers/crypten.pdf
+// https://github.com/facebookresearch/CrypTen/blob/master/crypten/common/functions/approximations.py#L55-L104
+Value log_iterative(HalContext* ctx, const Value& x) {
+  Value term_1 = f_div(ctx, x, shaped_const(ctx, 120.0f, x.shape()));
+  Value term_2 = f_mul(
+      ctx,
+      f_exp(ctx, f_negate(ctx, f_add(ctx,
+                                     f_mul(ctx, x,
+                                           shaped_const(ctx, 2.0f, x.shape())),
+                                     shaped_const(ctx, 1.0f, x.shape())))),
+      shaped_const(ctx, 20.0f, x.shape()));
+  Value y = f_add(ctx, f_sub(ctx, term_1, term_2),
+                  shaped_const(ctx, 3.0f, x.shape()));
+
+  std::vector<Value> coeffs;
+  const size_t config_orders = ctx->rt_config().fxp_log_orders();
+  const size_t num_order = config_orders == 0 ? 8 : config_orders;
+  for (size_t i = 0; i < num_order; i++) {
+    coeffs.emplace_back(shaped_const(ctx, 1.0f / (1.0f + i), x.shape()));
+  }
+
+  const size_t config_iters = ctx->rt_config().fxp_log_iters();
+  const size_t num_iters = config_iters == 0 ? 3 : config_iters;
+  for (size_t i = 0; i < num_iters; i++) {
+    Value h = f_sub(ctx, shaped_const(ctx, 1.0f, x.shape()),
+                    f_mul(ctx, x, f_exp(ctx, f_negate(ctx, y))));
+    y = f_sub(ctx, y, f_polynomial(ctx, h, coeffs));
+  }
+
+  return y;
+}
+
+//   x = c * 2^{m+1-f}, c \in [0.5, 1)
+//   log(x) = log(c) + (m + 1 - f) * log(2)
+// where log(c) is a degree 5 chebyshev polynomial of t = 4c - 3, and m is the
+// position of the msb, within the 2f bits the factor covers.
+Value log_poly(HalContext* ctx, const Value& x) {
+  const size_t num_fxp_bits = ctx->FxpBits();
+  const auto prefix = prefix_or(ctx, x);
+  const auto x_msb = _xor(ctx, prefix, _rshift(ctx, prefix, 1));
+
+  // the fixed point repr of 2^{f-1-m}
+  auto factor = _reverse_bits(ctx, x_msb, 0, 2 * num_fxp_bits).as_fxp();
+  auto x_norm = f_mul(ctx, x, factor);
+
+  auto t = f_sub(ctx, _lshift(ctx, x_norm, 2).as_fxp(),
+                 shaped_const(ctx, 3.0f, x.shape()));
+  static const auto kCoeffs = ChebyshevCoeffs(
+      [](double v) { return std::log((v + 3.0) / 4.0); }, -1.0, 1.0, 5);
+  Value res = f_polynomial_ps(ctx, t, kCoeffs);
+
+  // the int * fxp product needs no truncation.
+  const auto exponent = _sub(
+      ctx, onehot_position(ctx, x_msb, 2 * num_fxp_bits),
+      shaped_const(ctx, static_cast<int64_t>(num_fxp_bits) - 1, x.shape()));
+  return f_add(
+      ctx, res,
+      _mul(ctx, exponent, shaped_const(ctx, std::log(2.0), x.shape()))
+          .as_fxp());
+}
+
 }  // namespace
 
 Value f_square(HalContext* ctx, const Value& x) {
@@ -201,18 +350,19 @@ Value f_exp(HalContext* ctx, const Value& x) {
     return f_exp_p(ctx, x);
   }
 
-  const size_t config_iters = ctx->rt_config().fxp_exp_iters();
-  const size_t num_iters = config_iters == 0 ? 8 : config_iters;
-  // see https://lvdmaaten.github.io/publications/papers/crypten.pdf
-  //   exp(x) = (1 + x / n) ^ n, when n is infinite large.
-  Value res = f_add(ctx, _trunc(ctx, x, num_iters).as_fxp(),
-                    shaped_const(ctx, 1.0f, x.shape()));
-
-  for (size_t i = 0; i < num_iters; i++) {
-    res = f_square(ctx, res);
+  switch (ctx->rt_config().fxp_exp_mode()) {
+    case FXP_APPROX_DEFAULT:
+    case FXP_APPROX_ITERATIVE: {
+      return exp_iterative(ctx, x);
+    }
+    case FXP_APPROX_POLY: {
+      return exp_poly(ctx, x);
+    }
+    default: {
+      PPU_THROW("unknown exp approximation mode {}",
+                static_cast<int>(ctx->rt_config().fxp_exp_mode()));
+    }
   }
-
-  return res;
 }
 
 Value f_negate(HalContext* ctx, const Value& x) {
@@ -239,7 +389,19 @@ Value f_reciprocal(HalContext* ctx, const Value& x) {
     return f_reciprocal_p(ctx, x);
   }
 
-  return reciprocal_goldschmdit(ctx, x);
+  switch (ctx->rt_config().fxp_reciprocal_mode()) {
+    case FXP_APPROX_DEFAULT:
+    case FXP_APPROX_ITERATIVE: {
+      return reciprocal_goldschmdit(ctx, x);
+    }
+    case FXP_APPROX_POLY: {
+      return reciprocal_poly(ctx, x);
+    }
+    default: {
+      PPU_THROW("unknown reciprocal approximation mode {}",
+                static_cast<int>(ctx->rt_config().fxp_reciprocal_mode()));
+    }
+  }
 }
 
 Value f_add(HalContext* ctx, const Value& x, const Value& y) {
@@ -304,9 +466,6 @@ Value f_less(HalContext* ctx, const Value& x, const Value& y) {
   return _less(ctx, x, y).as_int();
 }
 
-// See P11, A.2.4 Logarithm and Exponent,
-// https://lvdmaaten.github.io/publications/papers/crypten.pdf
-// https://github.com/facebookresearch/CrypTen/blob/master/crypten/common/functions/approximations.py#L55-L104
 Value f_log(HalContext* ctx, const Value& x) {
   PPU_TRACE_OP(ctx, x);
 
@@ -316,33 +475,19 @@ Value f_log(HalContext* ctx, const Value& x) {
     return f_log_p(ctx, x);
   }
 
-  Value term_1 = f_div(ctx, x, shaped_const(ctx, 120.0f, x.shape()));
-  Value term_2 = f_mul(
-      ctx,
-      f_exp(ctx, f_negate(ctx, f_add(ctx,
-                                     f_mul(ctx, x,
-                                           shaped_const(ctx, 2.0f, x.shape())),
-                                     shaped_const(ctx, 1.0f, x.shape())))),
-      shaped_const(ctx, 20.0f, x.shape()));
-  Value y = f_add(ctx, f_sub(ctx, term_1, term_2),
-                  shaped_const(ctx, 3.0f, x.shape()));
-
-  std::vector<Value> coeffs;
-  const size_t config_orders = ctx->rt_config().fxp_log_orders();
-  const size_t num_order = config_orders == 0 ? 8 : config_orders;
-  for (size_t i = 0; i < num_order; i++) {
-    coeffs.emplace_back(shaped_const(ctx, 1.0f / (1.0f + i), x.shape()));
-  }
-
-  const size_t config_iters = ctx->rt_config().fxp_log_iters();
-  const size_t num_iters = config_iters == 0 ? 3 : config_iters;
-  for (size_t i = 0; i < num_iters; i++) {
-    Value h = f_sub(ctx, shaped_const(ctx, 1.0f, x.shape()),
-                    f_mul(ctx, x, f_exp(ctx, f_negate(ctx, y))));
-    y = f_sub(ctx, y, f_polynomial(ctx, h, coeffs));
+  switch (ctx->rt_config().fxp_log_mode()) {
+    case FXP_APPROX_DEFAULT:
+    case FXP_APPROX_ITERATIVE: {
+      return log_iterative(ctx, x);
+    }
+    case FXP_APPROX_POLY: {
+      return log_poly(ctx, x);
+    }
+    default: {
+      PPU_THROW("unknown log approximation mode {}",
+                static_cast<int>(ctx->rt_config().fxp_log_mode()));
+    }
   }
-
-  return y;
 }
 
 Value f_log1p(HalContext* ctx, const Value& x) {
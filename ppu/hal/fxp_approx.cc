@@ -0,0 +1,306 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/hal/fxp_approx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include "ppu/hal/const_util.h"
+#include "ppu/hal/io_ops.h"
+#include "ppu/hal/ring.h"
+#include "ppu/hal/shape_ops.h"
+#include "ppu/hal/type_cast.h"
+
+namespace ppu::hal {
+namespace {
+
+// Multiply lhs[i] with rhs[i] for all i as fixed-point, with a single
+// multiplication and truncation over the flattened inputs.
+std::vector<Value> BatchMul(HalContext* ctx, const std::vector<Value>& lhs,
+                            const std::vector<Value>& rhs) {
+  PPU_ENFORCE(lhs.size() == rhs.size());
+
+  if (lhs.size() == 1) {
+    return {_trunc(ctx, _mul(ctx, lhs[0], rhs[0])).as_fxp()};
+  }
+
+  const auto flatten = [&](const std::vector<Value>& values) {
+    std::vector<Value> flat;
+    bool any_secret = false;
+    for (const auto& value : values) {
+      flat.push_back(reshape(ctx, value, {value.numel()}));
+      any_secret |= value.is_secret();
+    }
+    // concatenate requires the same storage type.
+    if (any_secret) {
+      for (auto& value : flat) {
+        if (value.is_public()) {
+          value = p2s(ctx, value);
+        }
+      }
+    }
+    return concatenate(ctx, flat, 0);
+  };
+
+  const auto prod = _trunc(ctx, _mul(ctx, flatten(lhs), flatten(rhs)));
+
+  std::vector<Value> ret;
+  size_t offset = 0;
+  for (size_t idx = 0; idx < lhs.size(); idx++) {
+    PPU_ENFORCE(lhs[idx].shape() == rhs[idx].shape());
+    const size_t numel = lhs[idx].numel();
+    const auto piece = slice(ctx, prod, {offset}, {offset + numel}, {1});
+    ret.push_back(reshape(ctx, piece, lhs[idx].shape()).as_fxp());
+    offset += numel;
+  }
+  return ret;
+}
+
+}  // namespace
+
+std::vector<double> ChebyshevCoeffs(const std::function<double(double)>& fn,
+                                    double lo, double hi, size_t degree) {
+  PPU_ENFORCE(lo < hi, "invalid interval [{}, {}]", lo, hi);
+
+  // chebyshev series from the values at the chebyshev nodes.
+  const size_t n = degree + 1;
+  std::vector<double> cheb(n, 0.0);
+  for (size_t k = 0; k < n; k++) {
+    const double theta = M_PI * (k + 0.5) / n;
+    const double fx = fn(lo + (std::cos(theta) + 1.0) * (hi - lo) / 2.0);
+    for (size_t j = 0; j < n; j++) {
+      cheb[j] += fx * std::cos(j * theta) * 2.0 / n;
+    }
+  }
+  cheb[0] /= 2.0;
+
+  // convert to monomials, with T_0 = 1, T_1 = t, T_{j+1} = 2t*T_j - T_{j-1}.
+  std::vector<double> ret(n, 0.0);
+  std::vector<double> t_prev(n, 0.0);
+  std::vector<double> t_cur(n, 0.0);
+  t_prev[0] = 1.0;
+  if (n > 1) {
+    t_cur[1] = 1.0;
+  }
+  for (size_t j = 0; j < n; j++) {
+    if (j >= 2) {
+      std::vector<double> t_next(n, 0.0);
+      for (size_t i = 0; i < n; i++) {
+        t_next[i] = (i > 0 ? 2.0 * t_cur[i - 1] : 0.0) - t_prev[i];
+      }
+      t_prev = std::move(t_cur);
+      t_cur = std::move(t_next);
+    }
+    const auto& t_j = j == 0 ? t_prev : t_cur;
+    for (size_t i = 0; i < n; i++) {
+      ret[i] += cheb[j] * t_j[i];
+    }
+  }
+
+  return ret;
+}
+
+std::vector<Value> f_powers(HalContext* ctx, const Value& x, size_t n) {
+  PPU_TRACE_OP(ctx, x, n);
+  PPU_ENFORCE(x.is_fxp());
+  PPU_ENFORCE(n >= 1);
+
+  std::vector<Value> pows = {x};
+  while (pows.size() < n) {
+    const size_t top = pows.size();
+    const size_t count = std::min(top, n - top);
+    std::vector<Value> lhs(pows.begin(), pows.begin() + count);
+    std::vector<Value> rhs(count, pows[top - 1]);
+    for (auto& pow : BatchMul(ctx, lhs, rhs)) {
+      pows.push_back(std::move(pow));
+    }
+  }
+
+  return pows;
+}
+
+// Paterson-Stockmeyer, with k = ceil(sqrt(degree + 1)) and y = x^k
+//   p(x) = q_0(x) + q_1(x) * y + ... + q_{m-1}(x) * y^{m-1}
+// where each q_j has degree less than k. The q_j only multiply the powers
+// x^1 .. x^k with public coefficients, so a multiplication round is only
+// spent on the powers of x, the powers of y, and the final products.
+Value f_polynomial_ps(HalContext* ctx, const Value& x,
+                      const std::vector<double>& coeffs) {
+  PPU_TRACE_OP(ctx, x);
+  PPU_ENFORCE(x.is_fxp());
+  PPU_ENFORCE(!coeffs.empty());
+
+  const auto constant = [&](double c) {
+    return shaped_const(ctx, c, x.shape());
+  };
+
+  const size_t degree = coeffs.size() - 1;
+  if (degree == 0) {
+    return constant(coeffs[0]);
+  }
+
+  const size_t k = static_cast<size_t>(std::ceil(std::sqrt(degree + 1.0)));
+  const size_t m = (degree + k) / k;
+  const auto baby = f_powers(ctx, x, std::min(k, degree));
+
+  const auto block = [&](size_t j) {
+    // sum the products with public coefficients before the truncation.
+    std::optional<Value> acc;
+    for (size_t i = 1; i < k && j * k + i <= degree; i++) {
+      const double c = coeffs[j * k + i];
+      if (c == 0.0) {
+        continue;
+      }
+      auto term = _mul(ctx, constant(c), baby[i - 1]);
+      acc = acc.has_value() ? _add(ctx, *acc, term) : term;
+    }
+    Value ret = constant(coeffs[j * k]);
+    if (acc.has_value()) {
+      ret = _add(ctx, ret, _trunc(ctx, *acc)).as_fxp();
+    }
+    return ret;
+  };
+
+  if (m == 1) {
+    return block(0);
+  }
+
+  std::vector<Value> blocks;
+  for (size_t j = 1; j < m; j++) {
+    blocks.push_back(block(j));
+  }
+  const auto giants = f_powers(ctx, baby[k - 1], m - 1);
+
+  Value ret = block(0);
+  for (const auto& term : BatchMul(ctx, blocks, giants)) {
+    ret = _add(ctx, ret, term).as_fxp();
+  }
+  return ret;
+}
+
+PiecewisePolynomial FitPiecewisePolynomial(
+    const std::function<double(double)>& fn, double lo, double hi,
+    size_t num_segments, size_t degree, double left_value,
+    double right_value) {
+  PPU_ENFORCE(lo < hi && num_segments > 0);
+
+  PiecewisePolynomial poly{lo, hi, {}, left_value, right_value};
+  const double width = (hi - lo) / num_segments;
+  for (size_t s = 0; s < num_segments; s++) {
+    poly.coeffs.push_back(ChebyshevCoeffs(fn, lo + s * width,
+                                          lo + (s + 1) * width, degree));
+  }
+  return poly;
+}
+
+Value f_piecewise_polynomial(HalContext* ctx, const Value& x,
+                             const PiecewisePolynomial& poly) {
+  PPU_TRACE_OP(ctx, x);
+  PPU_ENFORCE(x.is_fxp());
+  PPU_ENFORCE(!poly.coeffs.empty() && !poly.coeffs[0].empty());
+
+  const size_t num_segments = poly.coeffs.size();
+  const size_t degree = poly.coeffs[0].size() - 1;
+  const double width = (poly.hi - poly.lo) / num_segments;
+
+  // rows[r] = [center, c_0, ..., c_degree] of region r, the regions are
+  // (-inf, lo), the segments, then [hi, inf).
+  //
+  // the values are rounded to the fixed-point grid first, so differences
+  // below are encoded exactly, and the selected high order coefficients of
+  // the constant regions are exactly zero.
+  const double scale = std::ldexp(1.0, ctx->FxpBits());
+  const auto quantize = [&](double v) { return std::round(v * scale) / scale; };
+
+  std::vector<std::vector<double>> rows;
+  const auto add_row = [&](double center, std::vector<double> coeffs) {
+    PPU_ENFORCE(coeffs.size() <= degree + 1, "segment degree mismatch");
+    coeffs.resize(degree + 1, 0.0);
+    std::vector<double> row = {quantize(center)};
+    for (const double c : coeffs) {
+      row.push_back(quantize(c));
+    }
+    rows.push_back(std::move(row));
+  };
+  add_row(poly.lo, {poly.left_value});
+  for (size_t s = 0; s < num_segments; s++) {
+    add_row(poly.lo + (s + 0.5) * width, poly.coeffs[s]);
+  }
+  add_row(poly.hi, {poly.right_value});
+
+  // with lt_j = [x < b_j] for breakpoints b_j = lo + j * width, the region
+  // indicators telescope:
+  //   row(x) = rows[S+1] + sum_j lt_j * (rows[j] - rows[j+1])
+  // which is a public matrix product, the int * fxp product is exact.
+  const size_t num_bps = num_segments + 1;
+  const size_t num_cols = degree + 2;
+  std::vector<double> bps(num_bps);
+  std::vector<double> diffs(num_cols * num_bps);
+  std::vector<double> base(num_cols);
+  for (size_t j = 0; j < num_bps; j++) {
+    bps[j] = poly.lo + j * width;
+    for (size_t r = 0; r < num_cols; r++) {
+      diffs[r * num_bps + j] = rows[j][r] - rows[j + 1][r];
+    }
+  }
+  for (size_t r = 0; r < num_cols; r++) {
+    base[r] = rows.back()[r];
+  }
+
+  const auto numel = x.numel();
+  const auto nb = static_cast<int64_t>(num_bps);
+  const auto nc = static_cast<int64_t>(num_cols);
+
+  // all comparisons in one batch.
+  const auto xs = broadcast_to(ctx, reshape(ctx, x, {1, numel}), {nb, numel});
+  const auto bs = broadcast_to(
+      ctx, reshape(ctx, make_public(ctx, bps), {nb, 1}), {nb, numel});
+  const auto lt = _less(ctx, xs, bs);
+
+  const auto selected = _add(
+      ctx, _matmul(ctx, reshape(ctx, make_public(ctx, diffs), {nc, nb}), lt),
+      broadcast_to(ctx, reshape(ctx, make_public(ctx, base), {nc, 1}),
+                   {nc, numel}));
+  const auto entry = [&](size_t r) {
+    const auto piece = slice(ctx, selected, {r, 0},
+                             {r + 1, static_cast<size_t>(numel)}, {1, 1});
+    return reshape(ctx, piece, x.shape()).as_fxp();
+  };
+
+  // t \in [-1, 1) inside the selected segment.
+  auto t = _sub(ctx, x, entry(0)).as_fxp();
+  if (width != 2.0) {
+    t = _trunc(ctx, _mul(ctx, t, shaped_const(ctx, 2.0 / width, x.shape())))
+            .as_fxp();
+  }
+
+  Value ret = entry(1);
+  if (degree == 0) {
+    return ret;
+  }
+
+  std::vector<Value> coeffs;
+  for (size_t i = 1; i <= degree; i++) {
+    coeffs.push_back(entry(i + 1));
+  }
+  for (const auto& term : BatchMul(ctx, coeffs, f_powers(ctx, t, degree))) {
+    ret = _add(ctx, ret, term).as_fxp();
+  }
+  return ret;
+}
+
+}  // namespace ppu::hal
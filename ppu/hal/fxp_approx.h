@@ -0,0 +1,73 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "ppu/hal/context.h"
+#include "ppu/hal/value.h"
+
+namespace ppu::hal {
+
+// Polynomial approximation engine for fixed-point elementwise functions.
+//
+// A function is approximated on a public interval by a chebyshev
+// interpolant, which is near minimax and converted to monomial coefficients
+// in t \in [-1, 1]. Secret evaluation then only needs powers of t, which are
+// computed in batched rounds so the number of communication rounds grows
+// with log(degree) instead of the degree.
+
+// Returns the monomial coefficients (constant term first) of the degree
+// `degree` chebyshev interpolant of fn on [lo, hi], as a polynomial of
+// t = (2x - lo - hi) / (hi - lo).
+std::vector<double> ChebyshevCoeffs(const std::function<double(double)>& fn,
+                                    double lo, double hi, size_t degree);
+
+// Returns [x, x^2, ..., x^n], round k multiplies x^{2^k} with all lower
+// powers in one batch, so it takes ceil(log2(n)) multiplication rounds.
+std::vector<Value> f_powers(HalContext* ctx, const Value& x, size_t n);
+
+// Evaluate sum(coeffs[i] * x^i) with the Paterson-Stockmeyer method, the
+// coefficients are public, constant term first.
+Value f_polynomial_ps(HalContext* ctx, const Value& x,
+                      const std::vector<double>& coeffs);
+
+// A function approximated by polynomials on uniform segments of [lo, hi),
+// and by constants outside the interval.
+struct PiecewisePolynomial {
+  double lo;
+  double hi;
+  // coeffs[s] are the monomial coefficients of segment s, in t \in [-1, 1)
+  // across the segment.
+  std::vector<std::vector<double>> coeffs;
+  // the value for x < lo and x >= hi.
+  double left_value;
+  double right_value;
+};
+
+PiecewisePolynomial FitPiecewisePolynomial(
+    const std::function<double(double)>& fn, double lo, double hi,
+    size_t num_segments, size_t degree, double left_value,
+    double right_value);
+
+// Evaluate a piecewise polynomial. All segment comparisons are done in one
+// batch, the segment coefficients are selected locally by a public matrix
+// product, and the polynomial is evaluated with batched powers.
+Value f_piecewise_polynomial(HalContext* ctx, const Value& x,
+                             const PiecewisePolynomial& poly);
+
+}  // namespace ppu::hal
@@ -0,0 +1,133 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/hal/fxp_approx.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "xtensor/xio.hpp"
+
+#include "ppu/hal/io_ops.h"
+#include "ppu/hal/test_util.h"
+
+namespace ppu::hal {
+
+TEST(FxpApproxTest, ChebyshevCoeffs) {
+  // a polynomial is interpolated exactly.
+  const auto coeffs = ChebyshevCoeffs(
+      [](double v) { return 1.0 + 2.0 * v - 0.5 * v * v * v; }, -1.0, 1.0, 3);
+
+  ASSERT_EQ(coeffs.size(), 4);
+  EXPECT_NEAR(coeffs[0], 1.0, 1e-9);
+  EXPECT_NEAR(coeffs[1], 2.0, 1e-9);
+  EXPECT_NEAR(coeffs[2], 0.0, 1e-9);
+  EXPECT_NEAR(coeffs[3], -0.5, 1e-9);
+
+  // the interval is mapped to [-1, 1].
+  const auto shifted =
+      ChebyshevCoeffs([](double v) { return v; }, 2.0, 4.0, 1);
+  ASSERT_EQ(shifted.size(), 2);
+  EXPECT_NEAR(shifted[0], 3.0, 1e-9);
+  EXPECT_NEAR(shifted[1], 1.0, 1e-9);
+}
+
+TEST(FxpApproxTest, Polynomial) {
+  // GIVEN
+  HalContext ctx = test::MakeRefHalContext();
+
+  xt::xarray<float> x{{-1.0, -0.5}, {0.25, 0.9}};
+  const std::vector<double> coeffs = {0.5, -1.0, 0.25, 2.0, 0.0, -1.5, 0.125};
+
+  xt::xarray<float> expected = xt::zeros<float>(x.shape());
+  for (size_t i = 0; i < coeffs.size(); i++) {
+    expected += static_cast<float>(coeffs[i]) * xt::pow(x, i);
+  }
+
+  // public polynomial
+  {
+    Value c = f_polynomial_ps(&ctx, make_public(&ctx, x), coeffs);
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, c);
+    EXPECT_TRUE(xt::allclose(expected, y, 0.001, 0.001))
+        << expected << std::endl
+        << y;
+  }
+
+  // secret polynomial
+  {
+    Value c = f_polynomial_ps(&ctx, make_secret(&ctx, x), coeffs);
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, c).as_fxp());
+    EXPECT_TRUE(xt::allclose(expected, y, 0.001, 0.001))
+        << expected << std::endl
+        << y;
+  }
+}
+
+TEST(FxpApproxTest, Powers) {
+  // GIVEN
+  HalContext ctx = test::MakeRefHalContext();
+
+  xt::xarray<float> x{0.5, -0.75, 1.5};
+
+  auto pows = f_powers(&ctx, make_secret(&ctx, x), 7);
+  ASSERT_EQ(pows.size(), 7);
+  for (size_t i = 0; i < pows.size(); i++) {
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, pows[i]).as_fxp());
+    EXPECT_TRUE(xt::allclose(xt::pow(x, i + 1), y, 0.001, 0.001))
+        << i << std::endl
+        << y;
+  }
+}
+
+TEST(FxpApproxTest, PiecewisePolynomial) {
+  // GIVEN
+  HalContext ctx = test::MakeRefHalContext();
+
+  const auto fn = [](double v) { return std::tanh(v); };
+  const auto poly = FitPiecewisePolynomial(fn, -4.0, 4.0, 8, 3, -1.0, 1.0);
+
+  // covers every segment, the boundaries, and both saturated regions.
+  xt::xarray<float> x{-100.0, -4.0, -3.3, -1.0, -0.2, 0.0,
+                      0.7,    2.5,  3.99, 4.0,  50.0};
+  xt::xarray<float> expected = xt::tanh(x);
+
+  // public piecewise
+  {
+    Value c = f_piecewise_polynomial(&ctx, make_public(&ctx, x), poly);
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, c);
+    EXPECT_TRUE(xt::allclose(expected, y, 0.01, 0.01))
+        << expected << std::endl
+        << y;
+  }
+
+  // secret piecewise
+  {
+    Value c = f_piecewise_polynomial(&ctx, make_secret(&ctx, x), poly);
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, c).as_fxp());
+    EXPECT_TRUE(xt::allclose(expected, y, 0.01, 0.01))
+        << expected << std::endl
+        << y;
+  }
+}
+
+}  // namespace ppu::hal
@@ -116,6 +116,53 @@ TEST(FxpTest, Log) {
   }
 }
 
+TEST(FxpTest, PolyApprox) {
+  // GIVEN
+  RuntimeConfig config;
+  config.set_protocol(ProtocolKind::REF2K);
+  config.set_field(FieldType::FM64);
+  config.set_fxp_exp_mode(FXP_APPROX_POLY);
+  config.set_fxp_log_mode(FXP_APPROX_POLY);
+  config.set_fxp_reciprocal_mode(FXP_APPROX_POLY);
+  HalContext ctx = test::MakeRefHalContext(config);
+
+  // secret exp
+  {
+    xt::xarray<float> x{{-8.0, -1.5, 0.0}, {0.5, 2.0, 10.0}};
+    Value c = f_exp(&ctx, make_secret(&ctx, x));
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, c).as_fxp());
+    EXPECT_TRUE(xt::allclose(xt::exp(x), y, 0.01, 0.001))
+        << xt::exp(x) << std::endl
+        << y;
+  }
+
+  // secret log
+  {
+    xt::xarray<float> x{{0.05, 0.5, 1.0}, {5, 50, 3000}};
+    Value c = f_log(&ctx, make_secret(&ctx, x));
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, c).as_fxp());
+    EXPECT_TRUE(xt::allclose(xt::log(x), y, 0.01, 0.001))
+        << xt::log(x) << std::endl
+        << y;
+  }
+
+  // secret reciprocal
+  {
+    xt::xarray<float> x{{1.0, -2.0, -15000}, {-0.5, 3.14, 15000}};
+    Value c = f_reciprocal(&ctx, make_secret(&ctx, x));
+    EXPECT_EQ(c.dtype(), DT_FXP);
+
+    auto y = test::dump_public_as<float>(&ctx, _s2p(&ctx, c).as_fxp());
+    EXPECT_TRUE(xt::allclose(1.0f / x, y, 0.001, 0.0001))
+        << (1.0 / x) << std::endl
+        << y;
+  }
+}
+
 TEST(FxpTest, Log1p) {
   // GIVEN
   HalContext ctx = test::MakeRefHalContext();
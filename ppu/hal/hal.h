@@ -18,6 +18,7 @@
 #include "ppu/hal/conv.h"
 #include "ppu/hal/debug.h"
 #include "ppu/hal/io_ops.h"
+#include "ppu/hal/lookup.h"
 #include "ppu/hal/polymorphic.h"
 #include "ppu/hal/random.h"
 #include "ppu/hal/reduce.h"
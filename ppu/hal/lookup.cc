@@ -0,0 +1,91 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/hal/lookup.h"
+
+#include <numeric>
+
+#include "ppu/core/type_util.h"
+#include "ppu/hal/io_ops.h"
+#include "ppu/hal/polymorphic.h"
+#include "ppu/hal/prot_wrapper.h"
+#include "ppu/hal/shape_ops.h"
+#include "ppu/utils/exception.h"
+
+namespace ppu::hal {
+namespace {
+
+// The dpf one-hot costs one opening plus a local domain expansion, while the
+// equality one-hot costs two comparisons per table row. Below this number of
+// rows, dealing the dpf keys does not pay off.
+constexpr int64_t kDpfMinTableRows = 32;
+
+// [L] -> [L, num_rows]
+Value OneHot(HalContext* ctx, const Value& indices, int64_t num_rows) {
+  const int64_t num_lookups = indices.numel();
+
+  // dpf output is at most 64 bits.
+  if (indices.is_secret() && num_rows >= kDpfMinTableRows &&
+      SizeOf(ctx->GetField()) <= sizeof(uint64_t) && _has_onehot_s(ctx)) {
+    return _onehot_s(ctx, indices, num_rows);
+  }
+
+  std::vector<int64_t> iota(num_rows);
+  std::iota(iota.begin(), iota.end(), 0);
+
+  const std::vector<int64_t> shape = {num_lookups, num_rows};
+  const auto lhs = broadcast_to(ctx, reshape(ctx, indices, {num_lookups, 1}),
+                                shape);
+  const auto rhs = broadcast_to(
+      ctx, reshape(ctx, make_public(ctx, iota), {1, num_rows}), shape);
+  return equal(ctx, lhs, rhs);
+}
+
+}  // namespace
+
+Value take(HalContext* ctx, const Value& table, const Value& indices) {
+  PPU_TRACE_OP(ctx, table, indices);
+
+  PPU_ENFORCE(indices.is_int(), "indices should be integer, got={}",
+              indices.dtype());
+  PPU_ENFORCE(!table.shape().empty() && table.shape()[0] > 0,
+              "table should have at least one row");
+
+  const int64_t num_rows = table.shape()[0];
+  const int64_t row_size = table.numel() / num_rows;
+  const int64_t num_lookups = indices.numel();
+
+  PPU_ENFORCE(num_lookups > 0, "empty indices");
+
+  std::vector<int64_t> ret_shape = indices.shape();
+  ret_shape.insert(ret_shape.end(), table.shape().begin() + 1,
+                   table.shape().end());
+
+  // clamp to [0, num_rows), the same as xla.
+  const std::vector<int64_t> idx_shape = {num_lookups};
+  auto idx = clamp(
+      ctx, broadcast_to(ctx, make_public(ctx, 0), idx_shape),
+      reshape(ctx, indices, idx_shape),
+      broadcast_to(ctx, make_public(ctx, num_rows - 1), idx_shape));
+
+  // [L, N] x [N, D] -> [L, D]
+  const auto one_hot = OneHot(ctx, idx, num_rows);
+  const auto ret =
+      matmul(ctx, one_hot, reshape(ctx, table, {num_rows, row_size}));
+
+  return reshape(ctx, ret, ret_shape);
+}
+
+}  // namespace ppu::hal
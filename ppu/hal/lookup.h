@@ -0,0 +1,35 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "ppu/hal/context.h"
+#include "ppu/hal/value.h"
+
+namespace ppu::hal {
+
+/// take rows of a table with integer indices, aka numpy.take(axis=0).
+// @param table, the table with shape [N, ...]
+// @param indices, the integer indices with shape [...], could be secret.
+// @return, shape of [indices..., table[1:]...]
+//
+// Indices are clamped to [0, N), the same as xla gather. The lookup is done
+// obliviously by multiplying the one-hot encoding of the indices with the
+// table, so the cost is O(num_lookups * N) in a constant number of rounds.
+// The one-hot encoding is computed by a dpf when the protocol supports it
+// and the table is large, otherwise by vectorized equality tests.
+Value take(HalContext* ctx, const Value& table, const Value& indices);
+
+}  // namespace ppu::hal
@@ -0,0 +1,69 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/hal/lookup.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "xtensor/xio.hpp"
+#include "xtensor/xview.hpp"
+
+#include "ppu/hal/test_util.h"
+
+namespace ppu::hal {
+
+using secret_v = std::integral_constant<Visibility, VIS_SECRET>;
+using public_v = std::integral_constant<Visibility, VIS_PUBLIC>;
+
+using TakeTestTypes = ::testing::Types<
+    // (table, indices)
+    std::tuple<secret_v, secret_v>,  // ss
+    std::tuple<public_v, secret_v>,  // ps
+    std::tuple<secret_v, public_v>,  // sp
+    std::tuple<public_v, public_v>   // pp
+    >;
+
+template <typename S>
+class TakeTest : public ::testing::Test {};
+TYPED_TEST_SUITE(TakeTest, TakeTestTypes);
+
+TYPED_TEST(TakeTest, Take) {
+  using TABLE_VT = typename std::tuple_element<0, TypeParam>::type;
+  using INDEX_VT = typename std::tuple_element<1, TypeParam>::type;
+
+  // GIVEN
+  xt::xarray<float> table = test::xt_random<float>({6, 2, 3});
+  // out-of-range indices are clamped.
+  xt::xarray<int32_t> indices = {{5, 0, 2}, {-1, 3, 9}};
+
+  // WHAT
+  auto z = test::EvalBinaryOp<float>(TABLE_VT::value, INDEX_VT::value,
+                                     take, table, indices);
+
+  // THEN
+  xt::xarray<float> expected = xt::zeros<float>({2, 3, 2, 3});
+  for (size_t i = 0; i < 2; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      const auto row = std::clamp(indices(i, j), 0, 5);
+      xt::view(expected, i, j) = xt::view(table, row);
+    }
+  }
+  EXPECT_TRUE(xt::allclose(expected, z, 0.01, 0.001))
+      << expected << std::endl
+      << z;
+}
+
+}  // namespace ppu::hal
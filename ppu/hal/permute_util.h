@@ -31,8 +31,11 @@ namespace ppu::hal {
 
 // NOTE(junfeng): idea is quite similar to argsort in ppu/hal/sort.h.
 template <class E>
-Value permute(HalContext* ctx, const Value& x, size_t axis,
+Value permute(HalContext* ctx, const Value& in, size_t axis,
               const xt::xexpression<E>& permutation) {
+  // The raw pointer walks below assume a compact layout, while `in` may be a
+  // strided view (i.e. transposed or broadcasted).
+  const Value x = in.isCompact() ? in : in.clone();
   const size_t dimension = x.shape().size();
 
   const auto& dpermutation = permutation.derived_cast();
@@ -15,14 +15,18 @@
 
 #include "ppu/hal/polymorphic.h"
 
+#include <cmath>
+
 #include "fmt/format.h"
 #include "fmt/ostream.h"
 
 #include "ppu/core/array_ref_util.h"
 #include "ppu/hal/dispatch.h"
 #include "ppu/hal/fxp.h"
+#include "ppu/hal/fxp_approx.h"
 #include "ppu/hal/integer.h"
 #include "ppu/hal/io_ops.h"
+#include "ppu/hal/public_intrinsic.h"
 #include "ppu/hal/ring.h"  // for fast fxp x int
 #include "ppu/hal/shape_ops.h"
 #include "ppu/hal/type_cast.h"
@@ -70,6 +74,19 @@ Value LogisticSEG3(HalContext* ctx, const Value& x) {
   return select(ctx, less(ctx, x, lower_bound), lower, ret);
 }
 
+Value LogisticSegPoly(HalContext* ctx, const Value& x) {
+  PPU_TRACE_OP(ctx, x);
+
+  // f(x) = cubic polynomial of segment [-8+2i, -6+2i)  if -8 <= x < 8
+  //        1                                          if       x >= 8
+  //        0                                          if  -8 > x
+  // Rounds = Gt + 3 * Mul, all segments are compared in one batch.
+  static const auto kPoly = FitPiecewisePolynomial(
+      [](double v) { return 1.0 / (1.0 + std::exp(-v)); }, -8.0, 8.0, 8, 3,
+      0.0, 1.0);
+  return f_piecewise_polynomial(ctx, x, kPoly);
+}
+
 }  // namespace
 
 Value identity(HalContext* ctx, const Value& x) {
@@ -192,6 +209,63 @@ Value select(HalContext* ctx, const Value& pred, const Value& a,
   return add(ctx, b, mul(ctx, pred, sub(ctx, a, b)));
 }
 
+std::vector<Value> select(HalContext* ctx, const Value& pred,
+                          const std::vector<Value>& a,
+                          const std::vector<Value>& b) {
+  PPU_TRACE_OP(ctx, pred);
+
+  PPU_ENFORCE(pred.is_int() && pred.numel() == 1,
+              "pred should be an integer scalar");
+  PPU_ENFORCE(a.size() == b.size());
+
+  // flatten a - b of all pairs into one vector, the mask is then applied by a
+  // single multiplication. since pred is zero or one, the ring product is
+  // exact for any dtype, no truncation needed.
+  std::vector<Value> diffs;
+  bool any_secret = pred.is_secret();
+  int64_t total = 0;
+  for (size_t idx = 0; idx < a.size(); idx++) {
+    PPU_ENFORCE(a[idx].shape() == b[idx].shape() &&
+                    a[idx].dtype() == b[idx].dtype(),
+                "select pair {} mismatch in shape or dtype", idx);
+    if (a[idx].numel() == 0) {
+      continue;
+    }
+    diffs.push_back(reshape(ctx, _sub(ctx, a[idx], b[idx]), {a[idx].numel()}));
+    any_secret |= diffs.back().is_secret();
+    total += a[idx].numel();
+  }
+
+  std::vector<Value> ret = b;
+  if (diffs.empty()) {
+    return ret;
+  }
+
+  if (any_secret) {
+    // concatenate requires the same storage type.
+    for (auto& diff : diffs) {
+      if (diff.is_public()) {
+        diff = p2s(ctx, diff);
+      }
+    }
+  }
+  const auto mask = broadcast_to(ctx, reshape(ctx, pred, {}), {total});
+  const auto masked = _mul(ctx, mask, concatenate(ctx, diffs, 0));
+
+  size_t offset = 0;
+  for (size_t idx = 0; idx < a.size(); idx++) {
+    const size_t numel = a[idx].numel();
+    if (numel == 0) {
+      continue;
+    }
+    const auto piece = slice(ctx, masked, {offset}, {offset + numel}, {1});
+    ret[idx] = _add(ctx, b[idx], reshape(ctx, piece, b[idx].shape()))
+                   .as_dtype(b[idx].dtype());
+    offset += numel;
+  }
+  return ret;
+}
+
 Value bitwise_and(HalContext* ctx, const Value& x, const Value& y) {
   PPU_TRACE_OP(ctx, x, y);
 
@@ -222,6 +296,11 @@ Value logistic(HalContext* ctx, const Value& in) {
 
   PPU_ENFORCE(in.is_fxp());
 
+  // public operands need no mpc friendly approximation.
+  if (in.is_public()) {
+    return f_logistic_p(ctx, in);
+  }
+
   switch (ctx->rt_config().sigmoid_mode()) {
     case ppu::SigmoidMode::DEFAULT:
     case MM1: {
@@ -233,6 +312,9 @@ Value logistic(HalContext* ctx, const Value& in) {
     case REAL: {
       return LogisticReal(ctx, in);
     }
+    case SEG_POLY: {
+      return LogisticSegPoly(ctx, in);
+    }
     default: {
       PPU_THROW("Should not hit");
     }
@@ -295,6 +377,10 @@ Value power(HalContext* ctx, const Value& x, const Value& y) {
 
   PPU_ENFORCE(x.dtype() == y.dtype());
 
+  if (x.is_public() && y.is_public() && x.is_fxp()) {
+    return f_power_p(ctx, x, y);
+  }
+
   // x^y = e^(y*ln(x))
   auto ret = exp(ctx, mul(ctx, y, log(ctx, x)));
   if (x.is_int()) {
@@ -375,4 +461,33 @@ Value permute(HalContext* ctx, const Value& x, size_t dimension,
   return _permute(ctx, x, dimension, permutations);
 }
 
+Value mul_lazy(HalContext* ctx, const Value& x, const Value& y) {
+  PPU_TRACE_OP(ctx, x, y);
+  PPU_ENFORCE(x.is_fxp() && y.is_fxp());
+
+  return _mul(ctx, x, y).as_fxp();
+}
+
+Value matmul_lazy(HalContext* ctx, const Value& x, const Value& y) {
+  PPU_TRACE_OP(ctx, x, y);
+  PPU_ENFORCE(x.is_fxp() && y.is_fxp());
+
+  return _matmul(ctx, x, y).as_fxp();
+}
+
+Value to_lazy(HalContext* ctx, const Value& in) {
+  PPU_TRACE_OP(ctx, in);
+
+  const auto x = in.is_int() ? int2fxp(ctx, in) : in;
+  PPU_ENFORCE(x.is_fxp());
+  return _lshift(ctx, x, ctx->FxpBits()).as_fxp();
+}
+
+Value lazy_trunc(HalContext* ctx, const Value& in) {
+  PPU_TRACE_OP(ctx, in);
+  PPU_ENFORCE(in.is_fxp());
+
+  return _trunc(ctx, in).as_fxp();
+}
+
 }  // namespace ppu::hal
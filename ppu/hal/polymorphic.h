@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "ppu/hal/context.h"
 #include "ppu/hal/value.h"
 
@@ -148,6 +150,17 @@ Value reciprocal(HalContext* ctx, const Value& in);
 Value select(HalContext* ctx, const Value& pred, const Value& a,
              const Value& b);
 
+/// select of many pairs under one scalar predicate
+// @param pred, the scalar predicate, requires integer zero or one
+// @param a, the first params
+// @param b, the second params, pairwise the same shape and dtype as a
+//
+// All pairs are masked by a single multiplication, so selecting n values costs
+// the rounds of one select instead of n.
+std::vector<Value> select(HalContext* ctx, const Value& pred,
+                          const std::vector<Value>& a,
+                          const std::vector<Value>& b);
+
 /// general element-wise subtract operator
 // @param x, the first parameter
 // @param y, the second parameter
@@ -173,4 +186,29 @@ Value right_shift_logical(HalContext* ctx, const Value& x, size_t bits);
 Value permute(HalContext* ctx, const Value& x, size_t dimension,
               const Value& permutations);
 
+/// lazy truncation
+//
+// A lazy value is a fixed-point value carrying 2f fractional bits, the
+// product of a mul/matmul whose truncation is deferred. Lazy values could be
+// added, subtracted and negated with each other, so a sum of products pays a
+// single truncation, see RuntimeConfig.enable_lazy_truncation.
+
+/// mul of two fixed-point values without truncation
+// @param x, the first parameter, requires fxp
+// @param y, the second parameter, requires fxp
+Value mul_lazy(HalContext* ctx, const Value& x, const Value& y);
+
+/// matmul of two fixed-point values without truncation
+// @param x, the first parameter, requires fxp
+// @param y, the second parameter, requires fxp
+Value matmul_lazy(HalContext* ctx, const Value& x, const Value& y);
+
+/// scale a fixed-point or integer value to a lazy value, locally
+// @param in, the param
+Value to_lazy(HalContext* ctx, const Value& in);
+
+/// truncate a lazy value back to a fixed-point value
+// @param in, the lazy value
+Value lazy_trunc(HalContext* ctx, const Value& in);
+
 }  // namespace ppu::hal
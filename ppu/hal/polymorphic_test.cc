@@ -576,6 +576,30 @@ TEST_P(LogisticTest, Logistic) {
   }
 }
 
+TEST(MathTest, PublicIntrinsic) {
+  // GIVEN
+  RuntimeConfig config;
+  config.set_protocol(ProtocolKind::REF2K);
+  config.set_field(FieldType::FM64);
+  HalContext ctx = test::MakeRefHalContext(config);
+
+  xt::xarray<float> x{{1.0, 2.0}, {0.5, 1.8}};
+  xt::xarray<float> y{{0.5, 3.0}, {2.0, 1.5}};
+
+  // public operands are evaluated in floating point, no approximation error.
+  {
+    Value c = logistic(&ctx, make_public(&ctx, x));
+    auto z = test::dump_public_as<float>(&ctx, c);
+    EXPECT_TRUE(xt::allclose(1.0 / (1.0 + xt::exp(-x)), z, 1e-3, 1e-3))
+        << z;
+  }
+  {
+    Value c = power(&ctx, make_public(&ctx, x), make_public(&ctx, y));
+    auto z = test::dump_public_as<float>(&ctx, c);
+    EXPECT_TRUE(xt::allclose(xt::pow(x, y), z, 1e-3, 1e-3)) << z;
+  }
+}
+
 TEST(MathTest, Clamp) {
   // GIVEN
   xt::xarray<int32_t> minv = test::xt_random<int32_t>({5, 6});
@@ -619,7 +643,8 @@ TEST(MathTest, GreaterWithLargeNumber) {
 
 INSTANTIATE_TEST_SUITE_P(
     LogisticTestInstance, LogisticTest,
-    testing::Values(SigmoidMode::MM1, SigmoidMode::SEG3, SigmoidMode::REAL),
+    testing::Values(SigmoidMode::MM1, SigmoidMode::SEG3, SigmoidMode::REAL,
+                    SigmoidMode::SEG_POLY),
     [](const testing::TestParamInfo<LogisticTest::ParamType>& info) {
       return fmt::format("{}", info.param);
     });
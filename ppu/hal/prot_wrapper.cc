@@ -74,7 +74,7 @@ std::tuple<int64_t, int64_t, int64_t> DeduceParamsForMatMul(
 
 // FIXME: Rethink about how strides and offset works on execution results
 
-static std::unique_ptr<mpc::ICompute> compute(HalContext* hctx) {
+static mpc::ICompute* compute(HalContext* hctx) {
   return hctx->prot()->getInterface<mpc::ICompute>();
 }
 
@@ -282,4 +282,16 @@ Value _msb_s(HalContext* ctx, const Value& in) {
   return arrayToValue(compute(ctx)->MsbS(getArray(in)), in.shape());
 }
 
+bool _has_onehot_s(HalContext* ctx) {
+  return ctx->prot()->hasKernel("OneHotS");
+}
+
+Value _onehot_s(HalContext* ctx, const Value& in, size_t num_classes) {
+  PPU_TRACE_OP(ctx, in, num_classes);
+  auto shape = in.shape();
+  shape.push_back(static_cast<int64_t>(num_classes));
+  return arrayToValue(compute(ctx)->OneHotS(getArray(in), num_classes),
+                      std::move(shape), DT_INT);
+}
+
 }  // namespace ppu::hal
@@ -77,4 +77,9 @@ Value _permute_s(HalContext* ctx, const Value& x, size_t dimension,
 Value _msb_p(HalContext* ctx, const Value& x);
 Value _msb_s(HalContext* ctx, const Value& x);
 
+// one-hot encode secret integer indices, append a dimension of num_classes.
+// optional, only if the protocol provides `OneHotS`.
+bool _has_onehot_s(HalContext* ctx);
+Value _onehot_s(HalContext* ctx, const Value& x, size_t num_classes);
+
 }  // namespace ppu::hal
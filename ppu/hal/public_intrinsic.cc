@@ -38,6 +38,30 @@ Value applyFloatingPointFn(
   return makeValue(out.as(in.mpc_type()), dtype);
 }
 
+Value applyFloatingPointFn(
+    HalContext* ctx, const Value& x, const Value& y,
+    std::function<NdArrayRef(const xt::xarray<float>&,
+                             const xt::xarray<float>&)>
+        fn) {
+  PPU_TRACE_OP(ctx, x, y);
+  PPU_ENFORCE(x.is_public() && y.is_public());
+  PPU_ENFORCE(x.dtype() == DT_FXP && y.dtype() == DT_FXP,
+              "expected fxp, got={} and {}", x.dtype(), y.dtype());
+
+  const Type ring_ty = makeType<RingTy>(ctx->GetField());
+  // decode to floating point
+  const auto raw_x =
+      decodeFromRing(x.as(ring_ty), F32, ctx->FxpBits(), x.dtype());
+  const auto raw_y =
+      decodeFromRing(y.as(ring_ty), F32, ctx->FxpBits(), y.dtype());
+
+  DataType dtype;
+  const auto out =
+      encodeToRing(fn(xt_adapt<float>(raw_x), xt_adapt<float>(raw_y)),
+                   ring_ty, ctx->FxpBits(), &dtype);
+  return makeValue(out.as(x.mpc_type()), dtype);
+}
+
 }  // namespace
 
 Value f_reciprocal_p(HalContext* ctx, const Value& in) {
@@ -62,4 +86,20 @@ Value f_exp_p(HalContext* ctx, const Value& in) {
   });
 }
 
+Value f_logistic_p(HalContext* ctx, const Value& in) {
+  PPU_TRACE_OP(ctx, in);
+  return applyFloatingPointFn(ctx, in, [&](const xt::xarray<float>& farr) {
+    return make_ndarray(1.0f / (1.0f + xt::exp(-farr)));
+  });
+}
+
+Value f_power_p(HalContext* ctx, const Value& x, const Value& y) {
+  PPU_TRACE_OP(ctx, x, y);
+  return applyFloatingPointFn(
+      ctx, x, y,
+      [&](const xt::xarray<float>& fx, const xt::xarray<float>& fy) {
+        return make_ndarray(xt::pow(fx, fy));
+      });
+}
+
 }  // namespace ppu::hal
@@ -29,4 +29,8 @@ Value f_log_p(HalContext* ctx, const Value& in);
 // Add exp back to make power test happy....
 Value f_exp_p(HalContext* ctx, const Value& in);
 
+// Evaluated in floating point instead of the fixed point approximations.
+Value f_logistic_p(HalContext* ctx, const Value& in);
+Value f_power_p(HalContext* ctx, const Value& x, const Value& y);
+
 }  // namespace ppu::hal
@@ -15,7 +15,9 @@
 
 #include "ppu/hal/reduce.h"
 
-#include "ppu/core/vectorize.h"
+#include <algorithm>
+
+#include "ppu/hal/io_ops.h"
 #include "ppu/hal/polymorphic.h"
 #include "ppu/hal/shape_ops.h"
 #include "ppu/utils/exception.h"
@@ -23,38 +25,41 @@
 namespace ppu::hal {
 namespace {
 
-Value Concat(HalContext* ctx, absl::Span<const Value> vs, size_t dim) {
-  PPU_ENFORCE(vs.size() > 0, "concat requires length greater than 0");
-  const auto& shape = vs[0].shape();
-  for (size_t idx = 1; idx < vs.size(); idx++) {
-    PPU_ENFORCE(vs[idx].shape() == shape, "shape mis-match");
+struct ReduceLayout {
+  // permutation which moves the reduced dims to the end.
+  std::vector<size_t> perm;
+  // shape of the result, the non-reduced dims.
+  std::vector<int64_t> kept_shape;
+  int64_t kept_len = 1;
+  int64_t reduce_len = 1;
+};
+
+ReduceLayout DeduceReduceLayout(const std::vector<int64_t>& in_shape,
+                                const std::vector<size_t>& dimensions) {
+  ReduceLayout layout;
+  for (size_t idx = 0; idx < in_shape.size(); idx++) {
+    if (std::find(dimensions.begin(), dimensions.end(), idx) ==
+        dimensions.end()) {
+      layout.perm.push_back(idx);
+      layout.kept_shape.push_back(in_shape[idx]);
+    }
   }
-
-  return concatenate(ctx, vs, dim);
+  for (const auto& dim : dimensions) {
+    PPU_ENFORCE(dim < in_shape.size(),
+                "reduce dim={} should be small than tensor rank={}", dim,
+                in_shape.size());
+    layout.perm.push_back(dim);
+    layout.reduce_len *= in_shape[dim];
+  }
+  layout.kept_len = ppu::numel(layout.kept_shape);
+  return layout;
 }
 
-std::vector<Value> Split(HalContext* ctx, const Value& in, size_t dim,
-                         size_t num_splits) {
-  const auto& shape = in.shape();
-
-  PPU_ENFORCE(dim < shape.size(), "invalid dim={}", dim);
-  PPU_ENFORCE(
-      shape.at(dim) % num_splits == 0,
-      "split assume original values are concatenated at dim={} with same shape",
-      dim);
-
-  size_t width = shape.at(dim) / num_splits;
-
-  std::vector<Value> results;
-  for (size_t idx = 0; idx < num_splits; idx++) {
-    std::vector<size_t> start_indices(shape.size(), 0);
-    std::vector<size_t> end_indices(in.shape().begin(), in.shape().end());
-    start_indices[dim] = idx * width;
-    end_indices[dim] = (idx + 1) * width;
-
-    results.push_back(slice(ctx, in, start_indices, end_indices, {}));
-  }
-  return results;
+// view the input as a [kept_len, reduce_len] matrix.
+Value AsReduceMatrix(HalContext* ctx, const Value& in,
+                     const ReduceLayout& layout) {
+  return reshape(ctx, transpose(ctx, in, layout.perm),
+                 {layout.kept_len, layout.reduce_len});
 }
 
 }  // namespace
@@ -62,51 +67,104 @@ std::vector<Value> Split(HalContext* ctx, const Value& in, size_t dim,
 Value reduce(HalContext* ctx, const Value& in, const Value& init,
              const std::vector<size_t>& dimensions,
              const BinaryFn<Value>& binary_op) {
-  Value res = in;
+  const std::vector<Value> inputs = {in};
+  const std::vector<Value> inits = {init};
+  auto rets = reduce(
+      ctx, inputs, inits, dimensions,
+      [&](absl::Span<const Value> lhs, absl::Span<const Value> rhs) {
+        return std::vector<Value>{binary_op(lhs[0], rhs[0])};
+      });
+  return rets[0];
+}
 
-  for (const auto& dim : dimensions) {
-    PPU_ENFORCE(dim < in.shape().size(),
-                "reduce dim={} should be small than tensor rank={}", dim,
-                in.shape().size());
+Value reduce_sum(HalContext* ctx, const Value& in,
+                 const std::vector<size_t>& dimensions) {
+  PPU_TRACE_OP(ctx, in);
+
+  const auto layout = DeduceReduceLayout(in.shape(), dimensions);
+  if (layout.reduce_len == 0 || layout.kept_len == 0) {
+    auto zero = make_value(ctx, in.vtype(),
+                           in.is_int() ? PtBufferView(0) : PtBufferView(0.0F));
+    return reduce(ctx, in, zero,
+                  dimensions, [&](const Value& a, const Value& b) {
+                    return add(ctx, a, b);
+                  });
+  }
 
-    // split dim.
-    std::vector<Value> vals;
-    for (int64_t idx = 0; idx < res.shape().at(dim); idx++) {
-      std::vector<size_t> start_indices(res.shape().size(), 0);
-      std::vector<size_t> end_indices(res.shape().begin(), res.shape().end());
-      start_indices[dim] = idx;
-      end_indices[dim] = idx + 1;
+  // [kept, reduce] x [reduce, 1], the product with a public integer vector is
+  // a local operation for all protocols and needs no truncation.
+  const auto ones =
+      broadcast_to(ctx, make_public(ctx, 1U), {layout.reduce_len, 1});
+  const auto sum = matmul(ctx, AsReduceMatrix(ctx, in, layout), ones);
 
-      vals.push_back(slice(ctx, res, start_indices, end_indices, {}));
-    }
+  return reshape(ctx, sum, layout.kept_shape);
+}
 
-    auto concat = [&](absl::Span<const Value> vs) {
-      return Concat(ctx, vs, 0);
-    };
-    auto split = [&](const Value& v, size_t num_splits) {
-      return Split(ctx, v, 0, num_splits);
-    };
-    auto vectorize_op = [&](absl::Span<const Value> lhs,
-                            absl::Span<const Value> rhs) {
-      return Vectorize<Value>(lhs, rhs, concat, split, binary_op);
-    };
-
-    // reduce it.
-    res = VectorizedReduce<Value>(vals, vectorize_op);
+std::vector<Value> reduce(HalContext* ctx, absl::Span<const Value> inputs,
+                          absl::Span<const Value> inits,
+                          const std::vector<size_t>& dimensions,
+                          const VariadicBinaryFn& binary_op) {
+  PPU_ENFORCE(!inputs.empty() && inputs.size() == inits.size(),
+              "inputs and inits size mismatch, {} vs {}", inputs.size(),
+              inits.size());
+  const size_t num_args = inputs.size();
+  for (const auto& in : inputs) {
+    PPU_ENFORCE(in.shape() == inputs[0].shape(),
+                "variadic reduce shape mismatch");
   }
 
-  std::vector<int64_t> new_shape;
-  for (size_t idx = 0; idx < in.shape().size(); idx++) {
-    if (std::find(dimensions.begin(), dimensions.end(), idx) ==
-        dimensions.end()) {
-      new_shape.push_back(in.shape().at(idx));
+  const auto layout = DeduceReduceLayout(inputs[0].shape(), dimensions);
+
+  std::vector<Value> inits_v;
+  for (const auto& init : inits) {
+    inits_v.push_back(broadcast_to(ctx, init, layout.kept_shape));
+  }
+  if (layout.reduce_len == 0) {
+    return inits_v;
+  }
+
+  std::vector<Value> cur;
+  for (const auto& in : inputs) {
+    cur.push_back(AsReduceMatrix(ctx, in, layout));
+  }
+
+  // fold the right half onto the left half, an odd tail is carried over.
+  const auto rows = static_cast<size_t>(layout.kept_len);
+  int64_t reduce_len = layout.reduce_len;
+  while (reduce_len > 1) {
+    const auto half = static_cast<size_t>(reduce_len / 2);
+    const bool has_tail = reduce_len % 2 != 0;
+
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    std::vector<Value> tails;
+    for (const auto& v : cur) {
+      lhs.push_back(slice(ctx, v, {0, 0}, {rows, half}, {}));
+      rhs.push_back(slice(ctx, v, {0, half}, {rows, 2 * half}, {}));
+      if (has_tail) {
+        tails.push_back(slice(ctx, v, {0, 2 * half},
+                              {rows, static_cast<size_t>(reduce_len)}, {}));
+      }
     }
+
+    auto next = binary_op(lhs, rhs);
+    PPU_ENFORCE(next.size() == num_args, "expect {} results, got {}",
+                num_args, next.size());
+    if (has_tail) {
+      for (size_t idx = 0; idx < num_args; idx++) {
+        next[idx] = concatenate(ctx, {next[idx], tails[idx]}, 1);
+      }
+    }
+
+    cur = std::move(next);
+    reduce_len = half + (has_tail ? 1 : 0);
   }
 
-  // last step, reshape it.
-  auto tail = reshape(ctx, res, new_shape);
+  for (auto& v : cur) {
+    v = reshape(ctx, v, layout.kept_shape);
+  }
 
-  return binary_op(broadcast_to(ctx, init, tail.shape()), tail);
+  return binary_op(inits_v, cur);
 }
 
 }  // namespace ppu::hal
@@ -15,6 +15,11 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
+#include "absl/types/span.h"
+
 #include "ppu/core/vectorize.h"
 #include "ppu/hal/context.h"
 #include "ppu/hal/value.h"
@@ -30,4 +35,29 @@ Value reduce(HalContext* ctx, const Value& in, const Value& init,
              const std::vector<size_t>& dimensions,
              const BinaryFn<Value>& binary_op);
 
+/// sums the input over dimensions in one pass, which is a local operation
+/// on both public and secret values.
+// @param in, the input value
+// @param dimensions, unordered array of dimensions to reduce.
+Value reduce_sum(HalContext* ctx, const Value& in,
+                 const std::vector<size_t>& dimensions);
+
+// (lhs_0, ..., lhs_n-1), (rhs_0, ..., rhs_n-1) -> (res_0, ..., res_n-1)
+using VariadicBinaryFn = std::function<std::vector<Value>(
+    absl::Span<const Value>, absl::Span<const Value>)>;
+
+/// applies a variadic reduction function to a tuple of arrays in parallel,
+/// i.e. argmax reduces (value, index) pairs.
+// @param inputs, the input values, must have the same shape.
+// @param inits, the init values, one for each input.
+// @param dimensions, unordered array of dimensions to reduce.
+// @param binary_op, a computation function, should be elementwise.
+//
+// The reduced dimensions are folded in log(n) rounds, each round calls
+// binary_op once with all pairs of the round packed together.
+std::vector<Value> reduce(HalContext* ctx, absl::Span<const Value> inputs,
+                          absl::Span<const Value> inits,
+                          const std::vector<size_t>& dimensions,
+                          const VariadicBinaryFn& binary_op);
+
 }  // namespace ppu::hal
@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 #include "xtensor/xio.hpp"
 #include "xtensor/xmath.hpp"
+#include "xtensor/xsort.hpp"
 
 #include "ppu/hal/polymorphic.h"
 #include "ppu/hal/test_util.h"
@@ -63,6 +64,28 @@ TYPED_TEST(MathUnaryTest, ReduceSum) {
       << z << std::endl;
 }
 
+TYPED_TEST(MathUnaryTest, ReduceSumLinear) {
+  using IN_DT = typename std::tuple_element<0, TypeParam>::type;
+  using IN_VT = typename std::tuple_element<1, TypeParam>::type;
+  using RES_DT = typename std::tuple_element<2, TypeParam>::type;
+
+  // GIVEN
+  xt::xarray<IN_DT> x = test::xt_random<IN_DT>({3, 4, 5});
+
+  auto reduce_sum_wrapper = [](HalContext* ctx, const Value& in) {
+    return reduce_sum(ctx, in, std::vector<size_t>{2, 0});
+  };
+
+  // WHAT
+  auto z = test::EvalUnaryOp<RES_DT>(IN_VT(), reduce_sum_wrapper, x);
+
+  // THEN
+  auto expected = xt::sum(x, std::vector<size_t>{0, 2});
+  EXPECT_TRUE(xt::allclose(expected, z, 0.01, 0.001))
+      << expected << std::endl
+      << z << std::endl;
+}
+
 TYPED_TEST(MathUnaryTest, ReduceMax) {
   using IN_DT = typename std::tuple_element<0, TypeParam>::type;
   using IN_VT = typename std::tuple_element<1, TypeParam>::type;
@@ -136,4 +159,32 @@ TEST(ReduceAndTest, ReduceAnd) {
   }
 }
 
+TEST(VariadicReduceTest, ArgMax) {
+  // GIVEN
+  HalContext ctx = test::MakeRefHalContext();
+
+  // distinct values, (idx * 11) % 35 is a permutation of [0, 35).
+  xt::xarray<int32_t> x = (xt::arange<int32_t>(35) * 11) % 35;
+  x.reshape({5, 7});
+  xt::xarray<int32_t> index = xt::broadcast(xt::arange<int32_t>(7), {5, 7});
+
+  std::vector<Value> inputs = {make_secret(&ctx, x), make_public(&ctx, index)};
+  std::vector<Value> inits = {make_public(&ctx, -1), make_public(&ctx, 0)};
+
+  // WHAT
+  auto argmax = [&](absl::Span<const Value> lhs, absl::Span<const Value> rhs) {
+    auto pick = greater(&ctx, lhs[0], rhs[0]);
+    return std::vector<Value>{select(&ctx, pick, lhs[0], rhs[0]),
+                              select(&ctx, pick, lhs[1], rhs[1])};
+  };
+  auto rets = reduce(&ctx, inputs, inits, {1}, argmax);
+
+  // THEN
+  ASSERT_EQ(rets.size(), 2);
+  auto max = test::dump_public_as<int32_t>(&ctx, _s2p(&ctx, rets[0]));
+  auto idx = test::dump_public_as<int32_t>(&ctx, _s2p(&ctx, rets[1]));
+  EXPECT_EQ(max, xt::amax(x, {1})) << max;
+  EXPECT_EQ(idx, xt::cast<int32_t>(xt::argmax(x, 1))) << idx;
+}
+
 }  // namespace ppu::hal
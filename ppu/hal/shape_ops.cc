@@ -15,6 +15,8 @@
 
 #include "ppu/hal/shape_ops.h"
 
+#include <numeric>
+
 #include "xtensor/xeval.hpp"
 #include "xtensor/xmanipulation.hpp"
 #include "xtensor/xstrides.hpp"
@@ -70,17 +72,30 @@ Value transpose(HalContext* ctx, const Value& in,
                 const std::vector<size_t>& permutation) {
   PPU_TRACE_OP(ctx, in);
 
-  // TODO(jint) dont touch membuf, manipulate strides for transpose.
-  return DISPATCH_ALL_ELSIZE(in.elsize(), [&]() -> Value {
-    const auto& out =
-        permutation.empty()
-            ? xt::eval(xt::transpose(xt_adapt<element_t>(in)))
-            : xt::eval(xt::transpose(xt_adapt<element_t>(in), permutation));
+  const size_t ndim = in.shape().size();
 
-    // TODO(jint) double-check xt strides convention.
-    auto buf = makeBuffer(out.data(), out.size() * _kSize);
-    return Value(std::move(buf), in.eltype(), out.shape(), out.strides(), 0);
-  });
+  std::vector<size_t> perm = permutation;
+  if (perm.empty()) {
+    perm.resize(ndim);
+    std::iota(perm.rbegin(), perm.rend(), 0);
+  }
+  PPU_ENFORCE(perm.size() == ndim, "permutation={} does not match rank={}",
+              fmt::join(perm, "x"), ndim);
+
+  // Only permute shape & strides, the buffer is shared with the input.
+  std::vector<int64_t> shape(ndim);
+  std::vector<int64_t> strides(ndim);
+  std::vector<bool> visited(ndim, false);
+  for (size_t idx = 0; idx < ndim; ++idx) {
+    PPU_ENFORCE(perm[idx] < ndim && !visited[perm[idx]],
+                "invalid permutation={}", fmt::join(perm, "x"));
+    visited[perm[idx]] = true;
+    shape[idx] = in.shape()[perm[idx]];
+    strides[idx] = in.strides()[perm[idx]];
+  }
+
+  return Value(in.buf(), in.eltype(), std::move(shape), std::move(strides),
+               in.offset());
 }
 
 Value concatenate(HalContext* ctx, absl::Span<const Value> values,
@@ -162,7 +177,12 @@ Value reshape(HalContext* ctx, const Value& in,
 
   PPU_ENFORCE(ppu::numel(in.shape()) == ppu::numel(to_shape));
 
-  // TODO(jint) dont touch membuf, manipulate strides for transpose.
+  // A compact array could be reshaped by viewing it with new strides.
+  if (in.isCompact()) {
+    return Value(in.buf(), in.eltype(), to_shape, compactStrides(to_shape),
+                 in.offset());
+  }
+
   return DISPATCH_ALL_ELSIZE(in.elsize(), [&]() -> Value {
     const auto& out =
         xt::eval(xt::reshape_view(xt_adapt<element_t>(in), to_shape));
@@ -193,15 +213,25 @@ Value broadcast_to(HalContext* ctx, const Value& in,
     operand = in;
   }
 
-  return DISPATCH_ALL_ELSIZE(in.elsize(), [&]() -> Value {
-    const auto& out =
-        xt::eval(xt::broadcast(xt_adapt<element_t>(operand), to_shape));
+  // Broadcast by zero strides, numpy style, trailing dims are aligned.
+  PPU_ENFORCE(operand.shape().size() <= to_shape.size(),
+              "can not broadcast {} to {}", fmt::join(operand.shape(), "x"),
+              fmt::join(to_shape, "x"));
+  const size_t lead = to_shape.size() - operand.shape().size();
+
+  std::vector<int64_t> strides(to_shape.size(), 0);
+  for (size_t idx = lead; idx < to_shape.size(); ++idx) {
+    const auto dim = operand.shape()[idx - lead];
+    if (dim == to_shape[idx]) {
+      strides[idx] = operand.strides()[idx - lead];
+    } else {
+      PPU_ENFORCE(dim == 1, "can not broadcast {} to {}",
+                  fmt::join(operand.shape(), "x"), fmt::join(to_shape, "x"));
+    }
+  }
 
-    // TODO: drop this copy
-    auto buf = makeBuffer(out.data(), out.size() * _kSize);
-    return Value(std::move(buf), operand.eltype(), out.shape(), out.strides(),
-                 0);
-  });
+  return Value(operand.buf(), operand.eltype(), to_shape, std::move(strides),
+               operand.offset());
 }
 
 Value reverse(HalContext* ctx, const Value& in,
@@ -229,10 +259,12 @@ Value pad(HalContext* ctx, const Value& in, const Value& padding_value,
   PPU_ENFORCE(in.dtype() == padding_value.dtype());
   PPU_ENFORCE(in.vtype() == padding_value.vtype());
 
+  // broadcast_to returns a view, make a writable copy.
   Value broadcasted =
       broadcast_to(ctx, padding_value,
                    DeducePadShape(in.shape(), edge_padding_low,
-                                  edge_padding_high, interior_padding));
+                                  edge_padding_high, interior_padding))
+          .clone();
 
   return DISPATCH_ALL_ELSIZE(in.elsize(), [&]() -> Value {
     auto ret = xt_mutable_adapt<element_t>(broadcasted);
@@ -48,6 +48,12 @@ struct element_t_s {
     }                                                         \
   }()
 
+// NOTE: broadcast_to, reshape (of a compact value), slice and transpose only
+// manipulate shape & strides, the result shares the buffer with the input.
+// These views should be treated as read-only, use Value::clone to get a
+// writable copy. Compaction happens lazily when a kernel requires contiguous
+// memory (i.e. when entering the mpc layer).
+
 /// the broadcast function
 // @param in, the input
 // @param to_shape, the target shape
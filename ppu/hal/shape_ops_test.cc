@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xio.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xshape.hpp"
 
 #include "ppu/hal/test_util.h"
@@ -175,6 +176,49 @@ TEST(ReshapeTest, Reshape) {
             std::vector<int64_t>({2, 2}));
 }
 
+TEST(ReshapeTest, ReshapeTransposed) {
+  // GIVEN
+  xt::xarray<int32_t> x = {{1, 2, 3}, {4, 5, 6}};
+  using P_VT = public_v::type;
+
+  // reshape a non-compact view.
+  auto reshape_wrapper = [](HalContext* ctx, const Value& in) {
+    return reshape(ctx, transpose(ctx, in), {6});
+  };
+  auto z = test::EvalUnaryOp<int64_t>(P_VT(), reshape_wrapper, x);
+
+  EXPECT_EQ(xt::flatten(xt::transpose(x)), z);
+}
+
+TEST(ShapeOpsViewTest, SharesBuffer) {
+  HalContext ctx = test::MakeRefHalContext();
+  xt::xarray<int32_t> x = {{1, 2, 3}, {4, 5, 6}};
+  Value a = make_public(&ctx, x);
+
+  Value t = transpose(&ctx, a);
+  EXPECT_EQ(t.buf(), a.buf());
+  EXPECT_EQ(t.shape(), std::vector<int64_t>({3, 2}));
+  EXPECT_FALSE(t.isCompact());
+
+  Value r = reshape(&ctx, a, {3, 2});
+  EXPECT_EQ(r.buf(), a.buf());
+  EXPECT_TRUE(r.isCompact());
+
+  Value b = broadcast_to(&ctx, reshape(&ctx, a, {1, 2, 3}), {4, 2, 3});
+  EXPECT_EQ(b.buf(), a.buf());
+  EXPECT_EQ(b.strides()[0], 0);
+
+  // materialize the views.
+  EXPECT_EQ(test::dump_public_as<int32_t>(&ctx, t), xt::transpose(x));
+  EXPECT_EQ(test::dump_public_as<int32_t>(&ctx, b),
+            xt::broadcast(x, {4, 2, 3}));
+
+  // clone owns a compact buffer.
+  Value c = b.clone();
+  EXPECT_NE(c.buf(), a.buf());
+  EXPECT_TRUE(c.isCompact());
+}
+
 TEST(ShapeOpsUnaryTest, Reverse) {
   // GIVEN
   xt::xarray<int32_t> x = {{
@@ -86,6 +86,12 @@ Value Value::GetElementAt(absl::Span<const int64_t> index) const {
       dtype());
 }
 
+Value Value::clone() const {
+  const auto copy = NdArrayRef::clone();
+  return Value(copy.buf(), copy.eltype(), copy.shape(), copy.strides(),
+               copy.offset());
+}
+
 ValueProto Value::toProto() const {
   ValueProto proto;
   proto.set_type_data(eltype().toString());
@@ -93,10 +99,11 @@ ValueProto Value::toProto() const {
     proto.mutable_shape()->add_dims(d);
   }
   if (isCompact()) {
-    proto.set_content(data(), buf()->size());
+    // a compact value may still be a view into a larger buffer.
+    proto.set_content(data(), numel() * elsize());
   } else {
     // Make a compact clone
-    auto copy = clone();
+    auto copy = NdArrayRef::clone();
     PPU_ENFORCE(copy.isCompact(), "Must be a compact copy.");
     proto.set_content(copy.data(), copy.buf()->size());
   }
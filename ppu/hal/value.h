@@ -56,6 +56,10 @@ class Value final : public NdArrayRef {
   Value& as_int() { return as_dtype(DT_INT); }
   Value& as_fxp() { return as_dtype(DT_FXP); }
 
+  // Make a compact deep copy, the result owns its buffer and is writable even
+  // if this value is a (broadcasted) view.
+  Value clone() const;
+
   ValueProto toProto() const;
 
   static Value fromProto(const ValueProto& proto);
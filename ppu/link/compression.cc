@@ -0,0 +1,128 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "ppu/link/compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "zlib.h"
+
+#include "ppu/utils/exception.h"
+
+namespace ppu::link {
+namespace {
+
+constexpr size_t kTagBytes = 1;
+constexpr size_t kRawSizeBytes = sizeof(uint64_t);
+
+// favor speed, the codec should keep up with the wire.
+constexpr int kZlibLevel = 1;
+
+// compress `size` bytes into `dst` which has room for compressBound(size)
+// bytes, returns the compressed size.
+size_t ZlibCompress(const void* src, size_t size, void* dst) {
+  uLongf dst_size = compressBound(size);
+  const int ret = compress2(static_cast<Bytef*>(dst), &dst_size,
+                            static_cast<const Bytef*>(src), size, kZlibLevel);
+  PPU_ENFORCE(ret == Z_OK, "zlib compress failed, ret={}", ret);
+  return dst_size;
+}
+
+Buffer RawFrame(const Buffer& value) {
+  Buffer frame(static_cast<int64_t>(kTagBytes + value.size()));
+  frame.data<uint8_t>()[0] = static_cast<uint8_t>(CompressionCodec::kNone);
+  if (value.size() > 0) {
+    std::memcpy(frame.data<uint8_t>() + kTagBytes, value.data(), value.size());
+  }
+  return frame;
+}
+
+bool Worthwhile(size_t raw_size, size_t compressed_size, double max_ratio) {
+  return static_cast<double>(compressed_size) <
+         static_cast<double>(raw_size) * max_ratio;
+}
+
+}  // namespace
+
+Buffer EncodeMessage(const Buffer& value, CompressionCodec codec,
+                     const CompressionOptions& opts) {
+  const size_t size = value.size();
+  if (codec == CompressionCodec::kNone || size < opts.min_bytes) {
+    return RawFrame(value);
+  }
+  PPU_ENFORCE(codec == CompressionCodec::kZlib, "unsupported codec={}",
+              static_cast<int>(codec));
+
+  // probe on a prefix first, skip incompressible payloads cheaply.
+  if (size > opts.probe_bytes && opts.probe_bytes > 0) {
+    std::vector<uint8_t> probe(compressBound(opts.probe_bytes));
+    const size_t probe_size =
+        ZlibCompress(value.data(), opts.probe_bytes, probe.data());
+    if (!Worthwhile(opts.probe_bytes, probe_size, opts.max_ratio)) {
+      return RawFrame(value);
+    }
+  }
+
+  Buffer frame(
+      static_cast<int64_t>(kTagBytes + kRawSizeBytes + compressBound(size)));
+  auto* ptr = frame.data<uint8_t>();
+  const size_t compressed_size =
+      ZlibCompress(value.data(), size, ptr + kTagBytes + kRawSizeBytes);
+  if (!Worthwhile(size, compressed_size, opts.max_ratio)) {
+    return RawFrame(value);
+  }
+
+  ptr[0] = static_cast<uint8_t>(CompressionCodec::kZlib);
+  const uint64_t raw_size = size;
+  std::memcpy(ptr + kTagBytes, &raw_size, kRawSizeBytes);
+  frame.resize(static_cast<int64_t>(kTagBytes + kRawSizeBytes +
+                                    compressed_size));
+  return frame;
+}
+
+Buffer DecodeMessage(const Buffer& frame) {
+  PPU_ENFORCE(frame.size() >= static_cast<int64_t>(kTagBytes),
+              "invalid message frame, size={}", frame.size());
+  const auto* ptr = frame.data<uint8_t>();
+  const auto codec = static_cast<CompressionCodec>(ptr[0]);
+
+  switch (codec) {
+    case CompressionCodec::kNone: {
+      return Buffer(ptr + kTagBytes, frame.size() - kTagBytes);
+    }
+    case CompressionCodec::kZlib: {
+      PPU_ENFORCE(frame.size() >= static_cast<int64_t>(kTagBytes +
+                                                       kRawSizeBytes),
+                  "invalid zlib frame, size={}", frame.size());
+      uint64_t raw_size;
+      std::memcpy(&raw_size, ptr + kTagBytes, kRawSizeBytes);
+      Buffer value(static_cast<int64_t>(raw_size));
+      uLongf dst_size = raw_size;
+      const int ret = uncompress(
+          value.data<Bytef>(), &dst_size, ptr + kTagBytes + kRawSizeBytes,
+          frame.size() - kTagBytes - kRawSizeBytes);
+      PPU_ENFORCE(ret == Z_OK && dst_size == raw_size,
+                  "zlib uncompress failed, ret={}, size={} expected={}", ret,
+                  dst_size, raw_size);
+      return value;
+    }
+  }
+  PPU_THROW("unknown message codec={}", static_cast<int>(ptr[0]));
+}
+
+}  // namespace ppu::link
@@ -0,0 +1,54 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "ppu/core/buffer.h"
+
+namespace ppu::link {
+
+// Message codec negotiated between two parties at ConnectToMesh.
+enum class CompressionCodec : uint8_t {
+  kNone = 0,
+  kZlib = 1,
+};
+
+struct CompressionOptions {
+  // messages smaller than this are never compressed.
+  size_t min_bytes = 1024;
+
+  // a message is sent raw when its compressed size exceeds max_ratio * size.
+  double max_ratio = 0.9;
+
+  // the ratio is first probed on a prefix of this size, so incompressible
+  // payloads (i.e. uniformly random shares) are skipped cheaply.
+  size_t probe_bytes = 16 * 1024;
+};
+
+// Frame a message for a peer which negotiated `codec`.
+//
+// The frame is a one byte codec tag followed by either the raw payload or,
+// for compressed messages, the raw size (8 bytes) and the compressed bytes.
+// The payload is compressed only if it is large enough and compresses well.
+Buffer EncodeMessage(const Buffer& value, CompressionCodec codec,
+                     const CompressionOptions& opts);
+
+// Inverse of EncodeMessage.
+Buffer DecodeMessage(const Buffer& frame);
+
+}  // namespace ppu::link
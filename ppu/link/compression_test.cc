@@ -0,0 +1,90 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "ppu/link/compression.h"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace ppu::link::test {
+
+static Buffer Compressible(size_t size) {
+  Buffer buf(static_cast<int64_t>(size));
+  for (size_t idx = 0; idx < size; idx++) {
+    // small magnitude values, like fxp encoded public data.
+    buf.data<uint8_t>()[idx] = (idx % 16 == 0) ? idx % 7 : 0;
+  }
+  return buf;
+}
+
+static Buffer Random(size_t size) {
+  std::mt19937 rng(size);
+  Buffer buf(static_cast<int64_t>(size));
+  for (size_t idx = 0; idx < size; idx++) {
+    buf.data<uint8_t>()[idx] = static_cast<uint8_t>(rng());
+  }
+  return buf;
+}
+
+TEST(CompressionTest, RoundTrip) {
+  CompressionOptions opts;
+  for (size_t size : {0, 1, 1023, 1024, 100000}) {
+    for (const auto& value : {Compressible(size), Random(size)}) {
+      for (auto codec : {CompressionCodec::kNone, CompressionCodec::kZlib}) {
+        auto frame = EncodeMessage(value, codec, opts);
+        EXPECT_EQ(DecodeMessage(frame), value) << size;
+      }
+    }
+  }
+}
+
+TEST(CompressionTest, Compressible) {
+  CompressionOptions opts;
+  const auto value = Compressible(100000);
+
+  auto frame = EncodeMessage(value, CompressionCodec::kZlib, opts);
+  EXPECT_LT(frame.size(), value.size() / 4);
+
+  // below the threshold, kept raw.
+  opts.min_bytes = value.size() + 1;
+  frame = EncodeMessage(value, CompressionCodec::kZlib, opts);
+  EXPECT_EQ(frame.size(), value.size() + 1);
+}
+
+TEST(CompressionTest, SkipIncompressible) {
+  CompressionOptions opts;
+  const auto value = Random(100000);
+
+  // raw frame, one byte tag only.
+  auto frame = EncodeMessage(value, CompressionCodec::kZlib, opts);
+  EXPECT_EQ(frame.size(), value.size() + 1);
+
+  // also when not probed.
+  opts.probe_bytes = 0;
+  frame = EncodeMessage(value, CompressionCodec::kZlib, opts);
+  EXPECT_EQ(frame.size(), value.size() + 1);
+}
+
+TEST(CompressionTest, InvalidFrame) {
+  EXPECT_ANY_THROW(DecodeMessage(Buffer()));
+
+  const uint8_t bad[] = {0x7f, 0, 0};
+  EXPECT_ANY_THROW(DecodeMessage(Buffer(bad, sizeof(bad))));
+}
+
+}  // namespace ppu::link::test
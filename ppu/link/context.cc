@@ -49,7 +49,10 @@ Context::Context(ContextDesc desc, size_t rank,
     }
   }
 
+  peer_codecs_.resize(world_size, CompressionCodec::kNone);
+
   stats_ = std::make_shared<Statistics>();
+  timeline_ = std::make_shared<Timeline>(rank_);
 }
 
 std::string Context::Id() const { return desc_.id; }
@@ -69,12 +72,19 @@ size_t Context::NextRank(size_t stride) const {
 void Context::ConnectToMesh() {
   const std::string event = fmt::format("connect_{}", Rank());
 
+  // the connect message carries the codec we are willing to use.
+  Buffer hello;
+  if (desc_.enable_compression) {
+    const auto codec = CompressionCodec::kZlib;
+    hello = Buffer(&codec, sizeof(codec));
+  }
+
   SPDLOG_INFO("connecting to mesh, id={}, self={}", Id(), Rank());
 
   auto try_connect = [&](size_t rank, const std::string& event,
                          size_t /*attempt*/) {
     try {
-      SendInternal(rank, event, {});
+      SendInternal(rank, event, hello);
     } catch (const NetworkError& e) {
       SPDLOG_DEBUG("attempt={} to connect to rank={} error={}", attempt, rank,
                    e.what());
@@ -120,7 +130,17 @@ void Context::ConnectToMesh() {
     }
 
     std::string key = fmt::format("connect_{}", idx);
-    (void)RecvInternal(idx, key);  // ignore the received value.
+    const auto peer_hello = RecvInternal(idx, key);
+
+    // both sides see the same pair of hellos, so they agree on the codec.
+    // peers which do not compress send an empty hello.
+    CompressionCodec peer_codec = CompressionCodec::kNone;
+    if (peer_hello.size() == sizeof(CompressionCodec)) {
+      peer_codec = *peer_hello.data<CompressionCodec>();
+    }
+    if (desc_.enable_compression && peer_codec == CompressionCodec::kZlib) {
+      peer_codecs_[idx] = peer_codec;
+    }
   }
   SPDLOG_INFO("connected to mesh, id={}, self={}", Id(), Rank());
 }
@@ -156,7 +176,8 @@ void Context::SendAsyncInternal(size_t dst_rank, const std::string& key,
   PPU_ENFORCE(dst_rank < static_cast<size_t>(channels_.size()),
               "rank={} out of range={}", dst_rank, channels_.size());
 
-  channels_[dst_rank]->SendAsync(key, value);
+  auto frame = EncodeFor(dst_rank, value);
+  channels_[dst_rank]->SendAsync(key, frame ? *frame : value);
 
   stats_->sent_actions++;
   stats_->sent_bytes += value.size();
@@ -167,7 +188,8 @@ void Context::SendInternal(size_t dst_rank, const std::string& key,
   PPU_ENFORCE(dst_rank < static_cast<size_t>(channels_.size()),
               "rank={} out of range={}", dst_rank, channels_.size());
 
-  channels_[dst_rank]->Send(key, value);
+  auto frame = EncodeFor(dst_rank, value);
+  channels_[dst_rank]->Send(key, frame ? *frame : value);
 
   stats_->sent_actions++;
   stats_->sent_bytes += value.size();
@@ -177,9 +199,19 @@ Buffer Context::RecvInternal(size_t src_rank, const std::string& key) {
   PPU_ENFORCE(src_rank < static_cast<size_t>(channels_.size()),
               "rank={} out of range={}", src_rank, channels_.size());
 
+  PPU_TIMELINE_SCOPE(timeline_.get(), "link", "Recv");
+  const auto start = std::chrono::steady_clock::now();
   auto value = channels_[src_rank]->Recv(key);
+  const auto end = std::chrono::steady_clock::now();
+
+  if (peer_codecs_[src_rank] != CompressionCodec::kNone) {
+    value = DecodeMessage(value);
+  }
 
   stats_->recv_actions++;
+  stats_->recv_wait_ns +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
   stats_->recv_bytes += value.size();
 
   return value;
@@ -195,6 +227,10 @@ std::unique_ptr<Context> Context::Spawn() {
 
   // share statistics with parent.
   sub_ctx->stats_ = this->stats_;
+  sub_ctx->timeline_ = this->timeline_;
+
+  // channels are shared, so is the negotiated framing.
+  sub_ctx->peer_codecs_ = this->peer_codecs_;
 
   return sub_ctx;
 }
@@ -215,6 +251,29 @@ std::shared_ptr<IChannel> Context::GetChannel(size_t src_rank) const {
   return channels_[src_rank];
 }
 
+CompressionCodec Context::GetCompressionCodec(size_t rank) const {
+  PPU_ENFORCE(rank < WorldSize(), "unexpected rank={} with world_size={}",
+              rank, WorldSize());
+  return peer_codecs_[rank];
+}
+
+std::optional<Buffer> Context::EncodeFor(size_t dst_rank,
+                                         const Buffer& value) {
+  const auto codec = peer_codecs_[dst_rank];
+  if (codec == CompressionCodec::kNone) {
+    return std::nullopt;
+  }
+
+  CompressionOptions opts;
+  opts.min_bytes = desc_.compression_min_bytes;
+  opts.max_ratio = desc_.compression_max_ratio;
+  auto frame = EncodeMessage(value, codec, opts);
+  if (frame.size() < value.size()) {
+    stats_->compression_saved_bytes += value.size() - frame.size();
+  }
+  return frame;
+}
+
 void Context::SetRecvTimeout(uint32_t recv_timeout_ms) {
   recv_timeout_ms_ = recv_timeout_ms;
   for (size_t idx = 0; idx < WorldSize(); idx++) {
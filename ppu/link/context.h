@@ -19,11 +19,14 @@
 #include <atomic>
 #include <limits>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "ppu/core/buffer.h"
+#include "ppu/link/compression.h"
 #include "ppu/link/transport/channel.h"
+#include "ppu/utils/timeline.h"
 
 namespace ppu::link {
 
@@ -77,6 +80,22 @@ struct ContextDesc {
 
   // BRPC client channel connection type.
   std::string brpc_channel_connection_type = "single";
+
+  // compress messages sent to peers which enable it too, the codec is
+  // negotiated at ConnectToMesh. Contexts which never connect to the mesh
+  // send raw messages.
+  bool enable_compression = false;
+
+  // messages smaller than this are never compressed.
+  uint32_t compression_min_bytes = 1024;  // 1k byte
+
+  // messages compressing worse than this ratio are sent raw, the ratio is
+  // probed on a prefix first, so incompressible payloads cost little.
+  double compression_max_ratio = 0.9;
+
+  // size of each incoming shared memory ring in bytes, used by FactoryShm
+  // only. Messages larger than the ring are streamed through it.
+  uint32_t shm_ring_bytes = 4 * 1024 * 1024;  // 4M byte
 };
 
 struct Statistics {
@@ -91,6 +110,13 @@ struct Statistics {
 
   // total number of recv actions, chuncked mode is treated as a single action.
   std::atomic<size_t> recv_actions = 0u;
+
+  // total time blocked in recv, in nanoseconds.
+  std::atomic<size_t> recv_wait_ns = 0u;
+
+  // total number of bytes saved on the wire by compression, sent_bytes
+  // always counts uncompressed payloads.
+  std::atomic<size_t> compression_saved_bytes = 0u;
 };
 
 // Threading: link context could only be used in one thread, since
@@ -129,6 +155,18 @@ class Context {
 
   uint32_t GetRecvTimeout() const;
 
+  // statistics are shared with spawned sub-contexts.
+  std::shared_ptr<const Statistics> GetStats() const { return stats_; }
+
+  // timeline of this party, shared with spawned sub-contexts.
+  const std::shared_ptr<Timeline>& GetTimeline() const { return timeline_; }
+
+  // record into another timeline, i.e. to keep a sub-context used by a
+  // concurrent run apart from its parent.
+  void SetTimeline(std::shared_ptr<Timeline> timeline) {
+    timeline_ = std::move(timeline);
+  }
+
  public:
   // for internal algorithms.
   void SendAsyncInternal(size_t dst_rank, const std::string& key,
@@ -146,9 +184,15 @@ class Context {
   // for external message loop
   std::shared_ptr<IChannel> GetChannel(size_t src_rank) const;
 
+  // codec negotiated with `rank` at ConnectToMesh.
+  CompressionCodec GetCompressionCodec(size_t rank) const;
+
  protected:
   using P2PDirection = std::pair<int, int>;
 
+  // frame a message for dst_rank, returns nullopt if nothing was negotiated.
+  std::optional<Buffer> EncodeFor(size_t dst_rank, const Buffer& value);
+
   const ContextDesc desc_;  // world description.
   const size_t rank_;       // my rank.
   const std::vector<std::shared_ptr<IChannel>> channels_;
@@ -162,8 +206,14 @@ class Context {
 
   uint32_t recv_timeout_ms_;
 
+  // per peer codec, kNone until negotiated.
+  std::vector<CompressionCodec> peer_codecs_;
+
   // sub-context will shared statistics with parent
   std::shared_ptr<Statistics> stats_;
+
+  // sub-context will shared timeline with parent
+  std::shared_ptr<Timeline> timeline_;
 };
 
 // a RecvTimeoutGuard is to help set the recv timeout value for the Context.
@@ -17,6 +17,7 @@
 #include "ppu/link/context.h"
 
 #include <future>
+#include <random>
 
 #include "fmt/format.h"
 #include "gmock/gmock.h"
@@ -224,4 +225,58 @@ TEST_F(ContextTest, SendRecvShouldOk) {
   EXPECT_EQ(send_buffer_, receive_buffer);
 }
 
+TEST(ContextCompressionTest, NegotiateAndCompress) {
+  // GIVEN
+  const size_t world_size = 3;
+  ContextDesc ctx_desc;
+  ctx_desc.id = "compression";
+  ctx_desc.enable_compression = true;
+  for (size_t rank = 0; rank < world_size; rank++) {
+    ctx_desc.parties.push_back(
+        {fmt::format("id-{}", rank), fmt::format("host-{}", rank)});
+  }
+  std::vector<std::shared_ptr<Context>> ctxs;
+  for (size_t rank = 0; rank < world_size; rank++) {
+    ctxs.push_back(FactoryMem().CreateContext(ctx_desc, rank));
+  }
+
+  // compressible (zeros) and incompressible payloads.
+  Buffer zeros(64 * 1024);
+  Buffer noise(64 * 1024);
+  std::mt19937 rng(0);
+  for (int64_t idx = 0; idx < noise.size(); idx++) {
+    noise.data<uint8_t>()[idx] = static_cast<uint8_t>(rng());
+  }
+
+  // WHEN
+  std::vector<std::future<std::pair<Buffer, Buffer>>> futures;
+  for (size_t rank = 0; rank < world_size; rank++) {
+    futures.push_back(std::async([&, rank]() {
+      auto ctx = ctxs[rank];
+      ctx->ConnectToMesh();
+      for (size_t peer = 0; peer < world_size; peer++) {
+        if (peer != rank) {
+          EXPECT_EQ(ctx->GetCompressionCodec(peer), CompressionCodec::kZlib);
+        }
+      }
+      ctx->SendAsync(ctx->NextRank(), zeros, "zeros");
+      ctx->SendAsync(ctx->NextRank(), noise, "noise");
+      auto r0 = ctx->Recv(ctx->PrevRank(), "zeros");
+      auto r1 = ctx->Recv(ctx->PrevRank(), "noise");
+      return std::make_pair(r0, r1);
+    }));
+  }
+
+  // THEN
+  for (size_t rank = 0; rank < world_size; rank++) {
+    auto [r0, r1] = futures[rank].get();
+    EXPECT_EQ(r0, zeros);
+    EXPECT_EQ(r1, noise);
+
+    const auto stats = ctxs[rank]->GetStats();
+    EXPECT_GT(stats->compression_saved_bytes, zeros.size() / 2);
+    EXPECT_LT(stats->compression_saved_bytes, zeros.size());
+  }
+}
+
 }  // namespace ppu::link::test
@@ -43,4 +43,12 @@ class FactoryBrpc : public ILinkFactory {
                                          size_t self_rank);
 };
 
+/// builtin link context type, shared memory link context for parties which
+/// run in different processes of the same host.
+class FactoryShm : public ILinkFactory {
+ public:
+  std::shared_ptr<Context> CreateContext(const ContextDesc& desc,
+                                         size_t self_rank);
+};
+
 }  // namespace ppu::link
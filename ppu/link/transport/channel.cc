@@ -85,6 +85,12 @@ void ChannelBase::OnMessage(const std::string& key, const Buffer& value) {
   msg_db_cond_.notify_all();
 }
 
+void ChannelBase::OnMessage(const std::string& key, Buffer&& value) {
+  std::unique_lock lock(msg_db_mutex_);
+  msg_db_.emplace(key, std::move(value));
+  msg_db_cond_.notify_all();
+}
+
 void ChannelBase::OnChunkedMessage(const std::string& key, const Buffer& value,
                                    size_t chunk_idx, size_t num_chunks) {
   if (chunk_idx >= num_chunks) {
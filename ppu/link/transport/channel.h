@@ -47,6 +47,11 @@ class IChannel {
   // called by an async dispatcher.
   virtual void OnMessage(const std::string& key, const Buffer& value) = 0;
 
+  // called by an async dispatcher which hands over the ownership of value.
+  virtual void OnMessage(const std::string& key, Buffer&& value) {
+    OnMessage(key, static_cast<const Buffer&>(value));
+  }
+
   // called by an async dispatcher.
   virtual void OnChunkedMessage(const std::string& key, const Buffer& value,
                                 size_t chunk_idx, size_t num_chunks) = 0;
@@ -74,6 +79,8 @@ class ChannelBase : public IChannel {
 
   void OnMessage(const std::string& key, const Buffer& value) override;
 
+  void OnMessage(const std::string& key, Buffer&& value) override;
+
   void OnChunkedMessage(const std::string& key, const Buffer& value,
                         size_t chunk_idx, size_t num_chunks) override;
 
@@ -0,0 +1,423 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/link/transport/channel_shm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <climits>
+#include <ctime>
+#endif
+
+#include "fmt/format.h"
+
+#include "ppu/utils/exception.h"
+
+namespace ppu::link {
+namespace {
+
+constexpr uint64_t kShmRingMagic = 0x7070752d73686d31;  // "ppu-shm1"
+
+// upper bound of a single blocking wait, stop/timeout flags are re-checked
+// in between.
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+
+// The ring header, shared by both processes.
+//
+// head/tail are monotonic byte counters, the ring is full when
+// head - tail == capacity. The *_seq words are futex words bumped on every
+// head/tail move, the *_waiters counters let the other side skip the wake
+// syscall when nobody sleeps.
+struct ShmRingHeader {
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+
+  alignas(64) std::atomic<uint64_t> head;
+  std::atomic<uint32_t> data_seq;
+  std::atomic<uint32_t> data_waiters;
+
+  alignas(64) std::atomic<uint64_t> tail;
+  std::atomic<uint32_t> space_seq;
+  std::atomic<uint32_t> space_waiters;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory ring requires address-free atomics");
+
+void WaitOn(std::atomic<uint32_t>* word, uint32_t expected) {
+#if defined(__linux__)
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+  struct timespec ts;
+  ts.tv_sec = 0;
+  ts.tv_nsec =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(kPollInterval)
+          .count();
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+          &ts, nullptr, 0);
+#else
+  if (word->load(std::memory_order_acquire) == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+#endif
+}
+
+void WakeAll(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
+// Block until `ready()` holds, `give_up()` is re-checked after every poll
+// interval. Returns false if given up.
+template <typename ReadyFn, typename GiveUpFn>
+bool BlockUntil(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiters,
+                ReadyFn&& ready, GiveUpFn&& give_up) {
+  while (true) {
+    const uint32_t observed = seq->load(std::memory_order_seq_cst);
+    if (ready()) {
+      return true;
+    }
+    waiters->fetch_add(1, std::memory_order_seq_cst);
+    if (!ready()) {
+      WaitOn(seq, observed);
+    }
+    waiters->fetch_sub(1, std::memory_order_seq_cst);
+    if (give_up()) {
+      return ready();
+    }
+  }
+}
+
+struct FrameHeader {
+  uint64_t key_size;
+  uint64_t value_size;
+};
+
+}  // namespace
+
+class ShmRing {
+ public:
+  // create the segment, the owner unlinks it on destruction.
+  static std::unique_ptr<ShmRing> Create(const std::string& name,
+                                         size_t capacity) {
+    PPU_ENFORCE(capacity > 0, "shm ring capacity should be positive");
+    // remove a stale segment left by a crashed run.
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      PPU_THROW_IO_ERROR("shm_open {} failed, errno={}", name, errno);
+    }
+    const size_t total = sizeof(ShmRingHeader) + capacity;
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      PPU_THROW_IO_ERROR("ftruncate {} to {} failed, errno={}", name, total,
+                         errno);
+    }
+    void* base =
+        mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      PPU_THROW_IO_ERROR("mmap {} failed, errno={}", name, errno);
+    }
+
+    auto* header = new (base) ShmRingHeader();
+    header->capacity = capacity;
+    header->head.store(0);
+    header->tail.store(0);
+    header->data_seq.store(0);
+    header->data_waiters.store(0);
+    header->space_seq.store(0);
+    header->space_waiters.store(0);
+    // publish.
+    header->magic.store(kShmRingMagic, std::memory_order_release);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, true));
+  }
+
+  // attach to an existing segment, nullptr if it is not published yet.
+  static std::unique_ptr<ShmRing> Open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) <= sizeof(ShmRingHeader)) {
+      close(fd);
+      return nullptr;
+    }
+    const size_t total = static_cast<size_t>(st.st_size);
+    void* base =
+        mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      return nullptr;
+    }
+    auto* header = static_cast<ShmRingHeader*>(base);
+    if (header->magic.load(std::memory_order_acquire) != kShmRingMagic ||
+        sizeof(ShmRingHeader) + header->capacity != total) {
+      munmap(base, total);
+      return nullptr;
+    }
+    return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, false));
+  }
+
+  ~ShmRing() {
+    munmap(header_, mapped_size_);
+    if (owner_) {
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  // wake up a blocked consumer so it can observe a stop request.
+  void Interrupt() {
+    header_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+    WakeAll(&header_->data_seq);
+  }
+
+  // producer side, returns the number of bytes written, less than `size` if
+  // the consumer does not make room before the deadline.
+  size_t Write(const void* src, size_t size,
+               std::chrono::steady_clock::time_point deadline) {
+    const auto* bytes = static_cast<const uint8_t*>(src);
+    const uint64_t capacity = header_->capacity;
+    size_t written = 0;
+
+    while (written < size) {
+      const uint64_t head = header_->head.load(std::memory_order_relaxed);
+      auto room = [&]() {
+        const uint64_t tail = header_->tail.load(std::memory_order_seq_cst);
+        return capacity - (head - tail);
+      };
+      if (!BlockUntil(
+              &header_->space_seq, &header_->space_waiters,
+              [&]() { return room() > 0; },
+              [&]() { return std::chrono::steady_clock::now() > deadline; })) {
+        break;
+      }
+
+      const size_t n = std::min<uint64_t>(room(), size - written);
+      const size_t offset = head % capacity;
+      const size_t first = std::min<size_t>(n, capacity - offset);
+      std::memcpy(data_ + offset, bytes + written, first);
+      std::memcpy(data_, bytes + written + first, n - first);
+
+      header_->head.store(head + n, std::memory_order_seq_cst);
+      header_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+      if (header_->data_waiters.load(std::memory_order_seq_cst) != 0) {
+        WakeAll(&header_->data_seq);
+      }
+      written += n;
+    }
+    return written;
+  }
+
+  // consumer side, returns false if stopped before `size` bytes arrived.
+  bool Read(void* dst, size_t size, const std::atomic<bool>& stopped) {
+    auto* bytes = static_cast<uint8_t*>(dst);
+    const uint64_t capacity = header_->capacity;
+
+    while (size > 0) {
+      const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+      auto avail = [&]() {
+        return header_->head.load(std::memory_order_seq_cst) - tail;
+      };
+      if (!BlockUntil(
+              &header_->data_seq, &header_->data_waiters,
+              [&]() { return avail() > 0; },
+              [&]() { return stopped.load(); })) {
+        return false;
+      }
+
+      const size_t n = std::min<uint64_t>(avail(), size);
+      const size_t offset = tail % capacity;
+      const size_t first = std::min<size_t>(n, capacity - offset);
+      std::memcpy(bytes, data_ + offset, first);
+      std::memcpy(bytes + first, data_, n - first);
+
+      header_->tail.store(tail + n, std::memory_order_seq_cst);
+      header_->space_seq.fetch_add(1, std::memory_order_seq_cst);
+      if (header_->space_waiters.load(std::memory_order_seq_cst) != 0) {
+        WakeAll(&header_->space_seq);
+      }
+      bytes += n;
+      size -= n;
+    }
+    return true;
+  }
+
+ private:
+  ShmRing(std::string name, void* base, size_t mapped_size, bool owner)
+      : name_(std::move(name)),
+        header_(static_cast<ShmRingHeader*>(base)),
+        data_(static_cast<uint8_t*>(base) + sizeof(ShmRingHeader)),
+        mapped_size_(mapped_size),
+        owner_(owner) {}
+
+  const std::string name_;
+  ShmRingHeader* const header_;
+  uint8_t* const data_;
+  const size_t mapped_size_;
+  const bool owner_;
+};
+
+std::string ShmRingName(const std::string& session_id, size_t src_rank,
+                        size_t dst_rank) {
+  // posix shm names are a single path component, keep them short and safe.
+  std::string id = session_id;
+  std::replace_if(
+      id.begin(), id.end(), [](unsigned char c) { return !std::isalnum(c); },
+      '_');
+  if (id.size() > 64) {
+    id = fmt::format("{:x}", std::hash<std::string>{}(session_id));
+  }
+  return fmt::format("/ppu.{}.{}.{}", id, src_rank, dst_rank);
+}
+
+ReceiverLoopShm::ReceiverLoopShm() = default;
+
+ReceiverLoopShm::~ReceiverLoopShm() { StopImpl(); }
+
+void ReceiverLoopShm::Stop() { StopImpl(); }
+
+void ReceiverLoopShm::StopImpl() {
+  stopped_.store(true);
+  for (auto& ring : rings_) {
+    ring->Interrupt();
+  }
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  threads_.clear();
+  rings_.clear();
+}
+
+void ReceiverLoopShm::Start(const std::string& session_id, size_t self_rank,
+                            size_t ring_bytes) {
+  PPU_ENFORCE(threads_.empty(), "shm receiver loop already started");
+  stopped_.store(false);
+
+  // publish all rings before draining any of them.
+  std::vector<std::pair<size_t, ShmRing*>> targets;
+  for (const auto& [peer_rank, listener] : listeners_) {
+    rings_.push_back(ShmRing::Create(
+        ShmRingName(session_id, peer_rank, self_rank), ring_bytes));
+    targets.emplace_back(peer_rank, rings_.back().get());
+  }
+  for (const auto& [peer_rank, ring] : targets) {
+    threads_.emplace_back([this, peer_rank = peer_rank, ring = ring]() {
+      Drain(peer_rank, ring);
+    });
+  }
+}
+
+void ReceiverLoopShm::Drain(size_t peer_rank, ShmRing* ring) {
+  const auto& listener = listeners_.at(peer_rank);
+  while (!stopped_.load()) {
+    FrameHeader frame;
+    if (!ring->Read(&frame, sizeof(frame), stopped_)) {
+      return;
+    }
+    std::string key(frame.key_size, '\0');
+    Buffer value(static_cast<int64_t>(frame.value_size));
+    if (!ring->Read(key.data(), key.size(), stopped_) ||
+        !ring->Read(value.data(), value.size(), stopped_)) {
+      return;
+    }
+    listener->OnMessage(key, std::move(value));
+  }
+}
+
+ChannelShm::ChannelShm(size_t self_rank, size_t peer_rank,
+                       size_t recv_timeout_ms, std::string session_id)
+    : ChannelBase(self_rank, peer_rank, recv_timeout_ms),
+      session_id_(std::move(session_id)) {}
+
+ChannelShm::~ChannelShm() = default;
+
+ShmRing* ChannelShm::Connect() {
+  if (!ring_) {
+    const auto name = ShmRingName(session_id_, self_rank_, peer_rank_);
+    ring_ = ShmRing::Open(name);
+    if (!ring_) {
+      PPU_THROW_NETWORK_ERROR("shm ring {} of rank={} is not ready", name,
+                              peer_rank_);
+    }
+  }
+  return ring_.get();
+}
+
+void ChannelShm::SendAsync(const std::string& key, const Buffer& value) {
+  // the peer drains its ring with a dedicated thread, so a send only blocks
+  // while a message larger than the free room is streamed.
+  std::unique_lock lock(send_mutex_);
+  if (broken_) {
+    PPU_THROW_IO_ERROR("send to rank={} on a broken channel, key={}",
+                       peer_rank_, key);
+  }
+  auto* ring = Connect();
+
+  // the frame shares a single deadline, it may be larger than the ring so
+  // its room can not be reserved upfront.
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(recv_timeout_ms_);
+  FrameHeader frame{key.size(), static_cast<uint64_t>(value.size())};
+  const std::pair<const void*, size_t> parts[] = {
+      {&frame, sizeof(frame)},
+      {key.data(), key.size()},
+      {value.data(), static_cast<size_t>(value.size())}};
+
+  size_t frame_written = 0;
+  for (const auto& [data, size] : parts) {
+    const size_t written = ring->Write(data, size, deadline);
+    frame_written += written;
+    if (written != size) {
+      // nothing of the frame reached the ring, the channel is still usable.
+      broken_ = frame_written != 0;
+      PPU_THROW_IO_ERROR("send to rank={} timeout, key={}", peer_rank_, key);
+    }
+  }
+}
+
+void ChannelShm::Send(const std::string& key, const Buffer& value) {
+  return SendAsync(key, value);
+}
+
+}  // namespace ppu::link
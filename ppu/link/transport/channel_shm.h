@@ -0,0 +1,99 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ppu/link/transport/channel.h"
+
+namespace ppu::link {
+
+// A single-producer single-consumer byte ring living in a POSIX shared memory
+// segment, see channel_shm.cc for the layout.
+class ShmRing;
+
+// Name of the shared memory segment which carries messages from `src_rank` to
+// `dst_rank` within session `session_id`.
+std::string ShmRingName(const std::string& session_id, size_t src_rank,
+                        size_t dst_rank);
+
+// The receiver loop owns the incoming rings of this party, one per peer, and
+// drains each of them with a dedicated thread.
+class ReceiverLoopShm : public ReceiverLoopBase {
+ public:
+  ReceiverLoopShm();
+
+  ~ReceiverLoopShm() override;
+
+  void Stop() override;
+
+  // create (and publish) the incoming rings for every listener, then start
+  // draining them.
+  //
+  // Note: listeners must be added before Start.
+  void Start(const std::string& session_id, size_t self_rank,
+             size_t ring_bytes);
+
+ private:
+  void StopImpl();
+
+  void Drain(size_t peer_rank, ShmRing* ring);
+
+  std::atomic<bool> stopped_{false};
+  std::vector<std::unique_ptr<ShmRing>> rings_;
+  std::vector<std::thread> threads_;
+};
+
+// Channel for parties co-located on the same host.
+//
+// Messages are framed as (key_len, value_len, key, value) and streamed
+// through the peer's incoming ring, so there is neither serialization nor
+// chunking; a message larger than the ring is simply streamed while the peer
+// drains it. Blocking waits use futex on Linux.
+class ChannelShm : public ChannelBase {
+ public:
+  // from IChannel
+  void SendAsync(const std::string& key, const Buffer& value) override;
+
+  void Send(const std::string& key, const Buffer& value) override;
+
+ public:
+  ChannelShm(size_t self_rank, size_t peer_rank, size_t recv_timeout_ms,
+             std::string session_id);
+
+  ~ChannelShm() override;
+
+ private:
+  // attach to the peer's incoming ring, raise NetworkError if the peer has
+  // not published it yet.
+  ShmRing* Connect();
+
+  const std::string session_id_;
+
+  std::mutex send_mutex_;
+  std::unique_ptr<ShmRing> ring_;
+
+  // set when a send timed out in the middle of a frame, the peer would parse
+  // the next frame from a misaligned offset, so later sends are refused.
+  bool broken_ = false;
+};
+
+}  // namespace ppu::link
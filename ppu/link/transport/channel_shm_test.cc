@@ -0,0 +1,162 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/link/transport/channel_shm.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+#include "ppu/utils/exception.h"
+
+namespace ppu::link::test {
+
+static std::string RandStr(size_t length) {
+  auto randchar = []() -> char {
+    const char charset[] =
+        "0123456789"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz";
+    const size_t max_index = (sizeof(charset) - 1);
+    return charset[rand() % max_index];
+  };
+  std::string str(length, 0);
+  std::generate_n(str.begin(), length, randchar);
+  return str;
+}
+
+static std::string SessionId() {
+  const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+  return fmt::format("shm_test_{}_{}_{}", getpid(), info->test_suite_name(),
+                     info->name());
+}
+
+class ChannelShmTest
+    : public ::testing::TestWithParam<std::tuple<size_t, size_t>> {
+ protected:
+  void Start(size_t ring_bytes) {
+    const size_t send_rank = 0;
+    const size_t recv_rank = 1;
+    const auto session_id = SessionId();
+
+    sender_ = std::make_shared<ChannelShm>(send_rank, recv_rank, 1000u,
+                                           session_id);
+    receiver_ = std::make_shared<ChannelShm>(recv_rank, send_rank, 1000u,
+                                             session_id);
+
+    // receiver_ listen messages from sender(rank 0).
+    receiver_loop_ = std::make_unique<ReceiverLoopShm>();
+    receiver_loop_->AddListener(send_rank, receiver_);
+    receiver_loop_->Start(session_id, recv_rank, ring_bytes);
+  }
+
+  std::shared_ptr<ChannelShm> sender_;
+  std::shared_ptr<ChannelShm> receiver_;
+  std::unique_ptr<ReceiverLoopShm> receiver_loop_;
+};
+
+TEST_F(ChannelShmTest, Normal_Empty) {
+  Start(1024);
+
+  const std::string key = "key";
+  const std::string sent = "";
+  sender_->SendAsync(key, {sent.c_str(), static_cast<int64_t>(sent.size())});
+  auto received = receiver_->Recv(key);
+
+  EXPECT_EQ(sent, std::string(received.data<char>(), received.size()));
+}
+
+TEST_F(ChannelShmTest, Timeout) {
+  Start(1024);
+
+  receiver_->SetRecvTimeout(500u);
+  const std::string key = "key";
+  EXPECT_THROW(receiver_->Recv(key), IoError);
+}
+
+TEST_F(ChannelShmTest, PartialFrame) {
+  Start(64);
+
+  // connect the sender, then stop draining the ring.
+  sender_->Send("first", {});
+  receiver_->Recv("first");
+  receiver_loop_->Stop();
+
+  // the frame only partially fits in the ring.
+  sender_->SetRecvTimeout(200u);
+  const std::string sent = RandStr(1000);
+  EXPECT_THROW(
+      sender_->Send("key", {sent.c_str(), static_cast<int64_t>(sent.size())}),
+      IoError);
+
+  // the ring holds a truncated frame, later sends are refused.
+  try {
+    sender_->Send("next", {});
+    ADD_FAILURE() << "send on a broken channel should throw";
+  } catch (const IoError& e) {
+    EXPECT_NE(std::string(e.what()).find("broken"), std::string::npos);
+  }
+}
+
+TEST_F(ChannelShmTest, PeerNotReady) {
+  auto sender = std::make_shared<ChannelShm>(0, 1, 1000u, SessionId());
+
+  EXPECT_THROW(sender->Send("key", {}), NetworkError);
+}
+
+TEST_F(ChannelShmTest, Sequence) {
+  Start(64);
+
+  std::vector<std::string> sent(20);
+  for (size_t idx = 0; idx < sent.size(); idx++) {
+    sent[idx] = RandStr(idx * 7);
+    sender_->SendAsync(fmt::format("key_{}", idx),
+                       {sent[idx].c_str(), static_cast<int64_t>(idx * 7)});
+  }
+
+  // receive in reverse order.
+  for (size_t idx = sent.size(); idx-- > 0;) {
+    auto received = receiver_->Recv(fmt::format("key_{}", idx));
+    EXPECT_EQ(sent[idx], std::string(received.data<char>(), received.size()));
+  }
+}
+
+TEST_P(ChannelShmTest, Send) {
+  const size_t ring_bytes = std::get<0>(GetParam());
+  const size_t size_to_send = std::get<1>(GetParam());
+  Start(ring_bytes);
+
+  const std::string key = "key";
+  const std::string sent = RandStr(size_to_send);
+  sender_->Send(key, {sent.c_str(), static_cast<int64_t>(sent.size())});
+  auto received = receiver_->Recv(key);
+
+  EXPECT_EQ(sent, std::string(received.data<char>(), received.size()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Normal_Instances, ChannelShmTest,
+    testing::Combine(testing::Values(7, 64, 4096),
+                     testing::Values(1, 9, 10, 11, 1001, 1 << 20)),
+    [](const testing::TestParamInfo<ChannelShmTest::ParamType>& info) {
+      std::string name = fmt::format("Ring_{}_Len_{}", std::get<0>(info.param),
+                                     std::get<1>(info.param));
+      return name;
+    });
+
+}  // namespace ppu::link::test
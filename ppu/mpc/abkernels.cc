@@ -67,6 +67,9 @@ ArrayRef _Lazy2A(Object* obj, const ArrayRef& in) {
 #define _ReverseBitsB(in, start, end) \
   ctx->caller()->call("ReverseBitsB", in, start, end)
 #define _MsbA(in) ctx->caller()->call("MsbA", in)
+#define _OneHotA(in, num) ctx->caller()->call("OneHotA", in, num)
+#define _CastDownA(in, field) ctx->caller()->call("CastDownA", in, field)
+#define _CastB(in, field) ctx->caller()->call("CastB", in, field)
 }  // namespace
 
 ArrayRef P2S::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
@@ -234,6 +237,23 @@ ArrayRef ReverseBitsS::proc(KernelEvalContext* ctx, const ArrayRef& in,
   return _B2A(_ReverseBitsB(_A2B(in), start, end));
 }
 
+namespace {
+
+// Apply MsbA, in a narrower ring if ABState.msb_field asks for it. The
+// shares are reduced locally, and the one-bit boolean result is zero-extended
+// back to the input's ring, both conversions are free.
+ArrayRef _NarrowMsbA(KernelEvalContext* ctx, const ArrayRef& in) {
+  const auto field = in.eltype().as<Ring2k>()->field();
+  const auto msb_field = ctx->caller()->getState<ABState>()->msb_field;
+  if (msb_field == FT_INVALID || SizeOf(msb_field) >= SizeOf(field) ||
+      !ctx->caller()->hasKernel("CastDownA")) {
+    return _MsbA(in);
+  }
+  return _CastB(_MsbA(_CastDownA(in, msb_field)), field);
+}
+
+}  // namespace
+
 ArrayRef MsbS::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
   PPU_TRACE_OP(this, in);
   if (ctx->caller()->hasKernel("MsbA")) {
@@ -242,11 +262,11 @@ ArrayRef MsbS::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
         return _RShiftB(in, in.elsize() * 8 - 1);
       } else {
         // fast path, directly apply msb in AShare, result a BShare.
-        return _MsbA(in);
+        return _NarrowMsbA(ctx, in);
       }
     } else {
       // Do it in AShare domain, and convert back to AShare.
-      return _B2A(_MsbA(in));
+      return _B2A(_NarrowMsbA(ctx, in));
     }
   } else {
     if (_LAZY_AB) {
@@ -256,4 +276,13 @@ ArrayRef MsbS::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
   }
 }
 
+ArrayRef OneHotS::proc(KernelEvalContext* ctx, const ArrayRef& in,
+                       size_t num_classes) const {
+  PPU_TRACE_OP(this, in, num_classes);
+  if (_LAZY_AB) {
+    return _OneHotA(_2A(in), num_classes);
+  }
+  return _OneHotA(in, num_classes);
+}
+
 }  // namespace ppu::mpc
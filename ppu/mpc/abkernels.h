@@ -24,6 +24,10 @@ class ABState : public State {
   static constexpr char kName[] = "ABState";
 
   bool lazy_ab = true;
+
+  // when set to a field narrower than the input's, the msb of arithmetic
+  // shares is extracted in this field, see RuntimeConfig.msb_field.
+  FieldType msb_field = FT_INVALID;
 };
 
 class P2S : public UnaryKernel {
@@ -225,4 +229,15 @@ class MsbS : public UnaryKernel {
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override;
 };
 
+// Only registered by protocols which implement OneHotA.
+class OneHotS : public UnaryWithBitsKernel {
+ public:
+  static constexpr char kName[] = "OneHotS";
+
+  Kind kind() const override { return Kind::kDynamic; }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in,
+                size_t num_classes) const override;
+};
+
 }  // namespace ppu::mpc
@@ -25,9 +25,9 @@ class A2P : public UnaryKernel {
  public:
   static constexpr char kName[] = "A2P";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Const(1); }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override { return util::K(); }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override;
 };
@@ -100,9 +100,9 @@ class MulAA : public BinaryKernel {
  public:
   static constexpr char kName[] = "MulAA";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Const(1); }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override { return util::K(); }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& lhs,
                 const ArrayRef& rhs) const override;
@@ -127,9 +127,9 @@ class MatMulAA : public MatmulKernel {
  public:
   static constexpr char kName[] = "MatMulAA";
 
-  util::CExpr latency() const override { return util::Const(0); }
-
-  util::CExpr comm() const override { return util::Const(0); }
+  // The comm grows with the M*N output elements, which the per-element cost
+  // expressions can not capture.
+  Kind kind() const override { return Kind::kDynamic; }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& A, const ArrayRef& B,
                 int64_t M, int64_t N, int64_t K) const override;
@@ -139,6 +139,9 @@ class MatMulAA : public MatmulKernel {
 // Share Truncation I, 5.1 Fixed-point Arithmetic, P13,
 // ABY3: A Mixed Protocol Framework for Machine Learning
 // - https://eprint.iacr.org/2018/403.pdf
+//
+// Note: only one point-to-point message from rank 1 to rank 0, which is not
+// counted by the cost model, see Communicator::Stats.
 class TruncPrA : public UnaryWithBitsKernel {
  public:
   static constexpr char kName[] = "TruncPrA";
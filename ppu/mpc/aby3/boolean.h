@@ -26,9 +26,9 @@ class B2P : public UnaryKernel {
  public:
   static constexpr char kName[] = "B2P";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Const(1); }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override { return util::K(); }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override;
 };
@@ -60,9 +60,9 @@ class AndBB : public BinaryKernel {
  public:
   static constexpr char kName[] = "AndBB";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Const(1); }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override { return util::K(); }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& lhs,
                 const ArrayRef& rhs) const override;
@@ -15,6 +15,8 @@
 
 #include "ppu/mpc/aby3/conversion.h"
 
+#include <algorithm>
+
 #include "xtensor/xarray.hpp"
 #include "xtensor/xcomplex.hpp"
 #include "xtensor/xvectorize.hpp"
@@ -28,36 +30,29 @@
 #include "ppu/mpc/prg_state.h"
 #include "ppu/mpc/util/circuits.h"
 #include "ppu/mpc/util/communicator.h"
+#include "ppu/mpc/util/ring_ops.h"
 
 namespace ppu::mpc::aby3 {
 
-// Referrence:
-// ABY3: A Mixed Protocol Framework for Machine Learning
-// P16 5.3 Share Conversions, Bit Decomposition
-// https://eprint.iacr.org/2018/403.pdf
+namespace {
+
+// Split an arithmetic share into two boolean shares (m, n), where x = m + n.
 //
-// Latency: 2 + log(nbits) from 1 rotate and 1 ppa.
+// Let
+//   X = [(x0, x1), (x1, x2), (x2, x0)] as input.
+//   Z = (z0, z1, z2) as boolean zero share.
 //
-// See:
-// https://github.com/tf-encrypted/tf-encrypted/blob/master/tf_encrypted/protocol/aby3/aby3.py#L2889
-ArrayRef A2B::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
-  PPU_TRACE_OP(this, in);
-
+// Construct
+//   M = [((x0+x1)^z0, z1) (z1, z2), (z2, (x0+x1)^z0)]
+//   N = [(0, 0), (0, x2), (x2, 0)]
+std::pair<ArrayRef, ArrayRef> A2BSplit(KernelEvalContext* ctx,
+                                       const ArrayRef& in,
+                                       std::string_view tag) {
   const auto field = in.eltype().as<Ring2k>()->field();
   auto* comm = ctx->caller()->getState<Communicator>();
   auto* prg_state = ctx->caller()->getState<PrgState>();
-  auto boolean = ctx->caller()->getInterface<IBoolean>();
 
-  // Let
-  //   X = [(x0, x1), (x1, x2), (x2, x0)] as input.
-  //   Z = (z0, z1, z2) as boolean zero share.
-  //
-  // Construct
-  //   M = [((x0+x1)^z0, z1) (z1, z2), (z2, (x0+x1)^z0)]
-  //   N = [(0, 0), (0, x2), (x2, 0)]
-  // Then
-  //   Y = PPA(M, N) as the output.
-  return DISPATCH_ALL_FIELDS(field, kName, [&]() {
+  return DISPATCH_ALL_FIELDS(field, "A2BSplit", [&]() {
     using share_t = Share<ring2k_t>;
 
     // in
@@ -86,13 +81,77 @@ ArrayRef A2B::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
     } else if (comm->getRank() == 2) {
       n1 = x1;
     }
-    m2 = comm->rotate(m1, _kName);
+    m2 = comm->rotate(m1, tag);
 
     // Shr(x) = [in1, in2, 0]
     // Shr(y) = [0, 0, in3]
     auto ty = makeType<BShrTy>(field);
-    return boolean->AddBB(make_array(m, ty), make_array(n, ty));
+    return std::make_pair(make_array(m, ty), make_array(n, ty));
+  });
+}
+
+// Cast both pieces of each share to the ring of `to_type`, pieces are
+// truncated or zero-extended.
+ArrayRef CastShare(const ArrayRef& in, const Type& to_type,
+                   std::string_view tag) {
+  const auto field = in.eltype().as<Ring2k>()->field();
+  const auto to_field = to_type.as<Ring2k>()->field();
+
+  ArrayRef out(to_type, in.numel());
+  DISPATCH_ALL_FIELDS(field, tag, [&]() {
+    using FromU = typename std::make_unsigned<ring2k_t>::type;
+    const auto _in = xt_adapt<Share<ring2k_t>>(in);
+
+    DISPATCH_ALL_FIELDS(to_field, tag, [&]() {
+      using ToU = typename std::make_unsigned<ring2k_t>::type;
+      auto _out = xt_mutable_adapt<Share<ring2k_t>>(out);
+
+      const auto cast = [](auto v) {
+        return static_cast<ring2k_t>(static_cast<ToU>(static_cast<FromU>(v)));
+      };
+      for (int64_t idx = 0; idx < in.numel(); idx++) {
+        const auto& x = _in(idx);
+        _out(idx) = Share<ring2k_t>(cast(x.real()), cast(x.imag()));
+      }
+    });
   });
+  return out;
+}
+
+}  // namespace
+
+// Referrence:
+// ABY3: A Mixed Protocol Framework for Machine Learning
+// P16 5.3 Share Conversions, Bit Decomposition
+// https://eprint.iacr.org/2018/403.pdf
+//
+// Latency: 2 + log(nbits) from 1 rotate and 1 ppa.
+//
+// See:
+// https://github.com/tf-encrypted/tf-encrypted/blob/master/tf_encrypted/protocol/aby3/aby3.py#L2889
+ArrayRef A2B::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
+  PPU_TRACE_OP(this, in);
+
+  auto boolean = ctx->caller()->getInterface<IBoolean>();
+
+  auto [m, n] = A2BSplit(ctx, in, kName);
+  return boolean->AddBB(m, n);
+}
+
+// Latency: 2 + log(nbits) from 1 rotate and 1 carry-out circuit.
+ArrayRef MsbA::proc(KernelEvalContext* ctx, const ArrayRef& in) const {
+  PPU_TRACE_OP(this, in);
+
+  const auto field = in.eltype().as<Ring2k>()->field();
+  auto boolean = ctx->caller()->getInterface<IBoolean>();
+
+  auto [m, n] = A2BSplit(ctx, in, kName);
+
+  // msb(x) = msb(m) ^ msb(n) ^ carry
+  auto carry =
+      CarryOutCircuit<ArrayRef>(m, n, makeBooleanCbb(boolean, field));
+  auto msb = boolean->RShiftB(boolean->XorBB(m, n), SizeOf(field) * 8 - 1);
+  return boolean->XorBB(msb, carry);
 }
 
 // Referrence:
@@ -241,28 +300,28 @@ ArrayRef AddBB::proc(KernelEvalContext* ctx, const ArrayRef& lhs,
 
   const auto field = lhs.eltype().as<Ring2k>()->field();
   auto boolean = ctx->caller()->getInterface<IBoolean>();
-  return DISPATCH_ALL_FIELDS(field, kName, [&]() {
-    using share_t = Share<ring2k_t>;
+  return KoggleStoneAdder<ArrayRef>(lhs, rhs, makeBooleanCbb(boolean, field));
+}
 
-    CircuitBasicBlock<ArrayRef> cbb;
-    {
-      cbb.num_bits = sizeof(share_t) * 8;
-      cbb._xor = [&](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
-        return boolean->XorBB(lhs, rhs);
-      };
-      cbb._and = [&](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
-        return boolean->AndBB(lhs, rhs);
-      };
-      cbb.lshift = [&](ArrayRef const& x, size_t bits) -> ArrayRef {
-        return boolean->LShiftB(x, bits);
-      };
-      cbb.rshift = [&](ArrayRef const& x, size_t bits) -> ArrayRef {
-        return boolean->RShiftB(x, bits);
-      };
-    }
+ArrayRef CastDownA::proc(KernelEvalContext* ctx, const ArrayRef& in,
+                         FieldType to_field) const {
+  PPU_TRACE_OP(this, in);
 
-    return KoggleStoneAdder<ArrayRef>(lhs, rhs, cbb);
-  });
+  const auto field = in.eltype().as<Ring2k>()->field();
+  PPU_ENFORCE(SizeOf(to_field) <= SizeOf(field),
+              "can not cast arithmetic share from {} up to {}", field,
+              to_field);
+  return CastShare(in, makeType<AShrTy>(to_field), kName);
+}
+
+ArrayRef CastB::proc(KernelEvalContext* ctx, const ArrayRef& in,
+                     FieldType to_field) const {
+  PPU_TRACE_OP(this, in);
+
+  const size_t nbits = in.eltype().as<BShrTy>()->nbits();
+  return CastShare(
+      in, makeType<BShrTy>(to_field, std::min(nbits, SizeOf(to_field) * 8)),
+      kName);
 }
 
 }  // namespace ppu::mpc::aby3
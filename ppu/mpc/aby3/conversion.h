@@ -33,9 +33,30 @@ class A2B : public UnaryKernel {
  public:
   static constexpr char kName[] = "A2B";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Log(util::K()) + 2; }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override {
+    return (2 * util::Log(util::K()) + 2) * util::K();
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override;
+};
+
+// Extract the msb of an arithmetic share, result a boolean share.
+//
+// Same as A2B, but only the carry into the msb is computed with
+// CarryOutCircuit instead of a full KoggleStoneAdder.
+//
+// Latency: 2 + log(nbits) from 1 rotate and 1 carry-out circuit.
+class MsbA : public UnaryKernel {
+ public:
+  static constexpr char kName[] = "MsbA";
+
+  util::CExpr latency() const override { return util::Log(util::K()) + 2; }
+
+  util::CExpr comm() const override {
+    return (util::Log(util::K()) + 2) * util::K();
+  }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override;
 };
@@ -46,13 +67,18 @@ class A2B : public UnaryKernel {
 //
 // Latency: 4 + log(nbits) - 3 rotate + 1 send/rec + 1 ppa.
 // TODO(junfeng): Optimize anount of comm.
+//
+// Note: the cost model only counts the collective part, the send/rec from
+// rank 2 to rank 0 is point-to-point, see Communicator::Stats.
 class B2A : public UnaryKernel {
  public:
   static constexpr char kName[] = "B2A";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Log(util::K()) + 4; }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override {
+    return (2 * util::Log(util::K()) + 4) * util::K();
+  }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x) const override;
 };
@@ -74,16 +100,59 @@ class B2AByOT : public UnaryWithBitsKernel {
                 size_t valid_bits) const override;
 };
 
+// Kogge-Stone adder over the k bits of the field, which requires log(k)
+// levels.
 class AddBB : public BinaryKernel {
  public:
   static constexpr char kName[] = "AddBB";
 
-  util::CExpr latency() const override { return util::Const(0); }
+  util::CExpr latency() const override { return util::Log(util::K()) + 1; }
 
-  util::CExpr comm() const override { return util::Const(0); }
+  util::CExpr comm() const override {
+    return (2 * util::Log(util::K()) + 1) * util::K();
+  }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& lhs,
                 const ArrayRef& rhs) const override;
 };
 
+// Reduce an arithmetic share to a narrower ring locally.
+//
+// Both pieces are reduced mod 2^k', which is a sharing of x mod 2^k'.
+class CastDownA : public Kernel {
+ public:
+  static constexpr char kName[] = "CastDownA";
+
+  util::CExpr latency() const override { return util::Const(0); }
+
+  util::CExpr comm() const override { return util::Const(0); }
+
+  void evaluate(KernelEvalContext* ctx) const override {
+    ctx->setOutput(
+        proc(ctx, ctx->getParam<ArrayRef>(0), ctx->getParam<FieldType>(1)));
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in,
+                FieldType to_field) const;
+};
+
+// Convert a boolean share to another ring locally, both pieces are
+// truncated or zero-extended.
+class CastB : public Kernel {
+ public:
+  static constexpr char kName[] = "CastB";
+
+  util::CExpr latency() const override { return util::Const(0); }
+
+  util::CExpr comm() const override { return util::Const(0); }
+
+  void evaluate(KernelEvalContext* ctx) const override {
+    ctx->setOutput(
+        proc(ctx, ctx->getParam<ArrayRef>(0), ctx->getParam<FieldType>(1)));
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in,
+                FieldType to_field) const;
+};
+
 }  // namespace ppu::mpc::aby3
@@ -26,32 +26,39 @@ std::vector<NdArrayRef> Aby3Io::makeSecret(const NdArrayRef& raw) const {
 
   std::vector<NdArrayRef> shares;
   for (std::size_t i = 0; i < 3; i++) {
-    auto buf =
-        shares.emplace_back(makeType<AShrTy>(field), splits[i].shape()).buf();
-    {
-      const auto& x1 = splits[i];
-      const auto& x2 = splits[(i + 1) % 3];
+    shares.push_back(
+        makeShareFromSplits({splits[i], splits[(i + 1) % 3]}, field));
+  }
+  return shares;
+}
 
-      PPU_ENFORCE(buf->size() == x1.buf()->size() + x2.buf()->size());
-      PPU_ENFORCE(x1.elsize() == x2.elsize());
+NdArrayRef Aby3Io::makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                       FieldType field) const {
+  PPU_ENFORCE(splits.size() == 2, "expect 2 splits, got={}", splits.size());
+  const auto& x1 = splits[0];
+  const auto& x2 = splits[1];
 
-      size_t x1_offset = 0;
-      size_t x2_offset = 0;
-      size_t buf_offset = 0;
-      size_t elsize = x1.elsize();
-      for (int64_t idx = 0; idx < x1.numel(); ++idx) {
-        std::memcpy(buf->data<char>() + buf_offset,
-                    x1.buf()->data<char>() + x1_offset, elsize);
-        buf_offset += elsize;
-        x1_offset += elsize;
-        std::memcpy(buf->data<char>() + buf_offset,
-                    x2.buf()->data<char>() + x2_offset, elsize);
-        buf_offset += elsize;
-        x2_offset += elsize;
-      }
-    }
+  NdArrayRef share(makeType<AShrTy>(field), x1.shape());
+  auto buf = share.buf();
+
+  PPU_ENFORCE(buf->size() == x1.buf()->size() + x2.buf()->size());
+  PPU_ENFORCE(x1.elsize() == x2.elsize());
+
+  size_t x1_offset = 0;
+  size_t x2_offset = 0;
+  size_t buf_offset = 0;
+  size_t elsize = x1.elsize();
+  for (int64_t idx = 0; idx < x1.numel(); ++idx) {
+    std::memcpy(buf->data<char>() + buf_offset,
+                x1.buf()->data<char>() + x1_offset, elsize);
+    buf_offset += elsize;
+    x1_offset += elsize;
+    std::memcpy(buf->data<char>() + buf_offset,
+                x2.buf()->data<char>() + x2_offset, elsize);
+    buf_offset += elsize;
+    x2_offset += elsize;
   }
-  return shares;
+  return share;
 }
 
 NdArrayRef Aby3Io::reconstructSecret(
@@ -27,6 +27,15 @@ class Aby3Io final : public RingIo {
 
   NdArrayRef reconstructSecret(
       const std::vector<NdArrayRef>& shares) const override;
+
+ protected:
+  // party i holds splits (i, i+1).
+  std::vector<size_t> splitsOf(size_t rank) const override {
+    return {rank, (rank + 1) % 3};
+  }
+
+  NdArrayRef makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                 FieldType field) const override;
 };
 
 std::unique_ptr<Aby3Io> makeAby3Io(size_t npc);
@@ -95,7 +95,10 @@ std::unique_ptr<Object> makeAby3Protocol(
   obj->regKernel<aby3::P2B>();
   obj->regKernel<aby3::AddBB>();
   obj->regKernel<aby3::A2B>();
+  obj->regKernel<aby3::MsbA>();
   obj->regKernel<aby3::B2A>();
+  obj->regKernel<aby3::CastDownA>();
+  obj->regKernel<aby3::CastB>();
   obj->regKernel<aby3::AndBP>();
   obj->regKernel<aby3::AndBB>();
   obj->regKernel<aby3::XorBP>();
@@ -20,6 +20,7 @@
 #include "ppu/core/array_ref_util.h"
 #include "ppu/mpc/interfaces.h"
 #include "ppu/mpc/util/communicator.h"
+#include "ppu/mpc/util/ring_ops.h"
 #include "ppu/mpc/util/test_util.h"
 
 namespace ppu::mpc::test {
@@ -101,4 +102,119 @@ const std::vector<size_t> kShiftBits = {0, 1, 2, 31, 32, 33, 64, 1000};
 TEST_ARITHMETIC_BINARY_OP(Add)
 TEST_ARITHMETIC_BINARY_OP(Mul)
 
+TEST_P(ArithmeticTest, MsbA) {
+  const auto factory = std::get<0>(GetParam());
+  const size_t npc = std::get<1>(GetParam());
+  const FieldType field = std::get<2>(GetParam());
+
+  test::Eval(npc, [&](std::shared_ptr<link::Context> lctx) {
+    auto obj = factory(lctx);
+    if (!obj->hasKernel("MsbA")) {
+      return;
+    }
+
+    auto arithmetic = obj->getInterface<IArithmetic>();
+    auto boolean = obj->getInterface<IBoolean>();
+    auto compute = obj->getInterface<ICompute>();
+    auto rnd = obj->getInterface<IRandom>();
+
+    /* GIVEN */
+    auto p0 = rnd->RandP(field, numel(kShape));
+
+    /* WHEN */
+    auto a0 = arithmetic->P2A(p0);
+    auto prev = obj->getState<Communicator>()->getStats();
+    auto b0 = arithmetic->MsbA(a0);
+    auto cost = obj->getState<Communicator>()->getStats() - prev;
+    auto re = boolean->B2P(b0);
+    auto rp = compute->MsbP(p0);
+
+    /* THEN */
+    EXPECT_TRUE(RingEqual(re, rp));
+    EXPECT_TRUE(VerifyCost(obj->getKernel("MsbA"), "MsbA", field,
+                           numel(kShape), npc, cost));
+  });
+}
+
+TEST_P(ArithmeticTest, OneHotA) {
+  const auto factory = std::get<0>(GetParam());
+  const size_t npc = std::get<1>(GetParam());
+  const FieldType field = std::get<2>(GetParam());
+  const size_t kNumClasses = 20;
+
+  test::Eval(npc, [&](std::shared_ptr<link::Context> lctx) {
+    auto obj = factory(lctx);
+    // dpf output is at most 64 bits.
+    if (!obj->hasKernel("OneHotA") || SizeOf(field) > 8) {
+      return;
+    }
+
+    auto arithmetic = obj->getInterface<IArithmetic>();
+    auto rnd = obj->getInterface<IRandom>();
+
+    /* GIVEN */
+    auto p0 = rnd->RandP(field, numel(kShape));
+    // indices in [0, 16)
+    auto idx = ring_rshift(p0, SizeOf(field) * 8 - 4).as(p0.eltype());
+
+    /* WHEN */
+    auto prev = obj->getState<Communicator>()->getStats();
+    auto r = arithmetic->OneHotA(arithmetic->P2A(idx), kNumClasses);
+    auto cost = obj->getState<Communicator>()->getStats() - prev;
+    auto re = arithmetic->A2P(r);
+
+    /* THEN */
+    ASSERT_EQ(re.numel(), numel(kShape) * kNumClasses);
+    DISPATCH_ALL_FIELDS(field, "_", [&]() {
+      const auto& _idx = xt_adapt<ring2k_t>(idx);
+      const auto& _re = xt_adapt<ring2k_t>(re);
+      for (int64_t i = 0; i < numel(kShape); i++) {
+        for (size_t j = 0; j < kNumClasses; j++) {
+          EXPECT_EQ(_re[i * kNumClasses + j], ring2k_t(j == _idx[i] ? 1 : 0));
+        }
+      }
+    });
+    EXPECT_TRUE(VerifyCost(obj->getKernel("OneHotA"), "OneHotA", field,
+                           numel(kShape), npc, cost));
+  });
+}
+
+TEST_P(ArithmeticTest, KernelProfile) {
+  const auto factory = std::get<0>(GetParam());
+  const size_t npc = std::get<1>(GetParam());
+  const FieldType field = std::get<2>(GetParam());
+
+  test::Eval(npc, [&](std::shared_ptr<link::Context> lctx) {
+    auto obj = factory(lctx);
+    auto arithmetic = obj->getInterface<IArithmetic>();
+    auto rnd = obj->getInterface<IRandom>();
+
+    /* GIVEN */
+    auto p0 = rnd->RandP(field, numel(kShape));
+    auto p1 = rnd->RandP(field, numel(kShape));
+    auto a0 = arithmetic->P2A(p0);
+    auto a1 = arithmetic->P2A(p1);
+
+    /* WHEN */
+    obj->enableProfile(true);
+    auto prev = obj->getState<Communicator>()->getStats();
+    arithmetic->MulAA(a0, a1);
+    arithmetic->MulAA(a0, a1);
+    auto cost = obj->getState<Communicator>()->getStats() - prev;
+    obj->enableProfile(false);
+    arithmetic->MulAA(a0, a1);
+
+    /* THEN */
+    const auto& profiles = obj->getProfiles();
+    const auto itr = profiles.find("MulAA");
+    ASSERT_TRUE(itr != profiles.end());
+    EXPECT_EQ(itr->second.num_calls, 2);
+    EXPECT_EQ(itr->second.latency, cost.latency);
+    EXPECT_EQ(itr->second.comm, cost.comm);
+    EXPECT_GE(itr->second.sent_bytes, cost.comm);
+    EXPECT_GE(itr->second.wall_time, itr->second.compute_time);
+    EXPECT_TRUE(profiles.find("P2A") == profiles.end());
+  });
+}
+
 }  // namespace ppu::mpc::test
@@ -15,7 +15,26 @@
 
 #include "ppu/mpc/base2k/ring_io.h"
 
+#include "ppu/crypto/symmetric_crypto.h"
+#include "ppu/utils/rand.h"
+
 namespace ppu::mpc {
+namespace {
+
+NdArrayRef expandSeed(uint128_t seed, FieldType field,
+                      const std::vector<int64_t>& shape) {
+  constexpr SymmetricCrypto::CryptoType kCryptoType =
+      SymmetricCrypto::CryptoType::AES128_ECB;
+  constexpr uint128_t kAesInitialVector = 0U;
+
+  NdArrayRef arr(makePtType(GetStorageType(field)), shape);
+  FillPseudoRandom(
+      kCryptoType, seed, kAesInitialVector, 0,
+      absl::MakeSpan(static_cast<char*>(arr.data()), arr.buf()->size()));
+  return arr;
+}
+
+}  // namespace
 
 std::vector<NdArrayRef> RingIo::makePublic(const NdArrayRef& raw) const {
   const auto field = raw.eltype().as<Ring2k>()->field();
@@ -57,4 +76,59 @@ std::vector<NdArrayRef> RingIo::randAdditiveSplits(
   return splits;
 }
 
+std::vector<SeededShare> RingIo::makeSeededSecret(const NdArrayRef& raw,
+                                                  size_t owner) const {
+  PPU_ENFORCE(owner < world_size_, "owner={} out of range={}", owner,
+              world_size_);
+
+  const auto field = raw.eltype().as<Ring2k>()->field();
+  const Type int_ty = makePtType(GetStorageType(field));
+  const size_t correction_index = splitsOf(owner).front();
+
+  // correction = raw - sum(seeded splits)
+  std::vector<uint128_t> seeds(world_size_, 0);
+  NdArrayRef correction = raw.as(int_ty);
+  for (size_t idx = 0; idx < world_size_; idx++) {
+    if (idx == correction_index) {
+      continue;
+    }
+    seeds[idx] = utils::RandSeed();
+    correction = sub(correction, expandSeed(seeds[idx], field, raw.shape()));
+  }
+
+  std::vector<SeededShare> shares(world_size_);
+  for (size_t rank = 0; rank < world_size_; rank++) {
+    auto& share = shares[rank];
+    share.correction_index = correction_index;
+    for (size_t idx : splitsOf(rank)) {
+      if (idx == correction_index) {
+        share.correction = correction;
+      } else {
+        share.seeds.emplace(idx, seeds[idx]);
+      }
+    }
+  }
+  return shares;
+}
+
+NdArrayRef RingIo::expandSeededSecret(const SeededShare& share, size_t rank,
+                                      FieldType field,
+                                      const std::vector<int64_t>& shape) const {
+  std::vector<NdArrayRef> splits;
+  for (size_t idx : splitsOf(rank)) {
+    if (idx == share.correction_index) {
+      PPU_ENFORCE(share.correction.has_value(),
+                  "rank={} depends on the correction, which is missing", rank);
+      PPU_ENFORCE(share.correction->shape() == shape);
+      splits.push_back(*share.correction);
+    } else {
+      const auto itr = share.seeds.find(idx);
+      PPU_ENFORCE(itr != share.seeds.end(), "rank={} misses seed of split={}",
+                  rank, idx);
+      splits.push_back(expandSeed(itr->second, field, shape));
+    }
+  }
+  return makeShareFromSplits(splits, field);
+}
+
 }  // namespace ppu::mpc
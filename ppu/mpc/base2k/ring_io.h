@@ -30,12 +30,27 @@ class RingIo : public IoInterface {
 
   std::vector<NdArrayRef> randAdditiveSplits(const NdArrayRef& arr) const;
 
+  // indices of the additive splits which the share of `rank` depends on.
+  virtual std::vector<size_t> splitsOf(size_t rank) const { return {rank}; }
+
+  // make the share of a party from the splits it depends on, in the order of
+  // splitsOf.
+  virtual NdArrayRef makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                         FieldType field) const = 0;
+
  public:
   RingIo(size_t world_size) : world_size_(world_size) {}
 
   std::vector<NdArrayRef> makePublic(const NdArrayRef& raw) const override;
 
   NdArrayRef reconstruct(const std::vector<NdArrayRef>& shares) const override;
+
+  std::vector<SeededShare> makeSeededSecret(const NdArrayRef& raw,
+                                            size_t owner) const override;
+
+  NdArrayRef expandSeededSecret(
+      const SeededShare& share, size_t rank, FieldType field,
+      const std::vector<int64_t>& shape) const override;
 };
 
 }  // namespace ppu::mpc
@@ -15,7 +15,11 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "ppu/core/array_ref.h"
+#include "ppu/crypto/dpf/dpf.h"
 
 namespace ppu::mpc {
 
@@ -24,6 +28,7 @@ class Beaver {
  public:
   using Triple = std::tuple<ArrayRef, ArrayRef, ArrayRef>;
   using Pair = std::pair<ArrayRef, ArrayRef>;
+  using DpfKeys = std::pair<ArrayRef, std::vector<crypto::DpfKey>>;
 
  public:
   virtual ~Beaver() = default;
@@ -39,6 +44,14 @@ class Beaver {
 
   // Return size of random bits, with given field.
   virtual ArrayRef RandBit(FieldType field, size_t size) = 0;
+
+  // Return shares of size random points r, and this party's dpf keys of the
+  // one-hot vectors e_(r mod 2^domain_bits), one key per point.
+  // Only for 2PC, dpf keys are two-party by construction.
+  virtual DpfKeys DpfOneHot(FieldType field, size_t size, size_t domain_bits) {
+    PPU_THROW("DpfOneHot not supported, size={}, domain_bits={}", size,
+              domain_bits);
+  }
 };
 
 }  // namespace ppu::mpc
@@ -60,6 +60,8 @@ void BeaverCheetah::set_primitives(
 }
 
 Beaver::Triple BeaverCheetah::Mul(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Mul");
+
   std::vector<PrgArrayDesc> descs(3);
 
   auto a = prgCreateArray(field, size, seed_, &counter_, &descs[0]);
@@ -75,6 +77,8 @@ Beaver::Triple BeaverCheetah::Mul(FieldType field, size_t size) {
 
 Beaver::Triple BeaverCheetah::Dot(FieldType field, size_t M, size_t N,
                                   size_t K) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Dot");
+
   std::vector<PrgArrayDesc> descs(3);
 
   auto a = prgCreateArray(field, M * K, seed_, &counter_, &descs[0]);
@@ -89,6 +93,8 @@ Beaver::Triple BeaverCheetah::Dot(FieldType field, size_t M, size_t N,
 }
 
 Beaver::Triple BeaverCheetah::And(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "And");
+
   ArrayRef a(makeType<RingTy>(field), size);
   ArrayRef b(makeType<RingTy>(field), size);
   ArrayRef c(makeType<RingTy>(field), size);
@@ -101,6 +107,8 @@ Beaver::Triple BeaverCheetah::And(FieldType field, size_t size) {
 }
 
 Beaver::Pair BeaverCheetah::Trunc(FieldType field, size_t size, size_t bits) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Trunc");
+
   std::vector<PrgArrayDesc> descs(2);
 
   auto a = prgCreateArray(field, size, seed_, &counter_, &descs[0]);
@@ -114,6 +122,8 @@ Beaver::Pair BeaverCheetah::Trunc(FieldType field, size_t size, size_t bits) {
 }
 
 ArrayRef BeaverCheetah::RandBit(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "RandBit");
+
   PrgArrayDesc desc{};
   auto a = prgCreateArray(field, size, seed_, &counter_, &desc);
 
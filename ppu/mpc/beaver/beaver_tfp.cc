@@ -18,14 +18,19 @@
 #include <random>
 
 #include "ppu/core/array_ref_util.h"
+#include "ppu/core/type_util.h"
 #include "ppu/link/link.h"
 #include "ppu/mpc/beaver/prg_tensor.h"
 #include "ppu/mpc/util/ring_ops.h"
+#include "ppu/utils/parallel.h"
 #include "ppu/utils/serialize.h"
 
 namespace ppu::mpc {
 namespace {
 
+// dpf keys generated per parallel task.
+constexpr int64_t kDpfGenGrainSize = 64;
+
 uint128_t GetHardwareRandom128() {
   std::random_device rd;
   // call random_device four times, make sure uint128 is random in 2^128 set.
@@ -52,6 +57,8 @@ BeaverTfp::BeaverTfp(std::shared_ptr<link::Context> lctx)
 }
 
 Beaver::Triple BeaverTfp::Mul(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Mul");
+
   std::vector<PrgArrayDesc> descs(3);
 
   auto a = prgCreateArray(field, size, seed_, &counter_, &descs[0]);
@@ -66,6 +73,8 @@ Beaver::Triple BeaverTfp::Mul(FieldType field, size_t size) {
 }
 
 Beaver::Triple BeaverTfp::Dot(FieldType field, size_t M, size_t N, size_t K) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Dot");
+
   std::vector<PrgArrayDesc> descs(3);
 
   auto a = prgCreateArray(field, M * K, seed_, &counter_, &descs[0]);
@@ -80,6 +89,8 @@ Beaver::Triple BeaverTfp::Dot(FieldType field, size_t M, size_t N, size_t K) {
 }
 
 Beaver::Triple BeaverTfp::And(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "And");
+
   std::vector<PrgArrayDesc> descs(3);
 
   auto a = prgCreateArray(field, size, seed_, &counter_, &descs[0]);
@@ -94,6 +105,8 @@ Beaver::Triple BeaverTfp::And(FieldType field, size_t size) {
 }
 
 Beaver::Pair BeaverTfp::Trunc(FieldType field, size_t size, size_t bits) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "Trunc");
+
   std::vector<PrgArrayDesc> descs(2);
 
   auto a = prgCreateArray(field, size, seed_, &counter_, &descs[0]);
@@ -107,6 +120,8 @@ Beaver::Pair BeaverTfp::Trunc(FieldType field, size_t size, size_t bits) {
 }
 
 ArrayRef BeaverTfp::RandBit(FieldType field, size_t size) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "RandBit");
+
   PrgArrayDesc desc{};
   auto a = prgCreateArray(field, size, seed_, &counter_, &desc);
 
@@ -117,4 +132,54 @@ ArrayRef BeaverTfp::RandBit(FieldType field, size_t size) {
   return a;
 }
 
+Beaver::DpfKeys BeaverTfp::DpfOneHot(FieldType field, size_t size,
+                                     size_t domain_bits) {
+  PPU_TIMELINE_SCOPE(lctx_->GetTimeline().get(), "beaver", "DpfOneHot");
+  PPU_ENFORCE(lctx_->WorldSize() == 2, "dpf only supports 2PC, got={}",
+              lctx_->WorldSize());
+
+  const size_t ss_bits = SizeOf(field) * 8;
+  PPU_ENFORCE(ss_bits <= 64, "dpf output is at most 64 bits, got={}",
+              ss_bits);
+
+  PrgArrayDesc desc{};
+  auto r = prgCreateArray(field, size, seed_, &counter_, &desc);
+
+  std::vector<crypto::DpfKey> keys(size);
+  if (lctx_->Rank() == 0) {
+    // the trusted party knows r, deals keys of e_r and sends rank1's half.
+    const auto points = tp_.openRand(desc);
+
+    crypto::DpfContext dpf(domain_bits, ss_bits);
+    std::vector<Buffer> peer_keys(size);
+    DISPATCH_ALL_FIELDS(field, "DpfOneHot", [&]() {
+      const auto& _points = xt_adapt<ring2k_t>(points);
+      const auto mask = (crypto::DpfInStore(1) << domain_bits) - 1;
+      // keys are independent, each task fills its own slots.
+      parallel_for(0, size, kDpfGenGrainSize, [&](int64_t begin, int64_t end) {
+        for (int64_t idx = begin; idx < end; idx++) {
+          auto [k0, k1] =
+              dpf.Gen(static_cast<crypto::DpfInStore>(_points[idx]) & mask, 1,
+                      GetHardwareRandom128(), GetHardwareRandom128(), true);
+          const auto str = k1.Serialize();
+          peer_keys[idx] = Buffer(str.data(), str.size());
+          keys[idx] = std::move(k0);
+        }
+      });
+    });
+    lctx_->SendAsync(1, utils::SerializeArrayOfBuffers(peer_keys),
+                     "BEAVER_TFP:DPF_KEYS");
+  } else {
+    auto bufs = utils::DeserializeArrayOfBuffers(
+        lctx_->Recv(0, "BEAVER_TFP:DPF_KEYS"));
+    PPU_ENFORCE(bufs.size() == size);
+    for (size_t idx = 0; idx < size; idx++) {
+      keys[idx].Deserialize(
+          std::string(bufs[idx].data<char>(), bufs[idx].size()));
+    }
+  }
+
+  return {r, std::move(keys)};
+}
+
 }  // namespace ppu::mpc
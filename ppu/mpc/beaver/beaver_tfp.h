@@ -48,6 +48,9 @@ class BeaverTfp : public Beaver {
   Beaver::Pair Trunc(FieldType field, size_t size, size_t bits) override;
 
   ArrayRef RandBit(FieldType field, size_t size) override;
+
+  Beaver::DpfKeys DpfOneHot(FieldType field, size_t size,
+                            size_t domain_bits) override;
 };
 
 }  // namespace ppu::mpc
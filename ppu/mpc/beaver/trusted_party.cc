@@ -150,4 +150,10 @@ ArrayRef TrustedParty::adjustRandBit(const PrgArrayDesc& desc) {
   return r0[0];
 }
 
+ArrayRef TrustedParty::openRand(const PrgArrayDesc& desc) {
+  auto [r0, rs] = reconstruct(RecOp::ADD, getSeeds(), absl::MakeSpan(&desc, 1));
+  PPU_ENFORCE(r0.size() == 1 && rs.size() == 1);
+  return rs[0];
+}
+
 }  // namespace ppu::mpc
@@ -44,6 +44,9 @@ class TrustedParty {
   ArrayRef adjustTrunc(absl::Span<const PrgArrayDesc> descs, size_t bits);
 
   ArrayRef adjustRandBit(const PrgArrayDesc& descs);
+
+  // Return the plaintext of an additive shared random array.
+  ArrayRef openRand(const PrgArrayDesc& desc);
 };
 
 }  // namespace ppu::mpc
@@ -53,9 +53,8 @@ class TruncPrA : public UnaryWithBitsKernel {
  public:
   static constexpr char kName[] = "TruncPrA";
 
-  util::CExpr latency() const override { return Const(0); }
-
-  util::CExpr comm() const override { return Const(0); }
+  // The cost depends on the underlying OT/HE primitives.
+  Kind kind() const override { return Kind::kDynamic; }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in,
                 size_t bits) const override;
@@ -65,9 +64,8 @@ class MsbA : public UnaryKernel {
  public:
   static constexpr char kName[] = "MsbA";
 
-  util::CExpr latency() const override { return Const(0); }
-
-  util::CExpr comm() const override { return Const(0); }
+  // The cost depends on the underlying OT/HE primitives.
+  Kind kind() const override { return Kind::kDynamic; }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x) const override;
 };
@@ -42,6 +42,12 @@ NdArrayRef CheetahIo::reconstructSecret(
   return sum(encoded).as(makeType<RingTy>(field));
 }
 
+NdArrayRef CheetahIo::makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                          FieldType field) const {
+  PPU_ENFORCE(splits.size() == 1, "expect 1 split, got={}", splits.size());
+  return splits[0].as(makeType<semi2k::AShrTy>(field));
+}
+
 std::unique_ptr<CheetahIo> makeCheetahIo(size_t npc) {
   semi2k::registerTypes();
   return std::make_unique<CheetahIo>(npc);
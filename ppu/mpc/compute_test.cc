@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 
 #include "ppu/core/array_ref_util.h"
+#include "ppu/mpc/abkernels.h"
 #include "ppu/mpc/interfaces.h"
 #include "ppu/mpc/util/communicator.h"
 #include "ppu/mpc/util/test_util.h"
@@ -224,6 +225,34 @@ TEST_P(ComputeTest, TruncPrS) {
   });
 }
 
+TEST_P(ComputeTest, MsbS_NarrowField) {
+  const auto factory = std::get<0>(GetParam());
+  const size_t npc = std::get<1>(GetParam());
+  const FieldType field = std::get<2>(GetParam());
+
+  test::Eval(npc, [&](std::shared_ptr<link::Context> lctx) {
+    auto obj = factory(lctx);
+    if (field == FieldType::FM32 || !obj->hasState<ABState>()) {
+      return;
+    }
+    obj->getState<ABState>()->msb_field = FieldType::FM32;
+    auto compute = obj->getInterface<ICompute>();
+
+    /* GIVEN */
+    auto pos = test::RandP(field, numel(kShape), /*seed*/ 0, /*min*/ 0,
+                           /*max*/ 10000);
+
+    for (const auto& p0 : {pos, compute->NegP(pos)}) {
+      /* WHEN */
+      auto r_s = compute->S2P(compute->MsbS(compute->P2S(p0)));
+      auto r_p = compute->MsbP(p0);
+
+      /* THEN */
+      EXPECT_TRUE(RingEqual(r_s, r_p));
+    }
+  });
+}
+
 TEST_P(ComputeTest, MatMulSS) {
   const auto factory = std::get<0>(GetParam());
   const size_t npc = std::get<1>(GetParam());
@@ -15,6 +15,36 @@
 
 #include "ppu/mpc/interfaces.h"
 
+#include "ppu/core/array_ref_util.h"
+#include "ppu/mpc/util/ring_ops.h"
+
 namespace ppu::mpc {
-//
+
+CircuitBasicBlock<ArrayRef> makeBooleanCbb(IBoolean* boolean,
+                                           FieldType field) {
+  CircuitBasicBlock<ArrayRef> cbb;
+  cbb.num_bits = SizeOf(field) * 8;
+  cbb._xor = [=](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
+    return boolean->XorBB(lhs, rhs);
+  };
+  cbb._and = [=](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
+    return boolean->AndBB(lhs, rhs);
+  };
+  cbb.lshift = [=](ArrayRef const& x, size_t bits) -> ArrayRef {
+    return boolean->LShiftB(x, bits);
+  };
+  cbb.rshift = [=](ArrayRef const& x, size_t bits) -> ArrayRef {
+    return boolean->RShiftB(x, bits);
+  };
+  cbb.and_const = [=](ArrayRef const& x, uint128_t c) -> ArrayRef {
+    auto mask = ring_zeros(field, x.numel());
+    DISPATCH_ALL_FIELDS(field, "and_const", [&]() {
+      auto mask_xt = xt_mutable_adapt<ring2k_t>(mask);
+      mask_xt += static_cast<ring2k_t>(c);
+    });
+    return boolean->AndBP(x, mask.as(makeType<Ring2kPublTy>(field)));
+  };
+  return cbb;
+}
+
 }  // namespace ppu::mpc
@@ -16,33 +16,45 @@
 #pragma once
 
 #include "ppu/mpc/object.h"
+#include "ppu/mpc/util/circuits.h"
 
 namespace ppu::mpc {
 
-#define METHOD0(NAME, R0) \
-  R0 NAME() { return obj_->call(#NAME); }
-
-#define METHOD1(NAME, R0, P0) \
-  R0 NAME(const P0& p0) { return obj_->call(#NAME, p0); }
-
-#define METHOD2(NAME, R0, P0, P1) \
-  R0 NAME(const P0& p0, const P1& p1) { return obj_->call(#NAME, p0, p1); }
-
-#define METHOD3(NAME, R0, P0, P1, P2)                 \
-  R0 NAME(const P0& p0, const P1& p1, const P2& p2) { \
-    return obj_->call(#NAME, p0, p1, p2);             \
-  }
+// Each method interns a handle to its kernel, resolved on the first call.
+#define METHOD0(NAME, R0)                                \
+  R0 NAME() { return NAME##_handle_.call(obj_, #NAME); } \
+  KernelHandle NAME##_handle_;
+
+#define METHOD1(NAME, R0, P0)                                    \
+  R0 NAME(const P0& p0) {                                        \
+    return NAME##_handle_.call(obj_, #NAME, p0);                 \
+  }                                                              \
+  KernelHandle NAME##_handle_;
+
+#define METHOD2(NAME, R0, P0, P1)                                \
+  R0 NAME(const P0& p0, const P1& p1) {                          \
+    return NAME##_handle_.call(obj_, #NAME, p0, p1);             \
+  }                                                              \
+  KernelHandle NAME##_handle_;
+
+#define METHOD3(NAME, R0, P0, P1, P2)                            \
+  R0 NAME(const P0& p0, const P1& p1, const P2& p2) {            \
+    return NAME##_handle_.call(obj_, #NAME, p0, p1, p2);         \
+  }                                                              \
+  KernelHandle NAME##_handle_;
 
 #define METHOD4(NAME, R0, P0, P1, P2, P3)                           \
   R0 NAME(const P0& p0, const P1& p1, const P2& p2, const P3& p3) { \
-    return obj_->call(#NAME, p0, p1, p2, p3);                       \
-  }
+    return NAME##_handle_.call(obj_, #NAME, p0, p1, p2, p3);        \
+  }                                                                 \
+  KernelHandle NAME##_handle_;
 
 #define METHOD5(NAME, R0, P0, P1, P2, P3, P4)                     \
   R0 NAME(const P0& p0, const P1& p1, const P2& p2, const P3& p3, \
           const P4& p4) {                                         \
-    return obj_->call(#NAME, p0, p1, p2, p3, p4);                 \
-  }
+    return NAME##_handle_.call(obj_, #NAME, p0, p1, p2, p3, p4);  \
+  }                                                               \
+  KernelHandle NAME##_handle_;
 
 class IArithmetic : public Interface {
  public:
@@ -68,6 +80,9 @@ class IArithmetic : public Interface {
 
   // take msb.
   METHOD1(MsbA, ArrayRef, ArrayRef)
+
+  // one-hot encode, optional.
+  METHOD2(OneHotA, ArrayRef, ArrayRef, size_t)
 };
 
 class IBoolean : public Interface {
@@ -96,6 +111,9 @@ class IBoolean : public Interface {
   METHOD2(AddBB, ArrayRef, ArrayRef, ArrayRef)
 };
 
+// The boolean share ops as a circuit basic block over the k bits of `field`.
+CircuitBasicBlock<ArrayRef> makeBooleanCbb(IBoolean* boolean, FieldType field);
+
 class IRandom : public Interface {
  public:
   explicit IRandom(Object* obj) : Interface(obj) {}
@@ -165,6 +183,9 @@ class ICompute : public Interface {
 
   METHOD1(MsbP, ArrayRef, ArrayRef)
   METHOD1(MsbS, ArrayRef, ArrayRef)
+
+  // one-hot encode secret indices, optional, check hasKernel before use.
+  METHOD2(OneHotS, ArrayRef, ArrayRef, size_t)
 };
 
 }  // namespace ppu::mpc
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <map>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -22,6 +24,22 @@
 
 namespace ppu::mpc {
 
+// A seed-compressed secret share.
+//
+// Secret shares are derived from additive splits of the plaintext. A seeded
+// share carries the splits a party depends on as 16 byte PRG seeds, except
+// the correction split (plaintext minus the seeded ones) which carries data.
+struct SeededShare {
+  // split index -> PRG seed.
+  std::map<size_t, uint128_t> seeds;
+
+  // the split index of the correction.
+  size_t correction_index = 0;
+
+  // the correction, set only if the party depends on it.
+  std::optional<NdArrayRef> correction;
+};
+
 // The basic io interface of protocols.
 class IoInterface {
  public:
@@ -38,6 +56,22 @@ class IoInterface {
   virtual std::vector<NdArrayRef> makePublic(const NdArrayRef& raw) const = 0;
   virtual std::vector<NdArrayRef> makeSecret(const NdArrayRef& raw) const = 0;
 
+  // Make seed-compressed secret shares from plaintext.
+  //
+  // @param raw, a plaintext ndarray in ring2k space.
+  // @param owner, the party which holds the plaintext. The correction is
+  //        placed on a split the owner depends on, so as little data as
+  //        possible leaves the owner.
+  // @return a list of seeded shares, one per party.
+  virtual std::vector<SeededShare> makeSeededSecret(const NdArrayRef& raw,
+                                                    size_t owner) const = 0;
+
+  // Expand a seeded share to the share of `rank`, which is interchangeable
+  // with the corresponding element of makeSecret.
+  virtual NdArrayRef expandSeededSecret(
+      const SeededShare& share, size_t rank, FieldType field,
+      const std::vector<int64_t>& shape) const = 0;
+
   // Reconstruct shares into plaintext.
   //
   // @param shares, a list of secret shares.
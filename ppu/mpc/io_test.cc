@@ -73,4 +73,31 @@ TEST_P(IoTest, MakeSecretAndReconstruct) {
   EXPECT_TRUE(RingEqual(raw, result));
 }
 
+TEST_P(IoTest, MakeSeededSecretAndReconstruct) {
+  const auto create_io = std::get<0>(GetParam());
+  const size_t npc = std::get<1>(GetParam());
+  const FieldType field = std::get<2>(GetParam());
+
+  auto io = create_io(npc);
+
+  auto raw = RingRand(field);
+  for (size_t owner = 0; owner < npc; owner++) {
+    auto seeded = io->makeSeededSecret(raw, owner);
+    ASSERT_EQ(seeded.size(), npc);
+
+    // the owner keeps the correction.
+    EXPECT_TRUE(seeded[owner].correction.has_value());
+
+    std::vector<NdArrayRef> shares;
+    for (size_t rank = 0; rank < npc; rank++) {
+      shares.push_back(
+          io->expandSeededSecret(seeded[rank], rank, field, raw.shape()));
+    }
+    EXPECT_EQ(shares[0].eltype(), io->makeSecret(raw)[0].eltype());
+
+    auto result = io->reconstruct(shares);
+    EXPECT_TRUE(RingEqual(raw, result));
+  }
+}
+
 }  // namespace ppu::mpc
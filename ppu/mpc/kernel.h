@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <array>
+#include <type_traits>
 #include <variant>
 
 #include "ppu/core/array_ref.h"
@@ -28,12 +30,19 @@ class Object;
 
 // Helper class to instantiate kernel calls.
 class KernelEvalContext final {
+ public:
+  // Max number of kernel params, params are stored inline so a kernel call
+  // does not allocate.
+  static constexpr size_t kMaxParams = 5;
+
+ private:
   // Please keep param types as less as possible.
   using ParamType = std::variant<FieldType, size_t, int64_t, ArrayRef>;
 
   Object* caller_;
 
-  std::vector<ParamType> params_;
+  std::array<ParamType, kMaxParams> params_;
+  size_t num_params_ = 0;
   ArrayRef output_;
 
  public:
@@ -41,10 +50,14 @@ class KernelEvalContext final {
 
   template <typename T = Object>
   T* caller() {
-    if (auto caller = dynamic_cast<T*>(caller_)) {
-      return caller;
+    if constexpr (std::is_same_v<T, Object>) {
+      return caller_;
+    } else {
+      if (auto caller = dynamic_cast<T*>(caller_)) {
+        return caller;
+      }
+      PPU_THROW("cast failed");
     }
-    PPU_THROW("cast failed");
   }
 
   /// by caller
@@ -52,16 +65,18 @@ class KernelEvalContext final {
 
   template <typename T>
   void bindParam(const T& in) {
-    params_.emplace_back(in);
+    PPU_ENFORCE(num_params_ < kMaxParams, "too many params, max={}",
+                kMaxParams);
+    params_[num_params_++] = in;
   }
 
   /// by callee
-  size_t numParams() const { return params_.size(); }
+  size_t numParams() const { return num_params_; }
 
   template <typename T>
   const T& getParam(size_t pos) const {
-    PPU_ENFORCE(pos < params_.size(), "pos={} exceed num of inputs={}", pos,
-                params_.size());
+    PPU_ENFORCE(pos < num_params_, "pos={} exceed num of inputs={}", pos,
+                num_params_);
     return std::get<T>(params_[pos]);
   }
 
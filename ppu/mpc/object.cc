@@ -15,7 +15,17 @@
 
 #include "ppu/mpc/object.h"
 
+#include <atomic>
+
 namespace ppu::mpc {
+namespace detail {
+
+size_t nextTypeSlot() {
+  static std::atomic<size_t> counter{0};
+  return counter.fetch_add(1);
+}
+
+}  // namespace detail
 
 void Object::regKernel(std::string_view name, std::unique_ptr<Kernel> kernel) {
   const auto itr = kernels_.find(name);
@@ -34,4 +44,42 @@ bool Object::hasKernel(std::string_view name) const {
   return itr != kernels_.end();
 }
 
+CommCost Object::getCommCost() const {
+  CommCost total;
+  for (const auto& [name, state] : states_) {
+    const auto cost = state->getCommCost();
+    total.latency += cost.latency;
+    total.comm += cost.comm;
+    total.sent_bytes += cost.sent_bytes;
+    total.recv_wait += cost.recv_wait;
+  }
+  return total;
+}
+
+Object::ProfileMark Object::profileBegin() const {
+  return {getCommCost(), std::chrono::steady_clock::now()};
+}
+
+void Object::profileEnd(std::string_view name, const ProfileMark& mark) {
+  const auto end = std::chrono::steady_clock::now();
+  const auto cost = getCommCost();
+
+  auto itr = profiles_.find(name);
+  if (itr == profiles_.end()) {
+    itr = profiles_.emplace(std::string(name), KernelProfile{}).first;
+  }
+
+  auto& prof = itr->second;
+  const auto wall_time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - mark.time);
+  const auto recv_wait = cost.recv_wait - mark.cost.recv_wait;
+  prof.num_calls += 1;
+  prof.latency += cost.latency - mark.cost.latency;
+  prof.comm += cost.comm - mark.cost.comm;
+  prof.sent_bytes += cost.sent_bytes - mark.cost.sent_bytes;
+  prof.wall_time += wall_time;
+  prof.compute_time += wall_time > recv_wait ? wall_time - recv_wait
+                                             : std::chrono::nanoseconds(0);
+}
+
 }  // namespace ppu::mpc
@@ -15,10 +15,14 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ppu/mpc/kernel.h"
+#include "ppu/utils/timeline.h"
 
 namespace ppu::mpc {
 
@@ -31,9 +35,71 @@ class Interface {
   virtual ~Interface() = default;
 };
 
+// Accumulated communication cost.
+struct CommCost {
+  // Number of communication rounds.
+  size_t latency = 0;
+
+  // Number of bytes sent by collective algorithms.
+  size_t comm = 0;
+
+  // Number of bytes sent on the link, including point-to-point messages.
+  size_t sent_bytes = 0;
+
+  // Time blocked on receiving from peers.
+  std::chrono::nanoseconds recv_wait{0};
+};
+
 class State {
  public:
   virtual ~State() = default;
+
+  // Communication cost accumulated by this state, used by kernel profiling.
+  // States that do not communicate keep the default.
+  virtual CommCost getCommCost() const { return {}; }
+};
+
+// Measured cost of a kernel, accumulated over all of its calls.
+//
+// Numbers are inclusive, the cost of nested kernel calls is counted by the
+// caller too.
+struct KernelProfile {
+  size_t num_calls = 0;
+
+  size_t latency = 0;
+  size_t comm = 0;
+  size_t sent_bytes = 0;
+
+  std::chrono::nanoseconds wall_time{0};
+
+  // wall time minus the time blocked on receiving.
+  std::chrono::nanoseconds compute_time{0};
+};
+
+namespace detail {
+
+// Process-wide dense index of a C++ type, used to cache per-type lookups in
+// a vector instead of a map.
+size_t nextTypeSlot();
+
+template <typename T>
+size_t typeSlot() {
+  static const size_t slot = nextTypeSlot();
+  return slot;
+}
+
+}  // namespace detail
+
+// A kernel resolved by name, the lookup is done on the first call only.
+//
+// Handles are interned in interfaces, so after warm up a kernel call costs a
+// single virtual call, without name lookup nor allocation.
+class KernelHandle {
+  Kernel* kernel_ = nullptr;
+
+ public:
+  template <typename... Args>
+  ArrayRef call(Object* obj, std::string_view name, Args&&... args);
 };
 
 // A (kernel) dynamic object dispatch a function to a kernel at runtime.
@@ -41,9 +107,25 @@ class State {
 // Class that inherit from this class could do `dynamic binding`.
 class Object {
   std::map<std::string_view, std::unique_ptr<Kernel>> kernels_;
-  std::map<std::string_view, std::unique_ptr<Interface>> interfaces_;
   std::map<std::string_view, std::unique_ptr<State>> states_;
 
+  // indexed by detail::typeSlot, filled on first access.
+  std::vector<std::unique_ptr<Interface>> interface_cache_;
+  std::vector<State*> state_cache_;
+
+  std::shared_ptr<Timeline> timeline_;
+
+  bool profile_enabled_ = false;
+  std::map<std::string, KernelProfile, std::less<>> profiles_;
+
+  struct ProfileMark {
+    CommCost cost;
+    std::chrono::steady_clock::time_point time;
+  };
+
+  ProfileMark profileBegin() const;
+  void profileEnd(std::string_view name, const ProfileMark& mark);
+
  public:
   virtual ~Object() = default;
 
@@ -74,17 +156,44 @@ class Object {
              std::make_unique<StateT>(std::forward<Args>(args)...));
   }
 
+  template <typename StateT>
+  bool hasState() const {
+    return states_.find(StateT::kName) != states_.end();
+  }
+
   template <typename StateT>
   StateT* getState() {
+    const size_t slot = detail::typeSlot<StateT>();
+    if (slot < state_cache_.size() && state_cache_[slot] != nullptr) {
+      return static_cast<StateT*>(state_cache_[slot]);
+    }
+
     const auto& itr = states_.find(StateT::kName);
     PPU_ENFORCE(itr != states_.end(), "state={} not found", StateT::kName);
-    return dynamic_cast<StateT*>(itr->second.get());
+    auto* state = dynamic_cast<StateT*>(itr->second.get());
+    if (state != nullptr) {
+      // states are never removed, the cached pointer is stable.
+      if (slot >= state_cache_.size()) {
+        state_cache_.resize(slot + 1, nullptr);
+      }
+      state_cache_[slot] = state;
+    }
+    return state;
   }
 
+  // Interfaces are created once per object and owned by it.
   template <typename InterfaceT>
-  std::unique_ptr<InterfaceT> getInterface() {
+  InterfaceT* getInterface() {
     // TODO(jint) interface type restriction.
-    return std::make_unique<InterfaceT>(this);
+    const size_t slot = detail::typeSlot<InterfaceT>();
+    if (slot >= interface_cache_.size()) {
+      interface_cache_.resize(slot + 1);
+    }
+    auto& iface = interface_cache_[slot];
+    if (iface == nullptr) {
+      iface = std::make_unique<InterfaceT>(this);
+    }
+    return static_cast<InterfaceT*>(iface.get());
   }
 
   //
@@ -114,10 +223,52 @@ class Object {
 
   template <typename... Args>
   ArrayRef call(std::string_view name, Args&&... args) {
-    Kernel* kernel = getKernel(name);
+    return callKernel(getKernel(name), name, std::forward<Args>(args)...);
+  }
+
+  // Call a resolved kernel, `name` is used by timeline and profiling only.
+  template <typename... Args>
+  ArrayRef callKernel(Kernel* kernel, std::string_view name, Args&&... args) {
+    static_assert(sizeof...(Args) <= KernelEvalContext::kMaxParams,
+                  "too many kernel params");
     KernelEvalContext ctx(this);
-    return callImpl(kernel, &ctx, std::forward<Args>(args)...);
+    PPU_TIMELINE_SCOPE(timeline_.get(), "mpc", name);
+    if (!profile_enabled_) {
+      return callImpl(kernel, &ctx, std::forward<Args>(args)...);
+    }
+
+    const auto mark = profileBegin();
+    auto res = callImpl(kernel, &ctx, std::forward<Args>(args)...);
+    profileEnd(name, mark);
+    return res;
+  }
+
+  // Record kernel calls into the timeline, if it's enabled.
+  void setTimeline(std::shared_ptr<Timeline> timeline) {
+    timeline_ = std::move(timeline);
   }
+
+  // Kernel profiling, disabled by default.
+  void enableProfile(bool enable) { profile_enabled_ = enable; }
+  bool isProfileEnabled() const { return profile_enabled_; }
+
+  // Sum of the communication cost of all states.
+  CommCost getCommCost() const;
+
+  const std::map<std::string, KernelProfile, std::less<>>& getProfiles()
+      const {
+    return profiles_;
+  }
+  void resetProfiles() { profiles_.clear(); }
 };
 
+template <typename... Args>
+ArrayRef KernelHandle::call(Object* obj, std::string_view name,
+                            Args&&... args) {
+  if (kernel_ == nullptr) {
+    kernel_ = obj->getKernel(name);
+  }
+  return obj->callKernel(kernel_, name, std::forward<Args>(args)...);
+}
+
 }  // namespace ppu::mpc
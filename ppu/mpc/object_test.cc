@@ -0,0 +1,117 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/mpc/object.h"
+
+#include "gtest/gtest.h"
+
+#include "ppu/mpc/interfaces.h"
+
+namespace ppu::mpc {
+namespace {
+
+class CountState : public State {
+ public:
+  static constexpr char kName[] = "CountState";
+
+  size_t count = 0;
+};
+
+class OtherState : public State {
+ public:
+  static constexpr char kName[] = "OtherState";
+};
+
+// counts its calls and returns its first param.
+class CountedNeg : public UnaryKernel {
+ public:
+  static constexpr char kName[] = "NegP";
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in) const override {
+    ctx->caller()->getState<CountState>()->count++;
+    return in;
+  }
+};
+
+class SumParams : public Kernel {
+ public:
+  static constexpr char kName[] = "MatMulPP";
+
+  void evaluate(KernelEvalContext* ctx) const override {
+    EXPECT_EQ(ctx->numParams(), KernelEvalContext::kMaxParams);
+    ctx->caller()->getState<CountState>()->count +=
+        ctx->getParam<int64_t>(2) + ctx->getParam<int64_t>(3) +
+        ctx->getParam<int64_t>(4);
+    ctx->setOutput(ArrayRef(ctx->getParam<ArrayRef>(0)));
+  }
+};
+
+}  // namespace
+
+TEST(ObjectTest, InterfaceIsInterned) {
+  Object obj;
+  auto* compute = obj.getInterface<ICompute>();
+  EXPECT_EQ(compute, obj.getInterface<ICompute>());
+  EXPECT_NE(static_cast<Interface*>(compute),
+            static_cast<Interface*>(obj.getInterface<IRandom>()));
+
+  Object other;
+  EXPECT_NE(compute, other.getInterface<ICompute>());
+}
+
+TEST(ObjectTest, StateIsCached) {
+  Object obj;
+  EXPECT_THROW(obj.getState<CountState>(), EnforceNotMet);
+
+  obj.addState<CountState>();
+  obj.addState<OtherState>();
+  auto* state = obj.getState<CountState>();
+  ASSERT_NE(state, nullptr);
+  EXPECT_EQ(state, obj.getState<CountState>());
+  EXPECT_NE(static_cast<State*>(state),
+            static_cast<State*>(obj.getState<OtherState>()));
+
+  // the cache is per object.
+  Object other;
+  other.addState<CountState>();
+  EXPECT_NE(state, other.getState<CountState>());
+}
+
+TEST(ObjectTest, KernelHandle) {
+  Object obj;
+  obj.addState<CountState>();
+  obj.regKernel<CountedNeg>();
+  obj.regKernel<SumParams>();
+
+  auto* compute = obj.getInterface<ICompute>();
+  ArrayRef x(makePtType(PT_I32), 3);
+  for (size_t idx = 0; idx < 10; idx++) {
+    auto y = compute->NegP(x);
+    EXPECT_EQ(y.buf(), x.buf());
+  }
+  EXPECT_EQ(obj.getState<CountState>()->count, 10);
+
+  compute->MatMulPP(x, x, 1, 2, 3);
+  EXPECT_EQ(obj.getState<CountState>()->count, 16);
+
+  // call by name and by handle reach the same kernel.
+  obj.call("NegP", x);
+  EXPECT_EQ(obj.getState<CountState>()->count, 17);
+
+  // optional kernels fail on call, not on interface creation.
+  EXPECT_THROW(compute->OneHotS(x, 4), EnforceNotMet);
+}
+
+}  // namespace ppu::mpc
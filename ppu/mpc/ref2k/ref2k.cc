@@ -190,6 +190,22 @@ NdArrayRef Ref2kIo::reconstructSecret(
   return shares[0].as(makeType<RingTy>(field));
 }
 
+std::vector<size_t> Ref2kIo::splitsOf(size_t rank) const {
+  // the owner holds the correction, list its split first.
+  std::vector<size_t> indices = {rank};
+  for (size_t idx = 0; idx < world_size_; idx++) {
+    if (idx != rank) {
+      indices.push_back(idx);
+    }
+  }
+  return indices;
+}
+
+NdArrayRef Ref2kIo::makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                        FieldType field) const {
+  return sum(splits).as(makeType<Ref2kSecrTy>(field));
+}
+
 std::unique_ptr<Ref2kIo> makeRef2kIo(size_t npc) {
   return std::make_unique<Ref2kIo>(npc);
 }
@@ -30,6 +30,13 @@ class Ref2kIo final : public RingIo {
 
   NdArrayRef reconstructSecret(
       const std::vector<NdArrayRef>& shares) const override;
+
+ protected:
+  // the plaintext is the secret, every party depends on all splits.
+  std::vector<size_t> splitsOf(size_t rank) const override;
+
+  NdArrayRef makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                 FieldType field) const override;
 };
 
 std::unique_ptr<Object> makeRef2kProtocol(
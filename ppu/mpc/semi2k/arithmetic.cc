@@ -15,9 +15,12 @@
 
 #include "ppu/mpc/semi2k/arithmetic.h"
 
+#include <algorithm>
+
 #include "ppu/core/array_ref_util.h"
 #include "ppu/core/trace.h"
 #include "ppu/core/vectorize.h"
+#include "ppu/crypto/dpf/dpf.h"
 #include "ppu/mpc/interfaces.h"
 #include "ppu/mpc/prg_state.h"
 #include "ppu/mpc/semi2k/object.h"
@@ -26,6 +29,13 @@
 #include "ppu/mpc/util/ring_ops.h"
 
 namespace ppu::mpc::semi2k {
+namespace {
+
+// the number of dpf leaves expanded at a time by OneHotA, 16MB of 128-bit
+// values.
+constexpr int64_t kOneHotEvalBatch = int64_t(1) << 20;
+
+}  // namespace
 
 ArrayRef ZeroA::proc(KernelEvalContext* ctx, FieldType field,
                      size_t size) const {
@@ -202,4 +212,55 @@ ArrayRef TruncPrA::proc(KernelEvalContext* ctx, const ArrayRef& x,
   }
 }
 
+ArrayRef OneHotA::proc(KernelEvalContext* ctx, const ArrayRef& in,
+                       size_t num_classes) const {
+  PPU_TRACE_OP(this, in, num_classes);
+
+  const auto field = in.eltype().as<Ring2k>()->field();
+  auto* comm = ctx->caller()->getState<Communicator>();
+  auto* beaver = ctx->caller()->getState<Semi2kState>()->beaver();
+
+  PPU_ENFORCE(num_classes > 0);
+  size_t domain_bits = 1;
+  while ((size_t(1) << domain_bits) < num_classes) {
+    domain_bits++;
+  }
+
+  auto [r, keys] = beaver->DpfOneHot(field, in.numel(), domain_bits);
+
+  // (x - r) mod 2^d == x - (r mod 2^d), since 2^d divides the ring size.
+  auto delta = comm->allReduce(ReduceOp::ADD, ring_sub(in, r), kName);
+
+  crypto::DpfContext dpf(domain_bits, SizeOf(field) * 8);
+  const int64_t domain = int64_t(1) << domain_bits;
+  // the full domain of every key is expanded, so bound the keys evaluated at
+  // a time instead of materializing numel * 2^domain_bits 128-bit values.
+  const int64_t batch = std::max<int64_t>(1, kOneHotEvalBatch / domain);
+
+  ArrayRef out(makeType<AShrTy>(field), in.numel() * num_classes);
+  DISPATCH_ALL_FIELDS(field, kName, [&]() {
+    const auto& _delta = xt_adapt<ring2k_t>(delta);
+    auto _out = xt_mutable_adapt<ring2k_t>(out);
+    const size_t mask = domain - 1;
+
+    for (int64_t begin = 0; begin < in.numel(); begin += batch) {
+      const int64_t end = std::min(begin + batch, in.numel());
+      const auto e_r = dpf.BatchEvalAll(
+          absl::MakeConstSpan(keys).subspan(begin, end - begin));
+
+      for (int64_t idx = begin; idx < end; idx++) {
+        const auto* e = &e_r[(idx - begin) * domain];
+        const auto shift = static_cast<size_t>(_delta[idx]) & mask;
+        // e_x[j] = e_r[j - (x - r)]
+        for (size_t j = 0; j < num_classes; j++) {
+          _out[idx * num_classes + j] =
+              static_cast<ring2k_t>(e[(j - shift) & mask]);
+        }
+      }
+    }
+  });
+
+  return out;
+}
+
 }  // namespace ppu::mpc::semi2k
@@ -150,12 +150,9 @@ class MatMulAA : public MatmulKernel {
  public:
   static constexpr char kName[] = "MatMulAA";
 
-  util::CExpr latency() const override { return Const(1); }
-
-  util::CExpr comm() const override {
-    // TODO(jint) express M, N, K
-    return nullptr;
-  }
+  // The comm grows with the M*N output elements, which the per-element cost
+  // expressions can not capture.
+  Kind kind() const override { return Kind::kDynamic; }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& A, const ArrayRef& B,
                 int64_t M, int64_t N, int64_t K) const override;
@@ -176,4 +173,22 @@ class TruncPrA : public UnaryWithBitsKernel {
                 size_t bits) const override;
 };
 
+// One-hot encode each secret index x into a secret vector of length
+// num_classes with a dpf, 2PC only.
+//
+// The beaver deals dpf keys of e_r for a random r, parties open x - r, then
+// expand the keys with EvalAll and rotate the result by x - r. The online
+// cost is one opening, the rest is local prg expansion of the domain.
+class OneHotA : public UnaryWithBitsKernel {
+ public:
+  static constexpr char kName[] = "OneHotA";
+
+  util::CExpr latency() const override { return Const(1); }
+
+  util::CExpr comm() const override { return K(); }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& in,
+                size_t num_classes) const override;
+};
+
 }  // namespace ppu::mpc::semi2k
@@ -79,9 +79,9 @@ class AndBB : public BinaryKernel {
  public:
   static constexpr char kName[] = "AndBB";
 
-  util::CExpr latency() const override { return Const(0); }
+  util::CExpr latency() const override { return Const(1); }
 
-  util::CExpr comm() const override { return Const(0); }
+  util::CExpr comm() const override { return K() * 2 * (N() - 1); }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& lhs,
                 const ArrayRef& rhs) const override;
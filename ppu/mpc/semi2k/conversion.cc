@@ -15,6 +15,8 @@
 
 #include "ppu/mpc/semi2k/conversion.h"
 
+#include <algorithm>
+
 #include "xtensor/xarray.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xview.hpp"
@@ -37,24 +39,8 @@ ArrayRef AddBB::proc(KernelEvalContext* ctx, const ArrayRef& x,
   PPU_TRACE_OP(this, x, y);
   auto boolean = ctx->caller()->getInterface<IBoolean>();
 
-  CircuitBasicBlock<ArrayRef> cbb;
-  {
-    cbb.num_bits = x.elsize() * 8;
-    cbb._xor = [&](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
-      return boolean->XorBB(lhs, rhs);
-    };
-    cbb._and = [&](ArrayRef const& lhs, ArrayRef const& rhs) -> ArrayRef {
-      return boolean->AndBB(lhs, rhs);
-    };
-    cbb.lshift = [&](ArrayRef const& x, size_t bits) -> ArrayRef {
-      return boolean->LShiftB(x, bits);
-    };
-    cbb.rshift = [&](ArrayRef const& x, size_t bits) -> ArrayRef {
-      return boolean->RShiftB(x, bits);
-    };
-  }
-
-  return KoggleStoneAdder<ArrayRef>(x, y, cbb);
+  const auto field = x.eltype().as<Ring2k>()->field();
+  return KoggleStoneAdder<ArrayRef>(x, y, makeBooleanCbb(boolean, field));
 }
 
 ArrayRef A2B::proc(KernelEvalContext* ctx, const ArrayRef& x) const {
@@ -81,6 +67,37 @@ ArrayRef A2B::proc(KernelEvalContext* ctx, const ArrayRef& x) const {
   return res.as(makeType<BShrTy>(field));
 }
 
+ArrayRef MsbA::proc(KernelEvalContext* ctx, const ArrayRef& x) const {
+  PPU_TRACE_OP(this, x);
+
+  const auto field = x.eltype().as<Ring2k>()->field();
+  auto* comm = ctx->caller()->getState<Communicator>();
+  auto boolean = ctx->caller()->getInterface<IBoolean>();
+
+  std::vector<ArrayRef> bshrs;
+  const auto bty = makeType<BShrTy>(field);
+  for (size_t idx = 0; idx < comm->getWorldSize(); idx++) {
+    auto b = boolean->ZeroB(field, x.numel());
+    if (idx == comm->getRank()) {
+      ring_xor_(b, x);
+    }
+    bshrs.push_back(b.as(bty));
+  }
+
+  // x = m + n, where n is the sum of all other parties' pieces.
+  const ArrayRef& m = bshrs[0];
+  ArrayRef n = vectorizedReduce(bshrs.begin() + 1, bshrs.end(),
+                                [&](const ArrayRef& xx, const ArrayRef& yy) {
+                                  return boolean->AddBB(xx, yy);
+                                });
+
+  // msb(x) = msb(m) ^ msb(n) ^ carry
+  auto carry =
+      CarryOutCircuit<ArrayRef>(m, n, makeBooleanCbb(boolean, field));
+  auto msb = boolean->RShiftB(boolean->XorBB(m, n), SizeOf(field) * 8 - 1);
+  return boolean->XorBB(msb, carry).as(bty);
+}
+
 ArrayRef B2A::proc(KernelEvalContext* ctx, const ArrayRef& x) const {
   PPU_TRACE_OP(this, x);
 
@@ -162,4 +179,25 @@ ArrayRef B2A_Randbit::proc(KernelEvalContext* ctx, const ArrayRef& x) const {
   return res;
 }
 
+ArrayRef CastDownA::proc(KernelEvalContext* ctx, const ArrayRef& x,
+                         FieldType to_field) const {
+  PPU_TRACE_OP(this, x);
+
+  const auto field = x.eltype().as<Ring2k>()->field();
+  PPU_ENFORCE(SizeOf(to_field) <= SizeOf(field),
+              "can not cast arithmetic share from {} up to {}", field,
+              to_field);
+  return ring_cast(x, to_field).as(makeType<AShrTy>(to_field));
+}
+
+ArrayRef CastB::proc(KernelEvalContext* ctx, const ArrayRef& x,
+                     FieldType to_field) const {
+  PPU_TRACE_OP(this, x);
+
+  const size_t nbits = x.eltype().as<BShrTy>()->nbits();
+  return ring_cast(x, to_field)
+      .as(makeType<BShrTy>(to_field,
+                           std::min(nbits, SizeOf(to_field) * 8)));
+}
+
 }  // namespace ppu::mpc::semi2k
@@ -31,7 +31,11 @@ class AddBB : public BinaryKernel {
 
   util::CExpr latency() const override { return Log(K()) + 1; }
 
-  util::CExpr comm() const override { return Log(K()) * K(); }
+  util::CExpr comm() const override {
+    return (2 * Log(K()) + 1)     // KS-adder-circuit
+           * 2 * K() * (N() - 1)  // And gate, for nPC
+        ;
+  }
 
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x,
                 const ArrayRef& y) const override;
@@ -57,6 +61,31 @@ class A2B : public UnaryKernel {
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x) const override;
 };
 
+// Extract the msb of an arithmetic share, result a boolean share.
+//
+// The parties' pieces are boolean shared and summed with full adders until
+// two operands are left, then only the carry into the msb is computed with
+// CarryOutCircuit instead of another full KoggleStoneAdder.
+class MsbA : public UnaryKernel {
+ public:
+  static constexpr char kName[] = "MsbA";
+
+  util::CExpr latency() const override {
+    return (Log(K()) + 1) * Log(N() - 1)  // tree-reduce the other parties.
+           + Log(K()) + 1                 // carry-out circuit.
+        ;
+  }
+
+  util::CExpr comm() const override {
+    return ((2 * Log(K()) + 1) * (N() - 2)  // KS-adder-circuit
+            + Log(K()) + 1)                 // carry-out circuit
+           * 2 * K() * (N() - 1)            // And gate, for nPC
+        ;
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x) const override;
+};
+
 class B2A : public UnaryKernel {
  public:
   static constexpr char kName[] = "B2A";
@@ -82,4 +111,46 @@ class B2A_Randbit : public UnaryKernel {
   ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x) const override;
 };
 
+// Reduce an arithmetic share to a narrower ring locally.
+//
+// Each party reduces its piece mod 2^k', the pieces still sum to x mod 2^k',
+// so the msb is kept as long as x fits into k' bits.
+class CastDownA : public Kernel {
+ public:
+  static constexpr char kName[] = "CastDownA";
+
+  util::CExpr latency() const override { return Const(0); }
+
+  util::CExpr comm() const override { return Const(0); }
+
+  void evaluate(KernelEvalContext* ctx) const override {
+    ctx->setOutput(
+        proc(ctx, ctx->getParam<ArrayRef>(0), ctx->getParam<FieldType>(1)));
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x,
+                FieldType to_field) const;
+};
+
+// Convert a boolean share to another ring locally.
+//
+// XOR sharing is bitwise, truncating or zero-extending every piece gives a
+// sharing of the truncated or zero-extended value.
+class CastB : public Kernel {
+ public:
+  static constexpr char kName[] = "CastB";
+
+  util::CExpr latency() const override { return Const(0); }
+
+  util::CExpr comm() const override { return Const(0); }
+
+  void evaluate(KernelEvalContext* ctx) const override {
+    ctx->setOutput(
+        proc(ctx, ctx->getParam<ArrayRef>(0), ctx->getParam<FieldType>(1)));
+  }
+
+  ArrayRef proc(KernelEvalContext* ctx, const ArrayRef& x,
+                FieldType to_field) const;
+};
+
 }  // namespace ppu::mpc::semi2k
@@ -42,6 +42,12 @@ NdArrayRef Semi2kIo::reconstructSecret(
   return sum(encoded).as(makeType<RingTy>(field));
 }
 
+NdArrayRef Semi2kIo::makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                         FieldType field) const {
+  PPU_ENFORCE(splits.size() == 1, "expect 1 split, got={}", splits.size());
+  return splits[0].as(makeType<semi2k::AShrTy>(field));
+}
+
 std::unique_ptr<Semi2kIo> makeSemi2kIo(size_t npc) {
   registerTypes();
   return std::make_unique<Semi2kIo>(npc);
@@ -27,6 +27,10 @@ class Semi2kIo final : public RingIo {
 
   NdArrayRef reconstructSecret(
       const std::vector<NdArrayRef>& shares) const override;
+
+ protected:
+  NdArrayRef makeShareFromSplits(absl::Span<NdArrayRef const> splits,
+                                 FieldType field) const override;
 };
 
 std::unique_ptr<Semi2kIo> makeSemi2kIo(size_t npc);
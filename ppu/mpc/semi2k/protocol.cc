@@ -90,14 +90,21 @@ std::unique_ptr<Object> makeSemi2kProtocol(
   obj->regKernel<semi2k::MatMulAP>();
   obj->regKernel<semi2k::MatMulAA>();
   obj->regKernel<semi2k::TruncPrA>();
+  if (lctx->WorldSize() == 2) {
+    obj->regKernel<OneHotS>();
+    obj->regKernel<semi2k::OneHotA>();
+  }
 
   obj->regKernel<semi2k::ZeroB>();
   obj->regKernel<semi2k::B2P>();
   obj->regKernel<semi2k::P2B>();
   obj->regKernel<semi2k::AddBB>();
   obj->regKernel<semi2k::A2B>();
+  obj->regKernel<semi2k::MsbA>();
   // obj->regKernel<semi2k::B2A>();
   obj->regKernel<semi2k::B2A_Randbit>();
+  obj->regKernel<semi2k::CastDownA>();
+  obj->regKernel<semi2k::CastB>();
   obj->regKernel<semi2k::AndBP>();
   obj->regKernel<semi2k::AndBB>();
   obj->regKernel<semi2k::XorBP>();
@@ -34,35 +34,37 @@
 
 namespace ppu::mpc {
 
-internal::SingleComplexityReport dumpSemi2k() {
+internal::SingleComplexityReport dumpComplexity(ProtocolKind kind,
+                                                size_t npc) {
   internal::SingleComplexityReport single_report;
-  single_report.set_protocol("Semi2k");
-
-  // the interested kernel whitelist.
-  const std::vector<std::string> kWhitelist = {
-      "A2B", "B2A", "A2P", "B2P", "AddBB", "MatMulAA", "MatMulAP"};
+  single_report.set_protocol(ProtocolKind_Name(kind));
 
   // print header
+  fmt::print("{} ({}PC)\n", ProtocolKind_Name(kind), npc);
   fmt::print("{:<15}, {:<20}, {:<20}\n", "name", "latency", "comm");
 
-  util::simulate(2, [&](const std::shared_ptr<link::Context>& lctx) -> void {
-    auto prot = Factory::CreateCompute(ProtocolKind::SEMI2K, lctx);
+  util::simulate(npc, [&](const std::shared_ptr<link::Context>& lctx) -> void {
+    auto prot = Factory::CreateCompute(kind, lctx);
     if (lctx->Rank() != 0) {
       return;
     }
 
-    for (auto name : kWhitelist) {
+    for (auto name : prot->getKernelNames()) {
       auto* kernel = prot->getKernel(name);
-      auto latency = kernel->latency();
-      auto comm = kernel->comm();
 
-      const std::string latency_str = latency ? latency->expr() : "Unknown";
-      const std::string comm_str = comm ? comm->expr() : "Unknown";
+      std::string latency_str = "Dynamic";
+      std::string comm_str = "Dynamic";
+      if (kernel->kind() == Kernel::Kind::kStatic) {
+        auto latency = kernel->latency();
+        auto comm = kernel->comm();
+        latency_str = latency ? latency->expr() : "Unknown";
+        comm_str = comm ? comm->expr() : "Unknown";
+      }
 
       fmt::print("{:<15}, {:<20}, {:<20}\n", name, latency_str, comm_str);
 
       auto* entry = single_report.add_entries();
-      entry->set_kernel(name);
+      entry->set_kernel(std::string(name));
       entry->set_comm(comm_str);
       entry->set_latency(latency_str);
     }
@@ -87,7 +89,12 @@ int main(int argc, char** argv) {
 
   ppu::mpc::internal::ComplexityReport report;
 
-  *(report.add_reports()) = ppu::mpc::dumpSemi2k();
+  *(report.add_reports()) =
+      ppu::mpc::dumpComplexity(ppu::ProtocolKind::SEMI2K, 2);
+  *(report.add_reports()) =
+      ppu::mpc::dumpComplexity(ppu::ProtocolKind::ABY3, 3);
+  *(report.add_reports()) =
+      ppu::mpc::dumpComplexity(ppu::ProtocolKind::CHEETAH, 2);
 
   if (!OutputFilename.empty()) {
     std::string json;
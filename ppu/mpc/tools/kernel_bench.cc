@@ -0,0 +1,390 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/util/json_util.h"
+#include "llvm/Support/CommandLine.h"
+#include "spdlog/spdlog.h"
+
+#include "ppu/link/link.h"
+#include "ppu/mpc/factory.h"
+#include "ppu/mpc/interfaces.h"
+#include "ppu/mpc/object.h"
+#include "ppu/mpc/util/simulate.h"
+#include "ppu/utils/exception.h"
+
+#include "ppu/mpc/tools/kernel_bench.pb.h"
+#include "ppu/mpc/tools/kernel_bench_util.h"
+
+namespace ppu::mpc {
+namespace {
+
+// Prepares the operands of a kernel outside of the measured section, returns
+// the call to be measured.
+using BenchFn = std::function<void()>;
+using PrepareFn = std::function<BenchFn(Object*, FieldType, int64_t)>;
+
+constexpr size_t kShiftBits = 2;
+
+ArrayRef randP(Object* obj, FieldType field, int64_t size) {
+  return obj->getInterface<IRandom>()->RandP(field, size);
+}
+
+ArrayRef randS(Object* obj, FieldType field, int64_t size) {
+  return obj->getInterface<ICompute>()->P2S(randP(obj, field, size));
+}
+
+template <typename Fn>
+PrepareFn unaryS(Fn fn) {
+  return [fn](Object* obj, FieldType field, int64_t size) -> BenchFn {
+    auto* compute = obj->getInterface<ICompute>();
+    auto x = randS(obj, field, size);
+    return [=] { fn(compute, x); };
+  };
+}
+
+template <typename Fn>
+PrepareFn binarySP(Fn fn) {
+  return [fn](Object* obj, FieldType field, int64_t size) -> BenchFn {
+    auto* compute = obj->getInterface<ICompute>();
+    auto x = randS(obj, field, size);
+    auto y = randP(obj, field, size);
+    return [=] { fn(compute, x, y); };
+  };
+}
+
+template <typename Fn>
+PrepareFn binarySS(Fn fn) {
+  return [fn](Object* obj, FieldType field, int64_t size) -> BenchFn {
+    auto* compute = obj->getInterface<ICompute>();
+    auto x = randS(obj, field, size);
+    auto y = randS(obj, field, size);
+    return [=] { fn(compute, x, y); };
+  };
+}
+
+// Matmul runs a (n x n) * (n x n) product, where n^3 is close to the size.
+PrepareFn matmul(bool secret_rhs) {
+  return [=](Object* obj, FieldType field, int64_t size) -> BenchFn {
+    auto* compute = obj->getInterface<ICompute>();
+    const int64_t n = std::max<int64_t>(1, std::llround(std::cbrt(size)));
+    auto x = randS(obj, field, n * n);
+    auto y = secret_rhs ? randS(obj, field, n * n) : randP(obj, field, n * n);
+    if (secret_rhs) {
+      return [=] { compute->MatMulSS(x, y, n, n, n); };
+    }
+    return [=] { compute->MatMulSP(x, y, n, n, n); };
+  };
+}
+
+// Share conversion kernels, called by name since they are not part of
+// ICompute. B2A takes the A2B result as input.
+PrepareFn conversion(std::string_view name) {
+  return [=](Object* obj, FieldType field, int64_t size) -> BenchFn {
+    auto x = randS(obj, field, size);
+    if (name == "B2A") {
+      x = obj->call("A2B", x);
+    }
+    return [=] { obj->call(name, x); };
+  };
+}
+
+const std::vector<std::pair<std::string_view, PrepareFn>>& benchCases() {
+  using X = const ArrayRef&;
+  static const std::vector<std::pair<std::string_view, PrepareFn>> kCases = {
+      {"P2S",
+       [](Object* obj, FieldType field, int64_t size) -> BenchFn {
+         auto* compute = obj->getInterface<ICompute>();
+         auto x = randP(obj, field, size);
+         return [=] { compute->P2S(x); };
+       }},
+      {"S2P", unaryS([](ICompute* c, X x) { c->S2P(x); })},
+      {"NegS", unaryS([](ICompute* c, X x) { c->NegS(x); })},
+      {"EqzS", unaryS([](ICompute* c, X x) { c->EqzS(x); })},
+      {"LShiftS", unaryS([](ICompute* c, X x) { c->LShiftS(x, kShiftBits); })},
+      {"RShiftS", unaryS([](ICompute* c, X x) { c->RShiftS(x, kShiftBits); })},
+      {"ARShiftS",
+       unaryS([](ICompute* c, X x) { c->ARShiftS(x, kShiftBits); })},
+      {"TruncPrS",
+       unaryS([](ICompute* c, X x) { c->TruncPrS(x, kShiftBits); })},
+      {"ReverseBitsS",
+       unaryS([](ICompute* c, X x) { c->ReverseBitsS(x, 0, 8); })},
+      {"MsbS", unaryS([](ICompute* c, X x) { c->MsbS(x); })},
+      {"AddSP", binarySP([](ICompute* c, X x, X y) { c->AddSP(x, y); })},
+      {"AddSS", binarySS([](ICompute* c, X x, X y) { c->AddSS(x, y); })},
+      {"MulSP", binarySP([](ICompute* c, X x, X y) { c->MulSP(x, y); })},
+      {"MulSS", binarySS([](ICompute* c, X x, X y) { c->MulSS(x, y); })},
+      {"AndSP", binarySP([](ICompute* c, X x, X y) { c->AndSP(x, y); })},
+      {"AndSS", binarySS([](ICompute* c, X x, X y) { c->AndSS(x, y); })},
+      {"XorSP", binarySP([](ICompute* c, X x, X y) { c->XorSP(x, y); })},
+      {"XorSS", binarySS([](ICompute* c, X x, X y) { c->XorSS(x, y); })},
+      {"MatMulSP", matmul(/*secret_rhs*/ false)},
+      {"MatMulSS", matmul(/*secret_rhs*/ true)},
+      {"A2B", conversion("A2B")},
+      {"B2A", conversion("B2A")},
+  };
+  return kCases;
+}
+
+struct BenchOptions {
+  // kernels to run, empty means all.
+  std::vector<std::string> kernels;
+
+  std::vector<int64_t> sizes;
+
+  internal::KernelBenchConfig config;
+};
+
+template <typename... Args>
+void printRow(const Args&... args) {
+  fmt::print("{:<8}, {:<6}, {:<12}, {:>9}, {:>14}, {:>14}, {:>12}, {:>6}\n",
+             args...);
+}
+
+size_t numParties(ProtocolKind kind) {
+  return kind == ProtocolKind::ABY3 ? 3 : 2;
+}
+
+// Fields swept when none is given, cheetah only runs on FM64.
+std::vector<std::string> defaultFields(ProtocolKind kind) {
+  if (kind == ProtocolKind::CHEETAH) {
+    return {"FM64"};
+  }
+  return {"FM32", "FM64", "FM128"};
+}
+
+// The rounds and bytes are charged with the simulated latency and bandwidth,
+// the in-memory link itself is free.
+int64_t simulatedTimeNs(const internal::KernelBenchConfig& config,
+                        int64_t rounds, int64_t bytes) {
+  double ns = rounds * config.latency_ms() * 1e6;
+  if (config.bandwidth_mbps() > 0) {
+    ns += bytes * 8 / (config.bandwidth_mbps() * 1e6) * 1e9;
+  }
+  return static_cast<int64_t>(ns);
+}
+
+void runBench(ProtocolKind kind, FieldType field, const BenchOptions& opts,
+              internal::KernelBenchReport* report) {
+  const size_t npc = numParties(kind);
+  const int64_t repeats = std::max<int64_t>(1, opts.config.repeats());
+
+  util::simulate(npc, [&](const std::shared_ptr<link::Context>& lctx) -> void {
+    auto obj = Factory::CreateCompute(kind, lctx);
+
+    for (const auto& [name, prepare] : benchCases()) {
+      if (!opts.kernels.empty() &&
+          std::find(opts.kernels.begin(), opts.kernels.end(), name) ==
+              opts.kernels.end()) {
+        continue;
+      }
+      if (!obj->hasKernel(name)) {
+        continue;
+      }
+
+      for (const int64_t size : opts.sizes) {
+        auto fn = prepare(obj.get(), field, size);
+
+        int64_t time_ns = 0;
+        int64_t rounds = 0;
+        int64_t bytes = 0;
+        for (int64_t idx = 0; idx < repeats; idx++) {
+          // start together, so rank 0 does not measure peers' preparation.
+          link::Barrier(lctx, "kernel_bench");
+
+          const auto before = obj->getCommCost();
+          const auto start = std::chrono::steady_clock::now();
+          fn();
+          const auto end = std::chrono::steady_clock::now();
+          const auto after = obj->getCommCost();
+
+          time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         end - start)
+                         .count();
+          rounds += after.latency - before.latency;
+          bytes += after.sent_bytes - before.sent_bytes;
+        }
+
+        if (lctx->Rank() != 0) {
+          continue;
+        }
+
+        auto* entry = report->add_entries();
+        entry->set_protocol(ProtocolKind_Name(kind));
+        entry->set_npc(npc);
+        entry->set_field(FieldType_Name(field));
+        entry->set_kernel(std::string(name));
+        entry->set_size(size);
+        entry->set_time_ns(time_ns / repeats);
+        entry->set_rounds(rounds / repeats);
+        entry->set_bytes(bytes / repeats);
+        entry->set_sim_time_ns(
+            entry->time_ns() +
+            simulatedTimeNs(opts.config, entry->rounds(), entry->bytes()));
+
+        printRow(entry->protocol(), entry->field(), entry->kernel(),
+                 entry->size(), entry->time_ns(), entry->sim_time_ns(),
+                 entry->bytes(), entry->rounds());
+      }
+    }
+  });
+}
+
+}  // namespace
+}  // namespace ppu::mpc
+
+llvm::cl::list<std::string> Protocols(
+    "protocols", llvm::cl::desc("Comma separated protocols, default all"),
+    llvm::cl::CommaSeparated);
+
+llvm::cl::list<std::string> Fields(
+    "fields",
+    llvm::cl::desc("Comma separated fields, default all the protocol supports"),
+    llvm::cl::CommaSeparated);
+
+llvm::cl::list<std::string> Kernels(
+    "kernels", llvm::cl::desc("Comma separated kernels, default all"),
+    llvm::cl::CommaSeparated);
+
+llvm::cl::list<int64_t> Sizes(
+    "sizes",
+    llvm::cl::desc("Comma separated operand sizes, default 1,1000,1000000"),
+    llvm::cl::CommaSeparated);
+
+llvm::cl::opt<int64_t> Repeats("repeats",
+                               llvm::cl::desc("Measured calls per entry"),
+                               llvm::cl::init(3));
+
+llvm::cl::opt<double> LatencyMs(
+    "latency_ms", llvm::cl::desc("Simulated link latency per round"),
+    llvm::cl::init(0.0));
+
+llvm::cl::opt<double> BandwidthMbps(
+    "bandwidth_mbps",
+    llvm::cl::desc("Simulated link bandwidth, 0 means unlimited"),
+    llvm::cl::init(0.0));
+
+llvm::cl::opt<std::string> OutputFilename(
+    "out", llvm::cl::desc("Specify output json filename"),
+    llvm::cl::value_desc("filename"));
+
+llvm::cl::opt<std::string> BaselineFilename(
+    "baseline",
+    llvm::cl::desc("Previous json report, exits with 1 on regressions"),
+    llvm::cl::value_desc("filename"));
+
+llvm::cl::opt<double> Tolerance(
+    "tolerance",
+    llvm::cl::desc("Allowed relative time growth against the baseline"),
+    llvm::cl::init(0.1));
+
+int main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  // suppress all link logs.
+  spdlog::set_level(spdlog::level::off);
+
+  std::vector<std::string> protocols(Protocols.begin(), Protocols.end());
+  if (protocols.empty()) {
+    protocols = {"REF2K", "SEMI2K", "ABY3", "CHEETAH"};
+  }
+  ppu::mpc::BenchOptions opts;
+  opts.kernels.assign(Kernels.begin(), Kernels.end());
+  opts.sizes.assign(Sizes.begin(), Sizes.end());
+  if (opts.sizes.empty()) {
+    opts.sizes = {1, 1000, 1000000};
+  }
+  opts.config.set_latency_ms(LatencyMs);
+  opts.config.set_bandwidth_mbps(BandwidthMbps);
+  opts.config.set_repeats(Repeats);
+
+  ppu::mpc::internal::KernelBenchReport report;
+  *report.mutable_config() = opts.config;
+
+  ppu::mpc::printRow("protocol", "field", "kernel", "size", "time_ns",
+                     "sim_time_ns", "bytes", "rounds");
+  for (const auto& protocol : protocols) {
+    ppu::ProtocolKind kind;
+    PPU_ENFORCE(ppu::ProtocolKind_Parse(protocol, &kind),
+                "unknown protocol={}", protocol);
+    std::vector<std::string> fields(Fields.begin(), Fields.end());
+    if (fields.empty()) {
+      fields = ppu::mpc::defaultFields(kind);
+    }
+    for (const auto& field_str : fields) {
+      ppu::FieldType field;
+      PPU_ENFORCE(ppu::FieldType_Parse(field_str, &field), "unknown field={}",
+                  field_str);
+      // a failing combination is recorded, the rest of the sweep still runs.
+      try {
+        ppu::mpc::runBench(kind, field, opts, &report);
+      } catch (const std::exception& e) {
+        auto* failure = report.add_failures();
+        failure->set_protocol(protocol);
+        failure->set_field(field_str);
+        failure->set_error(e.what());
+        fmt::print("{:<8}, {:<6}, failed: {}\n", protocol, field_str,
+                   e.what());
+      }
+    }
+  }
+
+  google::protobuf::util::JsonPrintOptions json_options;
+  json_options.preserve_proto_field_names = true;
+
+  if (!OutputFilename.empty()) {
+    std::string json;
+    PPU_ENFORCE(
+        google::protobuf::util::MessageToJsonString(report, &json, json_options)
+            .ok());
+
+    std::ofstream out(OutputFilename.getValue());
+    out << json;
+  }
+
+  if (!BaselineFilename.empty()) {
+    std::ifstream in(BaselineFilename.getValue());
+    PPU_ENFORCE(in.good(), "can not open baseline={}",
+                BaselineFilename.getValue());
+    std::stringstream json;
+    json << in.rdbuf();
+
+    ppu::mpc::internal::KernelBenchReport baseline;
+    PPU_ENFORCE(
+        google::protobuf::util::JsonStringToMessage(json.str(), &baseline)
+            .ok(),
+        "invalid baseline={}", BaselineFilename.getValue());
+
+    const size_t num_regressions =
+        ppu::mpc::checkRegressions(baseline, report, Tolerance);
+    fmt::print("{} regressions against {}\n", num_regressions,
+               BaselineFilename.getValue());
+    if (num_regressions != 0) {
+      return 1;
+    }
+  }
+
+  return report.failures().empty() ? 0 : 1;
+}
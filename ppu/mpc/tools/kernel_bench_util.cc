@@ -0,0 +1,59 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/mpc/tools/kernel_bench_util.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "fmt/format.h"
+
+namespace ppu::mpc {
+
+size_t checkRegressions(const internal::KernelBenchReport& baseline,
+                        const internal::KernelBenchReport& report,
+                        double tolerance) {
+  using Key = std::tuple<std::string, std::string, std::string, int64_t>;
+  std::map<Key, const internal::KernelBenchEntry*> index;
+  for (const auto& entry : baseline.entries()) {
+    index[{entry.protocol(), entry.field(), entry.kernel(), entry.size()}] =
+        &entry;
+  }
+
+  size_t num_regressions = 0;
+  for (const auto& entry : report.entries()) {
+    auto itr = index.find(
+        {entry.protocol(), entry.field(), entry.kernel(), entry.size()});
+    if (itr == index.end()) {
+      continue;
+    }
+
+    const auto* base = itr->second;
+    if (entry.bytes() > base->bytes() || entry.rounds() > base->rounds() ||
+        entry.time_ns() > base->time_ns() * (1 + tolerance)) {
+      fmt::print(
+          "regression {}/{}/{}/{}: time {} -> {}, bytes {} -> {}, rounds {} "
+          "-> {}\n",
+          entry.protocol(), entry.field(), entry.kernel(), entry.size(),
+          base->time_ns(), entry.time_ns(), base->bytes(), entry.bytes(),
+          base->rounds(), entry.rounds());
+      num_regressions++;
+    }
+  }
+  return num_regressions;
+}
+
+}  // namespace ppu::mpc
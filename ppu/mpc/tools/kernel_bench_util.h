@@ -0,0 +1,31 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "ppu/mpc/tools/kernel_bench.pb.h"
+
+namespace ppu::mpc {
+
+// Compares a report with a previous one, returns the number of regressed
+// entries. Bytes and rounds are deterministic and must not grow, time may
+// grow by at most `tolerance`. Entries missing from the baseline are skipped.
+size_t checkRegressions(const internal::KernelBenchReport& baseline,
+                        const internal::KernelBenchReport& report,
+                        double tolerance);
+
+}  // namespace ppu::mpc
@@ -0,0 +1,84 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/mpc/tools/kernel_bench_util.h"
+
+#include "gtest/gtest.h"
+
+namespace ppu::mpc {
+namespace {
+
+internal::KernelBenchEntry* addEntry(internal::KernelBenchReport* report,
+                                     const std::string& kernel,
+                                     int64_t time_ns, int64_t bytes,
+                                     int64_t rounds) {
+  auto* entry = report->add_entries();
+  entry->set_protocol("SEMI2K");
+  entry->set_npc(2);
+  entry->set_field("FM64");
+  entry->set_kernel(kernel);
+  entry->set_size(1000);
+  entry->set_time_ns(time_ns);
+  entry->set_bytes(bytes);
+  entry->set_rounds(rounds);
+  return entry;
+}
+
+}  // namespace
+
+TEST(KernelBenchUtilTest, NoRegression) {
+  internal::KernelBenchReport baseline;
+  addEntry(&baseline, "MulSS", 1000, 32000, 1);
+  addEntry(&baseline, "MsbS", 5000, 64000, 8);
+
+  internal::KernelBenchReport report;
+  // time within the tolerance, bytes and rounds not grown.
+  addEntry(&report, "MulSS", 1099, 32000, 1);
+  addEntry(&report, "MsbS", 4000, 48000, 6);
+
+  EXPECT_EQ(checkRegressions(baseline, report, 0.1), 0u);
+}
+
+TEST(KernelBenchUtilTest, Regression) {
+  internal::KernelBenchReport baseline;
+  addEntry(&baseline, "MulSS", 1000, 32000, 1);
+  addEntry(&baseline, "MsbS", 5000, 64000, 8);
+  addEntry(&baseline, "A2B", 3000, 16000, 6);
+
+  internal::KernelBenchReport report;
+  // time beyond the tolerance.
+  addEntry(&report, "MulSS", 1101, 32000, 1);
+  // a single extra byte or round regresses whatever the tolerance.
+  addEntry(&report, "MsbS", 5000, 64001, 8);
+  addEntry(&report, "A2B", 3000, 16000, 7);
+
+  EXPECT_EQ(checkRegressions(baseline, report, 0.1), 3u);
+}
+
+TEST(KernelBenchUtilTest, MissingBaseline) {
+  internal::KernelBenchReport baseline;
+  addEntry(&baseline, "MulSS", 1000, 32000, 1);
+
+  internal::KernelBenchReport report;
+  addEntry(&report, "MulSS", 1000, 32000, 1);
+  // not in the baseline, skipped.
+  addEntry(&report, "MsbS", 5000, 64000, 8);
+  // same kernel with another size is another key.
+  addEntry(&report, "MulSS", 1000000, 32000000, 1)->set_size(1000000);
+
+  EXPECT_EQ(checkRegressions(baseline, report, 0.1), 0u);
+}
+
+}  // namespace ppu::mpc
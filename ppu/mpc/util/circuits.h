@@ -20,6 +20,7 @@
 #include "absl/numeric/bits.h"
 
 #include "ppu/core/vectorize.h"
+#include "ppu/utils/int128.h"
 
 namespace ppu::mpc {
 namespace details {
@@ -48,12 +49,16 @@ struct CircuitBasicBlock {
   // (logic) right shift
   using RShift = std::function<T(T const&, size_t)>;
 
+  // multi-bit and with a public constant. i.e. 0110 and 0011 -> 0010
+  using AndConst = std::function<T(T const&, uint128_t)>;
+
   size_t num_bits;
 
   Xor _xor;
   And _and;
   LShift lshift;
   RShift rshift;
+  AndConst and_const;
 };
 
 template <typename T>
@@ -65,6 +70,9 @@ CircuitBasicBlock<T> DefaultCircuitBasicBlock() {
     cbb._and = [](T const& lhs, T const& rhs) -> T { return lhs & rhs; };
     cbb.lshift = [](T const& x, size_t bits) -> T { return x << bits; };
     cbb.rshift = [](T const& x, size_t bits) -> T { return x >> bits; };
+    cbb.and_const = [](T const& x, uint128_t c) -> T {
+      return x & static_cast<T>(c);
+    };
     return cbb;
   } else {
     static_assert(details::dependent_false<T>::value,
@@ -132,4 +140,55 @@ T KoggleStoneAdder(
   return bb._xor(p, C);
 }
 
+/// Compute the carry into the most significant bit of lhs + rhs, so that
+///   msb(lhs + rhs) = msb(lhs) ^ msb(rhs) ^ carry
+///
+/// Only the carry out of the lower k-1 bits is required, so instead of the
+/// full Kogge-Stone prefix graph we only build the reduction tree (the
+/// up-sweep of Brent-Kung), and pack the two ANDs of each level into one.
+///
+/// Analysis:
+///  AND Gates: 1 + log(k) (KoggleStoneAdder uses 1 + 2 * log(k))
+///
+/// The carry bit is placed in the LSB, all other bits are zero.
+template <typename T>
+T CarryOutCircuit(
+    const T& lhs, const T& rhs,
+    const CircuitBasicBlock<T> bb = DefaultCircuitBasicBlock<T>()) {
+  // Generate p & g, and move them one bit up, so the msb is dropped and the
+  // lowest position holds an empty group (G=0), which makes exactly k leaves.
+  T G = bb.lshift(bb._and(lhs, rhs), 1);
+  T P = bb.lshift(bb._xor(lhs, rhs), 1);
+
+  // (G, P) of group [i, i + offset) is stored at position i. In each level we
+  // merge the low group [i, i + offset) and the high group [i + offset, i + 2
+  // * offset) for all i = 0 mod 2 * offset:
+  //  G = G_hi ^ (P_hi & G_lo)
+  //  P = P_hi & P_lo
+  //
+  // Position i + offset is unused after merging, so we can pack the two ANDs
+  // into one by placing (P_hi, G_lo) at position i and (P_hi, P_lo) at
+  // position i + offset.
+  for (size_t idx = 0; idx < absl::bit_width(bb.num_bits) - 1; ++idx) {
+    const size_t offset = 1UL << idx;
+
+    uint128_t mask = 0;
+    for (size_t pos = 0; pos < bb.num_bits; pos += 2 * offset) {
+      mask |= static_cast<uint128_t>(1) << pos;
+    }
+
+    T P_hi = bb.and_const(bb.rshift(P, offset), mask);
+    T G_lo = bb.and_const(G, mask);
+    T P_lo = bb.and_const(P, mask);
+
+    T Z = bb._and(bb._xor(P_hi, bb.lshift(P_hi, offset)),
+                  bb._xor(G_lo, bb.lshift(P_lo, offset)));
+
+    G = bb._xor(bb.rshift(G, offset), Z);
+    P = bb.rshift(Z, offset);
+  }
+
+  return bb.and_const(G, 1);
+}
+
 }  // namespace ppu::mpc
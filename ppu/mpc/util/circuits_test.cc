@@ -81,4 +81,29 @@ TEST(KoggleStoneAdder, Xtensor) {
   EXPECT_EQ(x + y, z);
 }
 
+TEST(CarryOutCircuit, Scalar) {
+  const std::vector<std::pair<uint64_t, uint64_t>> cases = {
+      {42, 17},
+      {0, 0},
+      {1ULL << 62, 1ULL << 62},
+      {~0ULL, 1},
+      {0x7fffffffffffffffULL, 1},
+      {0x7fffffffffffffffULL, 0x8000000000000000ULL},
+  };
+
+  for (const auto& [x, y] : cases) {
+    const uint64_t carry = ((x + y) ^ x ^ y) >> 63;
+    EXPECT_EQ(carry, CarryOutCircuit<uint64_t>(x, y));
+    EXPECT_EQ(carry, static_cast<uint64_t>(CarryOutCircuit<int64_t>(x, y)));
+  }
+
+  {
+    uint128_t x = static_cast<uint128_t>(1) << 126;
+    uint128_t y = static_cast<uint128_t>(1) << 126;
+
+    EXPECT_EQ(CarryOutCircuit<uint128_t>(x, y), 1);
+    EXPECT_EQ(CarryOutCircuit<uint128_t>(x, 42), 0);
+  }
+}
+
 }  // namespace ppu::mpc
@@ -15,15 +15,122 @@
 
 #include "ppu/mpc/util/communicator.h"
 
+#include <cstring>
+#include <functional>
+#include <future>
+
 #include "ppu/mpc/util/ring_ops.h"
 
 namespace ppu::mpc {
+namespace {
+
+constexpr int64_t kDefaultStripeMinBytes = 1024 * 1024;
+
+// Split [0, size) into n contiguous (offset, length) ranges.
+std::vector<std::pair<int64_t, int64_t>> stripeRanges(int64_t size,
+                                                      size_t n) {
+  const int64_t stripe = (size + n - 1) / n;
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (size_t idx = 0; idx < n; idx++) {
+    const int64_t begin = std::min<int64_t>(idx * stripe, size);
+    const int64_t end = std::min<int64_t>(begin + stripe, size);
+    ranges.emplace_back(begin, end - begin);
+  }
+  return ranges;
+}
+
+// Run fn(idx) for each stripe, stripe 0 on the calling thread and the others
+// on their own threads, since each of them blocks on the network.
+void forEachStripe(size_t n, const std::function<void(size_t)>& fn) {
+  std::vector<std::future<void>> futures;
+  for (size_t idx = 1; idx < n; idx++) {
+    futures.push_back(std::async(std::launch::async, fn, idx));
+  }
+  fn(0);
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace
+
+void Communicator::setStreams(size_t num_streams, size_t stripe_min_bytes) {
+  streams_.clear();
+  if (num_streams > 1) {
+    for (size_t idx = 0; idx < num_streams; idx++) {
+      streams_.push_back(lctx_->Spawn());
+    }
+  }
+  stripe_min_bytes_ = stripe_min_bytes == 0 ? kDefaultStripeMinBytes
+                                            : static_cast<int64_t>(
+                                                  stripe_min_bytes);
+}
+
+std::vector<Buffer> Communicator::allGather(const Buffer& in,
+                                            std::string_view tag) {
+  if (!shouldStripe(in.size())) {
+    return link::AllGather(lctx_, in, tag);
+  }
+
+  const auto ranges = stripeRanges(in.size(), streams_.size());
+  std::vector<std::vector<Buffer>> gathered(ranges.size());
+  forEachStripe(ranges.size(), [&](size_t idx) {
+    const auto& [offset, length] = ranges[idx];
+    gathered[idx] = link::AllGather(
+        streams_[idx], Buffer(in.data<char>() + offset, length), tag);
+  });
+
+  // reassemble each party's stripes in order.
+  std::vector<Buffer> ret;
+  for (size_t rank = 0; rank < getWorldSize(); rank++) {
+    Buffer buf(in.size());
+    for (size_t idx = 0; idx < ranges.size(); idx++) {
+      const auto& piece = gathered[idx][rank];
+      PPU_ENFORCE(piece.size() == ranges[idx].second);
+      std::memcpy(buf.data<char>() + ranges[idx].first, piece.data(),
+                  piece.size());
+    }
+    ret.push_back(std::move(buf));
+  }
+  return ret;
+}
+
+Buffer Communicator::rotateBuffer(const Buffer& in, std::string_view tag) {
+  if (!shouldStripe(in.size())) {
+    lctx_->SendAsync(lctx_->PrevRank(), in, tag);
+    return lctx_->Recv(lctx_->NextRank(), tag);
+  }
+
+  const auto ranges = stripeRanges(in.size(), streams_.size());
+  Buffer ret(in.size());
+  forEachStripe(ranges.size(), [&](size_t idx) {
+    const auto& [offset, length] = ranges[idx];
+    const auto& stream = streams_[idx];
+    stream->SendAsync(stream->PrevRank(),
+                      Buffer(in.data<char>() + offset, length), tag);
+    const auto piece = stream->Recv(stream->NextRank(), tag);
+    PPU_ENFORCE(piece.size() == length);
+    std::memcpy(ret.data<char>() + offset, piece.data(), piece.size());
+  });
+  return ret;
+}
+
+CommCost Communicator::getCommCost() const {
+  const auto link_stats = lctx_->GetStats();
+
+  CommCost cost;
+  cost.latency = stats_.latency;
+  cost.comm = stats_.comm;
+  cost.sent_bytes = link_stats->sent_bytes;
+  cost.recv_wait = std::chrono::nanoseconds(link_stats->recv_wait_ns);
+  return cost;
+}
 
 ArrayRef Communicator::allReduce(ReduceOp op, const ArrayRef& in,
                                  std::string_view tag) {
   const auto buf = in.getOrCreateCompactBuf();
 
-  std::vector<Buffer> all_str = link::AllGather(lctx_, *buf, tag);
+  std::vector<Buffer> all_str = allGather(*buf, tag);
 
   PPU_ENFORCE(all_str.size() == getWorldSize());
   ArrayRef res = in.clone();
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <numeric>
 #include <string>
 #include <type_traits>
@@ -112,12 +113,14 @@ class Communicator : public State {
   static constexpr char kName[] = "Communicator";
 
   struct Stats {
-    //
+    // Number of communication rounds.
     size_t latency = 0;
 
-    // Number of communication in bytes.
+    // Number of communication in bytes sent by this party.
     //
-    // For collective MPI algorithms only.
+    // For collective MPI algorithms only (allReduce/reduce/rotate),
+    // point-to-point messages sent via link::Context directly are not counted
+    // here, see `CommCost::sent_bytes`.
     // TODO(jint) add formal definition for asymmetric algorithms.
     size_t comm = 0;
 
@@ -133,8 +136,22 @@ class Communicator : public State {
   explicit Communicator(std::shared_ptr<link::Context> lctx)
       : lctx_(std::move(lctx)) {}
 
+  // Stripe allReduce/rotate payloads of at least `stripe_min_bytes` across
+  // `num_streams` spawned link sub-contexts, the stripes are sent in parallel
+  // and reassembled in order. All parties must use the same setting.
+  //
+  // @param num_streams, 0 or 1 means no striping.
+  // @param stripe_min_bytes, 0 means the default (1MB).
+  void setStreams(size_t num_streams, size_t stripe_min_bytes);
+
+  size_t getNumStreams() const {
+    return std::max<size_t>(streams_.size(), 1);
+  }
+
   Stats getStats() const { return stats_; }
 
+  CommCost getCommCost() const override;
+
   size_t getWorldSize() const { return lctx_->WorldSize(); }
 
   size_t getRank() const { return lctx_->Rank(); }
@@ -157,13 +174,28 @@ class Communicator : public State {
   // ArrayRef rotate(const ArrayRef& in, std::string_view tag);
   template <typename E, typename T = typename E::value_type>
   xt::xarray<T> rotate(const xt::xexpression<E>& in, std::string_view tag);
+
+ private:
+  // link::AllGather, striped if the payload is large enough.
+  std::vector<Buffer> allGather(const Buffer& in, std::string_view tag);
+
+  // Send to the previous rank and receive from the next rank, striped if the
+  // payload is large enough.
+  Buffer rotateBuffer(const Buffer& in, std::string_view tag);
+
+  bool shouldStripe(int64_t bytes) const {
+    return !streams_.empty() && bytes >= stripe_min_bytes_;
+  }
+
+  std::vector<std::shared_ptr<link::Context>> streams_;
+  int64_t stripe_min_bytes_ = 0;
 };
 
 template <typename E, typename T>
 xt::xarray<T> Communicator::allReduce(ReduceOp op, const xt::xexpression<E>& in,
                                       std::string_view tag) {
   const std::vector<Buffer> all_buf =
-      link::AllGather(lctx_, detail::SerializeXtensor(in), tag);
+      allGather(detail::SerializeXtensor(in), tag);
 
   const auto& in_x = in.derived_cast();
 
@@ -178,7 +210,8 @@ xt::xarray<T> Communicator::allReduce(ReduceOp op, const xt::xexpression<E>& in,
     }
   }
 
-  // TODO: count comm & latency
+  stats_.latency += 1;
+  stats_.comm += all_buf[getRank()].size() * (lctx_->WorldSize() - 1);
 
   return res;
 }
@@ -190,8 +223,8 @@ xt::xarray<T> Communicator::reduce(ReduceOp op, const xt::xexpression<E>& in,
 
   const auto& in_x = in.derived_cast();
 
-  const std::vector<Buffer> all_buf =
-      link::Gather(lctx_, detail::SerializeXtensor(in), root, tag);
+  const auto buf = detail::SerializeXtensor(in);
+  const std::vector<Buffer> all_buf = link::Gather(lctx_, buf, root, tag);
 
   xt::xarray<T> res = xt::zeros_like(in);
   for (const auto& buf : all_buf) {
@@ -204,7 +237,9 @@ xt::xarray<T> Communicator::reduce(ReduceOp op, const xt::xexpression<E>& in,
     }
   }
 
-  // TODO: count comm & latency
+  stats_.latency += 1;
+  stats_.comm += buf.size();
+
   return res;
 }
 
@@ -213,10 +248,14 @@ xt::xarray<T> Communicator::rotate(const xt::xexpression<E>& in,
                                    std::string_view tag) {
   const auto& in_x = in.derived_cast();
 
-  lctx_->SendAsync(lctx_->PrevRank(), detail::SerializeXtensor(in), tag);
+  const auto send_buf = detail::SerializeXtensor(in);
 
   // TODO(jint) drop this copy.
-  auto buf = lctx_->Recv(lctx_->NextRank(), tag);
+  auto buf = rotateBuffer(send_buf, tag);
+
+  stats_.latency += 1;
+  stats_.comm += send_buf.size();
+
   return detail::BuildXtensor<T>(in_x.shape(), buf);
 }
 
@@ -102,6 +102,41 @@ TEST_P(CommTest, Rotate) {
   });
 }
 
+TEST_P(CommTest, Striped) {
+  const Rank kWorldSize = std::get<0>(GetParam());
+  const FieldType kField = std::get<1>(GetParam());
+  // not a multiple of the stream count, the last stripe is shorter.
+  const std::vector<int64_t> kShape = {7, 13};
+
+  test::Eval(kWorldSize, [&](std::shared_ptr<link::Context> lctx) {
+    Communicator com(lctx);
+    com.setStreams(3, 16);
+    EXPECT_EQ(com.getNumStreams(), 3);
+
+    DISPATCH_ALL_FIELDS(kField, "CommTest.Striped", [&]() {
+      using tensor_t = xt::xarray<ring2k_t>;
+
+      // GIVEN
+      const tensor_t a = xt::arange<ring2k_t>(7 * 13).reshape(kShape) +
+                         static_cast<ring2k_t>(lctx->Rank());
+
+      // WHEN
+      tensor_t add_a = com.allReduce(ReduceOp::ADD, a, _kName);
+      tensor_t rotate_a = com.rotate(a, _kName);
+
+      // THEN
+      tensor_t expected = xt::zeros<ring2k_t>(kShape);
+      for (size_t rank = 0; rank < kWorldSize; rank++) {
+        expected += xt::arange<ring2k_t>(7 * 13).reshape(kShape) +
+                    static_cast<ring2k_t>(rank);
+      }
+      EXPECT_EQ(add_a, expected);
+      EXPECT_EQ(rotate_a, xt::arange<ring2k_t>(7 * 13).reshape(kShape) +
+                              static_cast<ring2k_t>(lctx->NextRank()));
+    });
+  });
+}
+
 INSTANTIATE_TEST_SUITE_P(
     CommTestInstances, CommTest,
     testing::Combine(testing::Values(4, 3, 2),
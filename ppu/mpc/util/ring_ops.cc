@@ -321,4 +321,25 @@ void ring_reverse_bits_(ArrayRef& x, size_t start, size_t end) {
   });
 }
 
+ArrayRef ring_cast(const ArrayRef& x, FieldType to_field) {
+  PPU_ENFORCE_RING(x);
+
+  const auto from_field = x.eltype().as<Ring2k>()->field();
+  ArrayRef res(makeType<RingTy>(to_field), x.numel());
+  DISPATCH_ALL_FIELDS(from_field, kName, [&]() {
+    using FromU = typename std::make_unsigned<ring2k_t>::type;
+    const auto x_xt = xt_adapt<ring2k_t>(x);
+
+    DISPATCH_ALL_FIELDS(to_field, kName, [&]() {
+      using ToU = typename std::make_unsigned<ring2k_t>::type;
+      auto res_xt = xt_mutable_adapt<ring2k_t>(res);
+      for (int64_t idx = 0; idx < x.numel(); idx++) {
+        const auto v = static_cast<FromU>(x_xt(idx));
+        res_xt(idx) = static_cast<ring2k_t>(static_cast<ToU>(v));
+      }
+    });
+  });
+  return res;
+}
+
 }  // namespace ppu::mpc
@@ -66,4 +66,8 @@ void ring_lshift_(ArrayRef& x, size_t bits);
 ArrayRef ring_reverse_bits(const ArrayRef& x, size_t start, size_t end);
 void ring_reverse_bits_(ArrayRef& x, size_t start, size_t end);
 
+// convert each element to another ring, the value is truncated when the
+// target ring is narrower and zero-extended when it is wider.
+ArrayRef ring_cast(const ArrayRef& x, FieldType to_field);
+
 }  // namespace ppu::mpc
@@ -0,0 +1,118 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/utils/timeline.h"
+
+#include <fstream>
+
+#include "fmt/format.h"
+
+#include "ppu/utils/exception.h"
+
+namespace ppu {
+namespace {
+
+std::string EscapeJson(std::string_view str) {
+  std::string res;
+  res.reserve(str.size());
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        res += "\\\"";
+        break;
+      case '\\':
+        res += "\\\\";
+        break;
+      case '\n':
+        res += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          res += fmt::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+          res += c;
+        }
+    }
+  }
+  return res;
+}
+
+int64_t ToMicros(std::chrono::system_clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             tp.time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+void Timeline::record(std::string_view category, std::string_view name,
+                      std::chrono::system_clock::time_point begin,
+                      std::chrono::system_clock::time_point end) {
+  if (!enabled()) {
+    return;
+  }
+
+  Event event;
+  event.name = std::string(name);
+  event.category = std::string(category);
+  event.begin_us = ToMicros(begin);
+  event.duration_us = ToMicros(end) - event.begin_us;
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  const auto itr =
+      tids_.emplace(std::this_thread::get_id(), tids_.size()).first;
+  event.tid = itr->second;
+  events_.emplace_back(std::move(event));
+}
+
+std::vector<Timeline::Event> Timeline::events() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return events_;
+}
+
+void Timeline::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  events_.clear();
+  tids_.clear();
+}
+
+std::string Timeline::toChromeTrace() const {
+  const auto all_events = events();
+
+  std::vector<std::string> items;
+  items.reserve(all_events.size() + 1);
+
+  // name the process after the party.
+  items.push_back(fmt::format(
+      R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"party {}"}}}})",
+      pid_, pid_));
+  for (const auto& event : all_events) {
+    items.push_back(fmt::format(
+        R"({{"name":"{}","cat":"{}","ph":"X","ts":{},"dur":{},"pid":{},"tid":{}}})",
+        EscapeJson(event.name), EscapeJson(event.category), event.begin_us,
+        event.duration_us, pid_, event.tid));
+  }
+
+  return fmt::format(R"({{"traceEvents":[{}],"displayTimeUnit":"ms"}})",
+                     fmt::join(items, ",\n"));
+}
+
+void Timeline::dumpChromeTrace(const std::filesystem::path& filename) const {
+  std::ofstream out(filename);
+  PPU_ENFORCE(out.good(), "open file={} failed", filename.string());
+  out << toChromeTrace();
+}
+
+}  // namespace ppu
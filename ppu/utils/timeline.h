@@ -0,0 +1,120 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ppu/utils/scope_guard.h"
+
+namespace ppu {
+
+// A thread-safe timeline event recorder.
+//
+// Events are complete events (begin, duration) of the chrome trace event
+// format, the dumped json could be loaded by `chrome://tracing` or
+// https://ui.perfetto.dev.
+//
+// Each party owns one timeline, the `pid` of the events is the party rank and
+// the `tid` is the recording thread, so the dumped files of all parties could
+// be loaded together to line up their timelines. Timestamps are taken from
+// the system clock for the same reason.
+//
+// Recording is disabled by default, a disabled timeline costs one relaxed
+// atomic load per scope.
+class Timeline {
+ public:
+  struct Event {
+    std::string name;
+    std::string category;
+    int64_t begin_us;
+    int64_t duration_us;
+    // index of the recording thread, in order of first appearance.
+    uint64_t tid;
+  };
+
+  explicit Timeline(size_t pid = 0) : pid_(pid) {}
+
+  void enable(bool enabled) { enabled_.store(enabled); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  size_t pid() const { return pid_; }
+
+  void record(std::string_view category, std::string_view name,
+              std::chrono::system_clock::time_point begin,
+              std::chrono::system_clock::time_point end);
+
+  std::vector<Event> events() const;
+  void clear();
+
+  // Dump as chrome trace json.
+  std::string toChromeTrace() const;
+  void dumpChromeTrace(const std::filesystem::path& filename) const;
+
+ private:
+  const size_t pid_;
+  std::atomic<bool> enabled_ = false;
+
+  mutable std::mutex mutex_;
+  std::vector<Event> events_;
+  std::map<std::thread::id, uint64_t> tids_;
+};
+
+// Record the lifetime of this scope into the timeline, does nothing if the
+// timeline is null or disabled.
+class TimelineScope {
+ public:
+  TimelineScope(Timeline* timeline, std::string_view category,
+                std::string_view name)
+      : timeline_(timeline != nullptr && timeline->enabled() ? timeline
+                                                             : nullptr) {
+    if (timeline_ != nullptr) {
+      category_ = category;
+      name_ = name;
+      begin_ = std::chrono::system_clock::now();
+    }
+  }
+
+  TimelineScope(const TimelineScope&) = delete;
+  TimelineScope& operator=(const TimelineScope&) = delete;
+
+  ~TimelineScope() {
+    if (timeline_ != nullptr) {
+      timeline_->record(category_, name_, begin_,
+                        std::chrono::system_clock::now());
+    }
+  }
+
+ private:
+  Timeline* timeline_;
+  std::string category_;
+  std::string name_;
+  std::chrono::system_clock::time_point begin_;
+};
+
+}  // namespace ppu
+
+#define PPU_TIMELINE_SCOPE(timeline, category, name)                \
+  ::ppu::TimelineScope SCOPEGUARD_LINENAME(TIMELINE, __LINE__)( \
+      timeline, category, name)
@@ -0,0 +1,64 @@
+// Copyright 2021 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ppu/utils/timeline.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace ppu {
+
+TEST(TimelineTest, DisabledByDefault) {
+  Timeline timeline;
+  { PPU_TIMELINE_SCOPE(&timeline, "test", "a"); }
+  { PPU_TIMELINE_SCOPE(nullptr, "test", "b"); }
+
+  EXPECT_TRUE(timeline.events().empty());
+}
+
+TEST(TimelineTest, Record) {
+  Timeline timeline(1);
+  timeline.enable(true);
+
+  {
+    PPU_TIMELINE_SCOPE(&timeline, "outer", "a");
+    PPU_TIMELINE_SCOPE(&timeline, "inner", "b");
+  }
+  std::thread([&] { PPU_TIMELINE_SCOPE(&timeline, "thread", "c\"d"); })
+      .join();
+
+  const auto events = timeline.events();
+  ASSERT_EQ(events.size(), 3);
+
+  // inner scope ends first.
+  EXPECT_EQ(events[0].name, "b");
+  EXPECT_EQ(events[0].category, "inner");
+  EXPECT_EQ(events[1].name, "a");
+  EXPECT_LE(events[1].begin_us, events[0].begin_us);
+  EXPECT_GE(events[1].duration_us, events[0].duration_us);
+  EXPECT_EQ(events[0].tid, events[1].tid);
+  EXPECT_NE(events[2].tid, events[0].tid);
+
+  const auto json = timeline.toChromeTrace();
+  EXPECT_NE(json.find(R"("traceEvents":[)"), std::string::npos);
+  EXPECT_NE(json.find(R"("name":"c\"d")"), std::string::npos);
+  EXPECT_NE(json.find(R"("pid":1)"), std::string::npos);
+
+  timeline.clear();
+  EXPECT_TRUE(timeline.events().empty());
+}
+
+}  // namespace ppu